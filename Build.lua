@@ -26,4 +26,6 @@ include "Vendor/imgui/Build-imgui.lua"
 
 include "MarchingCubesDemo/Build-MarchingCubesDemo.lua"
 
-include "VoxelCubesDemo/Build-VoxelCubesDemo.lua"
\ No newline at end of file
+include "VoxelCubesDemo/Build-VoxelCubesDemo.lua"
+
+include "CoreBench/Build-CoreBench.lua"
\ No newline at end of file
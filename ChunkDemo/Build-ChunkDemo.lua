@@ -6,7 +6,7 @@ project "ChunkDemo"
    staticruntime "off"
    systemversion "latest"
 
-   files { "Source/**.h", "Source/**.cpp", "Include/**.h", "Shaders/shader.frag", "Shaders/shader.vert", "**.h", "**.h"}
+   files { "Source/**.h", "Source/**.cpp", "Include/**.h", "Shaders/shader.frag", "Shaders/shader.vert", "Shaders/quadtree.vert", "Shaders/heightmap.vert", "**.h", "**.h"}
 
    includedirs
    {
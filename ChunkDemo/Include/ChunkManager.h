@@ -2,9 +2,12 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <memory>
 #include <glm.hpp>
 
 #include "Core/Core.h"
+#include "Core/ChunkJobs.h"
+#include "Core/ChunkStreamer.h"
 
 using ChunkCoord = glm::ivec2;
 
@@ -20,15 +23,13 @@ namespace std {
 class ChunkManager {
 public:
 
-	ChunkManager() {}
+	ChunkManager();
 
 	void DestroyChunks();
 
-	void Update(const glm::vec3& position);
+	void Update(const glm::vec3& position, const glm::mat4& viewProjection);
 
-	void GenerateChunk(const glm::vec3& position);
-
-	void UpdateSettings(float scale, float amplitude, float frequency, int octaves, float lacunarity, float persistance, int width, int height, int viewDistance) {
+	void UpdateSettings(float scale, float amplitude, float frequency, int octaves, float lacunarity, float persistance, int width, int height, int viewDistance, bool sharedGrid) {
 		_scale = scale;
 		_amplitude = amplitude;
 		_frequency = frequency;
@@ -38,15 +39,35 @@ public:
 		_width = width;
 		_height = height;
 		_viewDistance = viewDistance;
-
+		_sharedGrid = sharedGrid;
+		_streamer.Configure(StreamSettings());
 	}
 
+	// Drawable meshes with no CPU copy, erasing one gives its ranges back to the mesh arena
 	std::unordered_map<ChunkCoord, Core::PlaneMesh>& GetChunkMap() {
 		return _chunkMap;
 	}
 
+	// Filled instead of the chunk map when the chunks only keep their heights and are drawn with a shared grid
+	std::unordered_map<ChunkCoord, Core::HeightMapTexture>& GetTextureMap() {
+		return _textureMap;
+	}
+
+	bool UsesSharedGrid() const {
+		return _sharedGrid;
+	}
+
+	int GetWidth() const {
+		return _width;
+	}
+
+	int GetHeight() const {
+		return _height;
+	}
+
 private:
 	std::unordered_map<ChunkCoord, Core::PlaneMesh> _chunkMap;
+	std::unordered_map<ChunkCoord, Core::HeightMapTexture> _textureMap;
 
 	float _scale = 0.1f;
 	float _amplitude = 1.0f;
@@ -57,7 +78,11 @@ private:
 	int _width = 250;
 	int _height = 250;
 	int _viewDistance = 4;
+	bool _sharedGrid = false;
+	//Declared last so the worker threads stop before the chunk map and settings they use are destroyed
+	Core::ChunkStreamer _streamer;
 
-	void DeleteChunk(Core::PlaneMesh& mesh);
+	Core::ChunkStreamCallbacks StreamCallbacks();
+	Core::ChunkStreamSettings StreamSettings() const;
 
 };
\ No newline at end of file
@@ -16,13 +16,8 @@ public:
 	}
 private:
 	std::unordered_set<glm::ivec2> _activeChunkSet;
-	std::unordered_set<glm::ivec2> _previousFrameActiveChunkSet;
 	
 	int _width;
 	int _height;
 	int _viewDistance;
-
-	void SetupChunkRenderData(Core::PlaneMesh& mesh);
-
-	void CleanupChunkRenderData(Core::PlaneMesh& mesh);
 };
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include "Camera.h"
 #include "ChunkRenderer.h"
 #include "Core/Core.h"
+#include "Core/HeightMapQuadtree.h"
 
 using ChunkCoord = glm::ivec2;
 
@@ -44,6 +45,15 @@ public:
     const glm::vec3& GetCameraPosition() {
         return _camera.GetPosition();
     }
+
+    glm::mat4 GetViewProjection() const {
+        return _perspectiveMat * _view;
+    }
+
+    // The quadtree draws the terrain on its own, the chunks are not streamed meanwhile
+    bool UsesQuadtree() const {
+        return _useQuadtree;
+    }
     
 private:
     ChunkRenderer _chunkRenderer = ChunkRenderer(_width, _height, _viewDistance);
@@ -63,6 +73,26 @@ private:
     int _width = 250;
     int _height = 250;
     int _viewDistance = 4;
+    bool _useQuadtree = false;
+    bool _useSharedGrid = false;
+
+    Core::HeightMapQuadtree _quadtree;
+    Core::PlaneMesh _quadtreeGrid;
+    GLuint _quadtreeProgram;
+    GLint _quadtreeViewLoc;
+    GLint _nodeOriginLoc;
+    GLint _nodeSizeLoc;
+    GLint _morphRangeLoc;
+    GLint _cameraPosLoc;
+    int _quadtreeNodeCount = 0;
+
+    // Shared grid mode: one grid mesh for every chunk, which only keeps a height texture
+    Core::PlaneMesh _sharedGrid;
+    glm::ivec2 _sharedGridSize = glm::ivec2(0);
+    GLuint _sharedGridProgram;
+    GLint _sharedGridViewLoc;
+    GLint _chunkOriginLoc;
+    GLint _cellSizeLoc;
 
     int _screenWidth = 1280;
     int _screenHeight = 720;
@@ -85,6 +115,11 @@ private:
     GLuint CompileShader(GLenum type, const std::string& source);
     GLuint CreateShaderProgram(const std::string& vertexPath, const std::string& fragmentPath);
     void DrawChunks(ChunkManager& chunkManager);
+    void InitQuadtree();
+    void ConfigureQuadtree();
+    void DrawQuadtree();
+    void InitSharedGrid();
+    void DrawSharedGridChunks(ChunkManager& chunkManager);
     void ResetToStartValues();
     
 
@@ -0,0 +1,37 @@
+#version 430 core
+
+// One vertex of Core::CreateHeightMapGridMesh, in grid units
+layout(location = 0) in vec3 aGridPos;
+
+uniform mat4 projM;
+uniform mat4 uModel;
+uniform mat4 uView;
+uniform mat3 normalMatrix;
+
+// Core::HeightMapTexture of the chunk being drawn, with one sample of apron on every side
+uniform sampler2D uHeights;
+// World position of the chunk's first vertex and the size of one cell, the same placement as HeightMapVertexInit.comp
+uniform vec2 uChunkOrigin;
+uniform vec2 uCellSize;
+
+out vec3 FragPos;
+out vec3 Normal;
+
+float Height(ivec2 texel) {
+    return texelFetch(uHeights, texel, 0).r;
+}
+
+void main()
+{
+    ivec2 texel = ivec2(aGridPos.xz) + 1;
+    vec3 aPos = vec3(uChunkOrigin.x + aGridPos.x * uCellSize.x, Height(texel), uChunkOrigin.y + aGridPos.z * uCellSize.y);
+
+    // Central differences, the apron holds the neighbouring chunks' heights so the normals match across the border
+    float dx = Height(texel + ivec2(1, 0)) - Height(texel - ivec2(1, 0));
+    float dz = Height(texel + ivec2(0, 1)) - Height(texel - ivec2(0, 1));
+    vec3 aNormal = normalize(vec3(-dx / (2.0 * uCellSize.x), 1.0, -dz / (2.0 * uCellSize.y)));
+
+    FragPos = vec3(uModel * vec4(aPos, 1.0f));
+    Normal = normalMatrix * aNormal;
+    gl_Position = projM * uView * uModel * vec4(aPos, 1.0);
+}
@@ -0,0 +1,88 @@
+#version 430 core
+
+#define PI 3.1415
+
+// One cell of Core::CreateHeightMapGridMesh, in grid units
+layout(location = 0) in vec3 aGridPos;
+
+uniform mat4 projM;
+uniform mat4 uModel;
+uniform mat4 uView;
+uniform mat3 normalMatrix;
+
+// The Core::HeightMapNode being drawn and the morph range of its level
+uniform vec2 uNodeOrigin;
+uniform float uNodeSize;
+uniform float uGridResolution;
+uniform vec2 uMorphRange;
+uniform vec3 uCameraPos;
+
+// Same noise as HeightMapVertexDisplacement.comp
+uniform float scale;
+uniform float amplitude;
+uniform float frequency;
+uniform int octaves;
+uniform float persistance;
+uniform float lacunarity;
+
+out vec3 FragPos;
+out vec3 Normal;
+
+float rand(vec2 n) {
+    return fract(sin(dot(n, vec2(127.1, 311.7))) * 43758.5453123);
+}
+
+float noise(vec2 p, float freq) {
+    float unit = 1.0f / freq;
+    vec2 ij = floor(p / unit);
+    vec2 xy = fract(p / unit);
+    xy = 0.5f * (1.0f - cos(PI * xy));
+    float a = rand((ij + vec2(0.0f, 0.0f)));
+    float b = rand((ij + vec2(1.0f, 0.0f)));
+    float c = rand((ij + vec2(0.0f, 1.0f)));
+    float d = rand((ij + vec2(1.0f, 1.0f)));
+    float x1 = mix(a, b, xy.x);
+    float x2 = mix(c, d, xy.x);
+    return mix(x1, x2, xy.y);
+}
+
+float pNoise(vec2 p) {
+    float n = 0.0f;
+    float normK = 0.0f;
+    float f = frequency;
+    float amp = 1.0f;
+    for (int i = 0; i < octaves; i++) {
+        n += amp * noise(p, f);
+        f *= lacunarity;
+        normK += amp / amplitude;
+        amp *= persistance;
+    }
+    float nf = n / normK;
+    return nf * nf * nf * nf;
+}
+
+float TerrainHeight(vec2 xz) {
+    return 20 * pNoise(xz * scale);
+}
+
+void main()
+{
+    float cellSize = uNodeSize / uGridResolution;
+    vec2 xz = uNodeOrigin + aGridPos.xz * cellSize;
+
+    // Towards the end of its range every odd vertex slides onto its even neighbour, which is where the
+    // next coarser level has its vertex, so neighbouring levels meet without cracks
+    float distanceToCamera = distance(uCameraPos, vec3(xz.x, TerrainHeight(xz), xz.y));
+    float morph = clamp((distanceToCamera - uMorphRange.x) / (uMorphRange.y - uMorphRange.x), 0.0, 1.0);
+    xz -= fract(aGridPos.xz * 0.5) * 2.0 * cellSize * morph;
+
+    vec3 aPos = vec3(xz.x, TerrainHeight(xz), xz.y);
+    // Central differences over one cell of the node
+    float dx = TerrainHeight(xz + vec2(cellSize, 0.0)) - TerrainHeight(xz - vec2(cellSize, 0.0));
+    float dz = TerrainHeight(xz + vec2(0.0, cellSize)) - TerrainHeight(xz - vec2(0.0, cellSize));
+    vec3 aNormal = normalize(vec3(-dx, 2.0 * cellSize, -dz));
+
+    FragPos = vec3(uModel * vec4(aPos, 1.0f));
+    Normal = normalMatrix * aNormal;
+    gl_Position = projM * uView * uModel * vec4(aPos, 1.0);
+}
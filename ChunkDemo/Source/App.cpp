@@ -4,7 +4,9 @@ void App::Run() {
 	Core::Init();
 	while (!glfwWindowShouldClose(_renderer.GetWindow())) {
 		glm::vec3 pos = _renderer.GetCameraPosition(); // or pass shared
-		_chunkManager.Update(pos);
+		if (!_renderer.UsesQuadtree()) {
+			_chunkManager.Update(pos, _renderer.GetViewProjection());
+		}
 		_renderer.Render(_chunkManager);
 	}
 	Core::Cleanup();
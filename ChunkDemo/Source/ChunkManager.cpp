@@ -1,41 +1,68 @@
 #include "ChunkManager.h"
 
-void ChunkManager::Update(const glm::vec3& position) {
-	GenerateChunk(position);
+ChunkManager::ChunkManager() : _streamer(StreamCallbacks()) {
+	_streamer.Configure(StreamSettings());
 }
 
-void ChunkManager::GenerateChunk(const glm::vec3& position) {
-	float xScale = 100.0f / _width;
-	float zScale = 100.0f / _height;
-	glm::ivec2 playerChunk = glm::ivec2(std::floor(position.x / (_width * xScale)), std::floor(position.z / (_height * zScale)));  // based on player pos
-	int counter = 0;
-	for (int x = -_viewDistance; x <= _viewDistance; x++) {
-		for (int z = -_viewDistance; z <= _viewDistance; z++) {
-			if (glm::abs(x * z) > _viewDistance*_viewDistance/1.5f) continue;
-			glm::ivec2 coord = playerChunk + glm::ivec2(x, z);
+void ChunkManager::Update(const glm::vec3& position, const glm::mat4& viewProjection) {
+	_streamer.Update(position, viewProjection);
+}
 
-			// Generate if not yet stored
-			if (_chunkMap.find(coord) == _chunkMap.end()) {
-				_chunkMap[coord] = std::move(Core::CreateHeightMapPlaneMeshGPU(_width, _height, coord, _scale, _amplitude, _frequency, _octave, _persistance, _lacunarity, false));
-				//return;
-				//counter++;
-				if (counter > 2) {
-					return;
-				}
-			}
+Core::ChunkStreamCallbacks ChunkManager::StreamCallbacks() {
+	// The heightmap is a flat grid, the streamer coordinate (x, 0, z) is chunk (x, z)
+	Core::ChunkStreamCallbacks callbacks;
+	// The chunk type follows _sharedGrid, which only changes after DestroyChunks has dropped every chunk in flight
+	callbacks.schedule = [this](Core::JobSystem& jobs, glm::ivec3 coord) -> void* {
+		if (_sharedGrid) {
+			Core::HeightMapTextureChunkJob* chunk = new Core::HeightMapTextureChunkJob;
+			chunk->coord = glm::ivec2(coord.x, coord.z);
+			Core::ScheduleHeightMapTextureChunk(jobs, *chunk, _width, _height, _scale, _amplitude, _frequency, _octave, _persistance, _lacunarity);
+			return chunk;
+		}
+		// Meshes are generated on the GPU in ready, under the frame budget, so the job only takes a slot in the streamer
+		Core::HeightMapChunkJob* chunk = new Core::HeightMapChunkJob;
+		chunk->coord = glm::ivec2(coord.x, coord.z);
+		chunk->done = jobs.Schedule([] {}, {}, chunk);
+		return chunk;
+	};
+	callbacks.ready = [this](glm::ivec3 coord, void* data) {
+		if (_sharedGrid) {
+			// The texture is all the chunk keeps, so it goes to the GPU right away and the heights are freed
+			std::unique_ptr<Core::HeightMapTextureChunkJob> chunk(static_cast<Core::HeightMapTextureChunkJob*>(data));
+			Core::HeightMapTexture& heights = _textureMap[chunk->coord];
+			heights = std::move(chunk->heights);
+			Core::UploadHeightMapTexture(heights);
+			return;
 		}
-	}
+		// One dispatch straight into the mesh arena and no readback, the chunk keeps no CPU copy
+		std::unique_ptr<Core::HeightMapChunkJob> chunk(static_cast<Core::HeightMapChunkJob*>(data));
+		Core::CreateHeightMapChunk(_chunkMap[chunk->coord], _width, _height, chunk->coord, _scale, _amplitude, _frequency, _octave, _persistance, _lacunarity, Core::MeshTarget::Gpu);
+	};
+	callbacks.discard = [this](glm::ivec3 coord, void* data) {
+		if (_sharedGrid)
+			delete static_cast<Core::HeightMapTextureChunkJob*>(data);
+		else
+			delete static_cast<Core::HeightMapChunkJob*>(data);
+	};
+	callbacks.unload = [this](glm::ivec3 coord) {
+		_chunkMap.erase(glm::ivec2(coord.x, coord.z));
+		_textureMap.erase(glm::ivec2(coord.x, coord.z));
+	};
+	return callbacks;
 }
 
-void ChunkManager::DestroyChunks() {
-	for (auto& [coord, mesh] : _chunkMap) {
-		DeleteChunk(mesh);
-	}
-	_chunkMap.clear();
+Core::ChunkStreamSettings ChunkManager::StreamSettings() const {
+	// Every chunk covers 100x100 world units (see HeightMapVertexInit.comp), displaced heights stay below 20
+	Core::ChunkStreamSettings settings;
+	settings.chunkSize = glm::vec3(100.0f, 20.0f, 100.0f);
+	settings.flat = true;
+	settings.viewRadius = _viewDistance;
+	return settings;
 }
 
-void ChunkManager::DeleteChunk(Core::PlaneMesh& mesh) {
-	mesh.vertices.clear();
-	mesh.normals.clear();
-	mesh.indices.clear();
+void ChunkManager::DestroyChunks() {
+	// Chunks still in flight were generated with the old settings, they are dropped and every loaded chunk is unloaded
+	_streamer.Reset();
+	_chunkMap.clear();
+	_textureMap.clear();
 }
\ No newline at end of file
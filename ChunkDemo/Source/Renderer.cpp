@@ -1,4 +1,5 @@
 #include "Renderer.h"
+#include "Core/ProfilerPanel.h"
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
 	Camera* cam = static_cast<Camera*>(glfwGetWindowUserPointer(window));
@@ -83,6 +84,8 @@ Renderer::Renderer() {
 	glEnable(GL_CULL_FACE);
 	glCullFace(GL_BACK);
 	glEnable(GL_DEPTH_TEST);
+	InitQuadtree();
+	InitSharedGrid();
 	//Init();
 }
 
@@ -163,17 +166,141 @@ GLuint Renderer::CreateShaderProgram(const std::string& vertexPath, const std::s
 }
 
 void Renderer::DrawChunks(ChunkManager& chunkManager) {
+	if (chunkManager.UsesSharedGrid()) {
+		DrawSharedGridChunks(chunkManager);
+		return;
+	}
 	std::unordered_map<ChunkCoord, Core::PlaneMesh>& chunkMap = chunkManager.GetChunkMap();
 	_chunkRenderer.UpdateActiveChunk(GetCameraPosition(), chunkManager);
 	for (const glm::ivec2& coord : _chunkRenderer.GetActiveChunkSet()) {
 		Core::PlaneMesh& planeData = chunkMap[coord];
 		glUseProgram(_shaderProgram);
 		glBindVertexArray(planeData.vao);
-		glDrawElements(GL_TRIANGLES, planeData.indices.size(), GL_UNSIGNED_INT, 0);
+		glDrawElements(GL_TRIANGLES, planeData.indexCount, GL_UNSIGNED_INT, planeData.indexRange.Pointer());
 		glBindVertexArray(0);
 	}
 }
 
+void Renderer::InitQuadtree() {
+	_quadtreeProgram = CreateShaderProgram("Shaders/quadtree.vert", "Shaders/shader.frag");
+	glUseProgram(_quadtreeProgram);
+	glUniform1f(glGetUniformLocation(_quadtreeProgram, "Width"), _screenWidth);
+	glUniform1f(glGetUniformLocation(_quadtreeProgram, "Height"), _screenHeight);
+	glUniformMatrix4fv(glGetUniformLocation(_quadtreeProgram, "projM"), 1, GL_FALSE, glm::value_ptr(_perspectiveMat));
+	glUniformMatrix4fv(glGetUniformLocation(_quadtreeProgram, "uModel"), 1, GL_FALSE, glm::value_ptr(_model));
+	glUniformMatrix3fv(glGetUniformLocation(_quadtreeProgram, "normalMatrix"), 1, GL_FALSE, glm::value_ptr(_normalMatrix));
+	_quadtreeViewLoc = glGetUniformLocation(_quadtreeProgram, "uView");
+	_nodeOriginLoc = glGetUniformLocation(_quadtreeProgram, "uNodeOrigin");
+	_nodeSizeLoc = glGetUniformLocation(_quadtreeProgram, "uNodeSize");
+	_morphRangeLoc = glGetUniformLocation(_quadtreeProgram, "uMorphRange");
+	_cameraPosLoc = glGetUniformLocation(_quadtreeProgram, "uCameraPos");
+	glUseProgram(_shaderProgram);
+	ConfigureQuadtree();
+}
+
+void Renderer::ConfigureQuadtree() {
+	Core::HeightMapQuadtreeSettings settings;
+	// Five levels reach 960 units, just inside the far plane
+	settings.levels = 5;
+	settings.scale = _scale;
+	settings.amplitude = _amplitude;
+	settings.frequency = _frequency;
+	settings.octaves = _octave;
+	settings.persistance = _persistance;
+	settings.lacunarity = _lacunarity;
+	_quadtree.Configure(settings);
+
+	glUseProgram(_quadtreeProgram);
+	glUniform1f(glGetUniformLocation(_quadtreeProgram, "uGridResolution"), (float)_quadtree.GetSettings().gridResolution);
+	glUniform1f(glGetUniformLocation(_quadtreeProgram, "scale"), _scale);
+	glUniform1f(glGetUniformLocation(_quadtreeProgram, "amplitude"), _amplitude);
+	glUniform1f(glGetUniformLocation(_quadtreeProgram, "frequency"), _frequency);
+	glUniform1i(glGetUniformLocation(_quadtreeProgram, "octaves"), _octave);
+	glUniform1f(glGetUniformLocation(_quadtreeProgram, "persistance"), _persistance);
+	glUniform1f(glGetUniformLocation(_quadtreeProgram, "lacunarity"), _lacunarity);
+	glUseProgram(_shaderProgram);
+}
+
+void Renderer::DrawQuadtree() {
+	// Every node is drawn with the same grid, only its placement and morph range change
+	if (!_quadtreeGrid.gpuLoaded) {
+		int resolution = _quadtree.GetSettings().gridResolution;
+		_quadtreeGrid = Core::CreateHeightMapGridMesh(resolution, resolution);
+		Core::UploadPlaneMesh(_quadtreeGrid, false);
+	}
+
+	// Selection and morphing work in terrain space, before the model matrix
+	glm::vec3 camera = glm::vec3(glm::inverse(_model) * glm::vec4(GetCameraPosition(), 1.0f));
+	const std::vector<Core::HeightMapNode>& nodes = _quadtree.Select(camera, _perspectiveMat * _view * _model);
+	_quadtreeNodeCount = (int)nodes.size();
+
+	glUseProgram(_quadtreeProgram);
+	glUniformMatrix4fv(_quadtreeViewLoc, 1, GL_FALSE, glm::value_ptr(_view));
+	glUniform3fv(_cameraPosLoc, 1, glm::value_ptr(camera));
+	glBindVertexArray(_quadtreeGrid.vao);
+	GLsizei quadrantCount = _quadtree.GetQuadrantIndexCount();
+	for (const Core::HeightMapNode& node : nodes) {
+		glUniform2fv(_nodeOriginLoc, 1, glm::value_ptr(node.origin));
+		glUniform1f(_nodeSizeLoc, node.size);
+		glUniform2fv(_morphRangeLoc, 1, glm::value_ptr(_quadtree.GetMorphRange(node.level)));
+		if (node.quadrants == 0xF) {
+			glDrawElements(GL_TRIANGLES, quadrantCount * 4, GL_UNSIGNED_INT, _quadtreeGrid.indexRange.Pointer());
+			continue;
+		}
+		for (int quadrant = 0; quadrant < 4; quadrant++) {
+			if (node.quadrants & (1 << quadrant))
+				glDrawElements(GL_TRIANGLES, quadrantCount, GL_UNSIGNED_INT, _quadtreeGrid.indexRange.Pointer(quadrant * quadrantCount * sizeof(int)));
+		}
+	}
+	glBindVertexArray(0);
+	glUseProgram(_shaderProgram);
+}
+
+void Renderer::InitSharedGrid() {
+	_sharedGridProgram = CreateShaderProgram("Shaders/heightmap.vert", "Shaders/shader.frag");
+	glUseProgram(_sharedGridProgram);
+	glUniform1f(glGetUniformLocation(_sharedGridProgram, "Width"), _screenWidth);
+	glUniform1f(glGetUniformLocation(_sharedGridProgram, "Height"), _screenHeight);
+	glUniformMatrix4fv(glGetUniformLocation(_sharedGridProgram, "projM"), 1, GL_FALSE, glm::value_ptr(_perspectiveMat));
+	glUniformMatrix4fv(glGetUniformLocation(_sharedGridProgram, "uModel"), 1, GL_FALSE, glm::value_ptr(_model));
+	glUniformMatrix3fv(glGetUniformLocation(_sharedGridProgram, "normalMatrix"), 1, GL_FALSE, glm::value_ptr(_normalMatrix));
+	glUniform1i(glGetUniformLocation(_sharedGridProgram, "uHeights"), 0);
+	_sharedGridViewLoc = glGetUniformLocation(_sharedGridProgram, "uView");
+	_chunkOriginLoc = glGetUniformLocation(_sharedGridProgram, "uChunkOrigin");
+	_cellSizeLoc = glGetUniformLocation(_sharedGridProgram, "uCellSize");
+	glUseProgram(_shaderProgram);
+}
+
+void Renderer::DrawSharedGridChunks(ChunkManager& chunkManager) {
+	// The grid is rebuilt only when the chunk resolution changes, the chunks themselves hold no vertices or indices
+	glm::ivec2 size(chunkManager.GetWidth(), chunkManager.GetHeight());
+	if (!_sharedGrid.gpuLoaded || _sharedGridSize != size) {
+		Core::ReleasePlaneMesh(_sharedGrid);
+		_sharedGrid = Core::CreateHeightMapGridMesh(size.x, size.y);
+		Core::UploadPlaneMesh(_sharedGrid, false);
+		_sharedGridSize = size;
+	}
+
+	std::unordered_map<ChunkCoord, Core::HeightMapTexture>& textureMap = chunkManager.GetTextureMap();
+	_chunkRenderer.UpdateActiveChunk(GetCameraPosition(), chunkManager);
+	// Every chunk covers 100x100 world units like in HeightMapVertexInit.comp
+	glm::vec2 cellSize(100.0f / size.x, 100.0f / size.y);
+	glUseProgram(_sharedGridProgram);
+	glUniformMatrix4fv(_sharedGridViewLoc, 1, GL_FALSE, glm::value_ptr(_view));
+	glUniform2fv(_cellSizeLoc, 1, glm::value_ptr(cellSize));
+	glBindVertexArray(_sharedGrid.vao);
+	glActiveTexture(GL_TEXTURE0);
+	for (const glm::ivec2& coord : _chunkRenderer.GetActiveChunkSet()) {
+		glm::vec2 origin = glm::vec2(coord) * 100.0f;
+		glUniform2fv(_chunkOriginLoc, 1, glm::value_ptr(origin));
+		glBindTexture(GL_TEXTURE_2D, textureMap[coord].texture);
+		glDrawElements(GL_TRIANGLES, _sharedGrid.indexCount, GL_UNSIGNED_INT, _sharedGrid.indexRange.Pointer());
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindVertexArray(0);
+	glUseProgram(_shaderProgram);
+}
+
 void Renderer::ResetToStartValues() {
 	_scale = 0.1f;
 	_amplitude = 1.0f;
@@ -214,10 +341,20 @@ void Renderer::Render(ChunkManager& chunkManager) {
 	ImGui::SliderFloat("Persistance", &_persistance, 0.1f, 4.0f);
 	ImGui::SliderFloat("Lacunarity", &_lacunarity, 0.1f, 4.0f);
 	ImGui::SliderInt("ViewDistance", &_viewDistance, 0, 5);
+	ImGui::Checkbox("CDLOD Quadtree", &_useQuadtree);
+	// Switching needs chunks of the other kind, so the chunks are regenerated right away
+	if (ImGui::Checkbox("Shared Grid", &_useSharedGrid)) {
+		chunkManager.DestroyChunks();
+		chunkManager.UpdateSettings(_scale, _amplitude, _frequency, _octave, _lacunarity, _persistance, _width, _height, _viewDistance, _useSharedGrid);
+	}
+	if (_useQuadtree) {
+		ImGui::Text("Quadtree nodes: %d", _quadtreeNodeCount);
+	}
 
 	if (ImGui::Button("Regenerate Mesh")) {
 		chunkManager.DestroyChunks();
-		chunkManager.UpdateSettings(_scale, _amplitude, _frequency, _octave, _lacunarity, _persistance, _width, _height, _viewDistance);
+		chunkManager.UpdateSettings(_scale, _amplitude, _frequency, _octave, _lacunarity, _persistance, _width, _height, _viewDistance, _useSharedGrid);
+		ConfigureQuadtree();
 	}
 	if (ImGui::Button("Reset Settings")) {
 		ResetToStartValues();
@@ -225,6 +362,7 @@ void Renderer::Render(ChunkManager& chunkManager) {
 	ImGui::Text("WASD to move  |  Space to ascend and ctrl to descend");
 
 	ImGui::End();
+	Core::ShowProfilerPanel();
 
 	ImGui::Render();
 
@@ -234,7 +372,12 @@ void Renderer::Render(ChunkManager& chunkManager) {
 	glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	DrawChunks(chunkManager);
+	if (_useQuadtree) {
+		DrawQuadtree();
+	}
+	else {
+		DrawChunks(chunkManager);
+	}
 
 	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
@@ -243,7 +386,12 @@ void Renderer::Render(ChunkManager& chunkManager) {
 
 void Renderer::Cleanup(ChunkManager& chunkManager) {
 	chunkManager.DestroyChunks();
+	Core::ReleasePlaneMesh(_quadtreeGrid);
+	Core::ReleasePlaneMesh(_sharedGrid);
+	Core::DestroyBufferArenas();
 	glDeleteProgram(_shaderProgram);
+	glDeleteProgram(_quadtreeProgram);
+	glDeleteProgram(_sharedGridProgram);
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
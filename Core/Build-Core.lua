@@ -5,7 +5,7 @@ project "Core"
    targetdir "Binaries/%{cfg.buildcfg}"
    staticruntime "off"
 
-   files { "Source/**.h", "Source/**.cpp" , "Source/**.comp"}
+   files { "Source/**.h", "Source/**.cpp", "Source/**.inl", "Source/**.comp"}
 
    includedirs
    {
@@ -25,6 +25,22 @@ project "Core"
        systemversion "latest"
        defines { }
 
+   -- The SIMD noise kernels are the only files built with wider instruction sets; SimdNoise.cpp picks one at runtime
+   filter { "system:not windows", "files:Source/Core/SimdNoiseSSE4.cpp" }
+       buildoptions { "-msse4.1", "-ffp-contract=off" }
+
+   filter { "system:not windows", "files:Source/Core/SimdNoiseAVX2.cpp" }
+       buildoptions { "-mavx2", "-ffp-contract=off" }
+
+   filter { "system:not windows", "files:Source/Core/SimdNoiseAVX512.cpp" }
+       buildoptions { "-mavx512f", "-ffp-contract=off" }
+
+   filter { "system:windows", "files:Source/Core/SimdNoiseAVX2.cpp" }
+       buildoptions { "/arch:AVX2" }
+
+   filter { "system:windows", "files:Source/Core/SimdNoiseAVX512.cpp" }
+       buildoptions { "/arch:AVX512" }
+
    filter "configurations:Debug"
        defines { "DEBUG" }
        runtime "Debug"
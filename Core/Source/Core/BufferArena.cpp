@@ -0,0 +1,224 @@
+#include "BufferArena.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Core {
+	namespace {
+		SharedFence PlaceFence() {
+			return SharedFence(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), [](GLsync fence) { glDeleteSync(fence); });
+		}
+	}
+
+	BufferArena::BufferArena(GLsizeiptr pageSize, GLbitfield access) : _pageSize(pageSize), _access(access) {}
+
+	BufferRange BufferArena::Allocate(GLsizeiptr size) {
+		size = AlignSize(size);
+
+		Reclaim();
+		BufferRange range;
+		if (!TryAllocate(size, range)) {
+			AddPage(std::max(_pageSize, size));
+			TryAllocate(size, range);
+		}
+		_usedBytes += range.size;
+		return range;
+	}
+
+	void BufferArena::Allocate(GLsizeiptr size, BufferRange* ranges, int count) {
+		if (count <= 0) return;
+		size = AlignSize(size);
+		//The free list does not remember allocations, so handing out slices of one range lets each be released separately
+		BufferRange all = Allocate(size * count);
+		for (int i = 0; i < count; i++) {
+			ranges[i] = all;
+			ranges[i].offset = all.offset + i * size;
+			ranges[i].size = size;
+		}
+	}
+
+	void BufferArena::Release(BufferRange& range) {
+		if (!range) return;
+		Release(range, PlaceFence());
+	}
+
+	void BufferArena::Release(BufferRange& range, const SharedFence& fence) {
+		if (!range) return;
+		_usedBytes -= range.size;
+		_retired.push_back({ range, fence });
+		range = BufferRange();
+	}
+
+	void BufferArena::Write(const BufferRange& range, const void* data, GLsizeiptr size, GLintptr offset) {
+		Page* page = FindPage(range.buffer);
+		if (page == nullptr || size <= 0) return;
+		if (page->mapped && (_access & GL_MAP_WRITE_BIT)) {
+			std::memcpy(page->mapped + range.offset + offset, data, size);
+		}
+		else {
+			glBindBuffer(GL_COPY_WRITE_BUFFER, range.buffer);
+			glBufferSubData(GL_COPY_WRITE_BUFFER, range.offset + offset, size, data);
+		}
+	}
+
+	void BufferArena::Read(const BufferRange& range, void* data, GLsizeiptr size, GLintptr offset) {
+		Page* page = FindPage(range.buffer);
+		if (page == nullptr || size <= 0) return;
+		if (page->mapped && (_access & GL_MAP_READ_BIT)) {
+			std::memcpy(data, page->mapped + range.offset + offset, size);
+		}
+		else {
+			glBindBuffer(GL_COPY_READ_BUFFER, range.buffer);
+			glGetBufferSubData(GL_COPY_READ_BUFFER, range.offset + offset, size, data);
+		}
+	}
+
+	void BufferArena::Destroy() {
+		for (Page& page : _pages) {
+			glDeleteBuffers(1, &page.buffer);
+		}
+		_retired.clear();
+		_pages.clear();
+		_usedBytes = 0;
+	}
+
+	GLsizeiptr BufferArena::GetCapacity() const {
+		GLsizeiptr capacity = 0;
+		for (const Page& page : _pages) {
+			capacity += page.size;
+		}
+		return capacity;
+	}
+
+	GLsizeiptr BufferArena::AlignSize(GLsizeiptr size) {
+		if (_alignment == 0) {
+			GLint alignment = 0;
+			glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+			//At least 16 so vec4 data and both index types stay aligned
+			_alignment = std::max<GLsizeiptr>(alignment, 16);
+		}
+		//Offsets and sizes are all multiples of the alignment, so every free range stays aligned as well
+		return (std::max<GLsizeiptr>(size, 1) + _alignment - 1) / _alignment * _alignment;
+	}
+
+	void BufferArena::AddPage(GLsizeiptr size) {
+		Page page;
+		page.size = size;
+		glGenBuffers(1, &page.buffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, page.buffer);
+		if (GLAD_GL_VERSION_4_4) {
+			GLbitfield mapFlags = _access != 0 ? _access | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT : 0;
+			glBufferStorage(GL_COPY_WRITE_BUFFER, size, nullptr, mapFlags | GL_DYNAMIC_STORAGE_BIT);
+			if (mapFlags != 0) {
+				page.mapped = (char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, size, mapFlags);
+			}
+		}
+		else {
+			GLenum usage = (_access & GL_MAP_READ_BIT) ? GL_STREAM_READ : (_access & GL_MAP_WRITE_BIT) ? GL_DYNAMIC_DRAW : GL_DYNAMIC_COPY;
+			glBufferData(GL_COPY_WRITE_BUFFER, size, nullptr, usage);
+		}
+		page.freeRanges[0] = size;
+		_pages.push_back(std::move(page));
+	}
+
+	BufferArena::Page* BufferArena::FindPage(GLuint buffer) {
+		for (Page& page : _pages) {
+			if (page.buffer == buffer) return &page;
+		}
+		return nullptr;
+	}
+
+	bool BufferArena::TryAllocate(GLsizeiptr size, BufferRange& range) {
+		Page* bestPage = nullptr;
+		std::map<GLintptr, GLsizeiptr>::iterator best;
+		for (Page& page : _pages) {
+			for (auto it = page.freeRanges.begin(); it != page.freeRanges.end(); it++) {
+				if (it->second >= size && (bestPage == nullptr || it->second < best->second)) {
+					bestPage = &page;
+					best = it;
+				}
+			}
+		}
+		if (bestPage == nullptr) return false;
+
+		range.arena = this;
+		range.buffer = bestPage->buffer;
+		range.offset = best->first;
+		range.size = size;
+		GLsizeiptr rest = best->second - size;
+		bestPage->freeRanges.erase(best);
+		if (rest > 0) {
+			bestPage->freeRanges[range.offset + size] = rest;
+		}
+		return true;
+	}
+
+	void BufferArena::Free(const BufferRange& range) {
+		Page* page = FindPage(range.buffer);
+		if (page == nullptr) return;
+
+		GLintptr offset = range.offset;
+		GLsizeiptr size = range.size;
+		auto next = page->freeRanges.lower_bound(offset);
+		if (next != page->freeRanges.begin()) {
+			auto previous = std::prev(next);
+			if (previous->first + previous->second == offset) {
+				offset = previous->first;
+				size += previous->second;
+				page->freeRanges.erase(previous);
+			}
+		}
+		if (next != page->freeRanges.end() && offset + size == next->first) {
+			size += next->second;
+			page->freeRanges.erase(next);
+		}
+		page->freeRanges[offset] = size;
+	}
+
+	void BufferArena::Reclaim() {
+		//Fences signal in the order they were placed, so stop at the first one that has not
+		size_t done = 0;
+		for (; done < _retired.size(); done++) {
+			GLenum status = glClientWaitSync(_retired[done].fence.get(), 0, 0);
+			if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) break;
+			Free(_retired[done].range);
+		}
+		_retired.erase(_retired.begin(), _retired.begin() + done);
+	}
+
+	BufferArena& GetMeshArena() {
+		static BufferArena arena(64 << 20, GL_MAP_WRITE_BIT);
+		return arena;
+	}
+
+	BufferArena& GetScratchArena() {
+		static BufferArena arena(32 << 20, 0);
+		return arena;
+	}
+
+	BufferArena& GetReadbackArena() {
+		static BufferArena arena(32 << 20, GL_MAP_READ_BIT);
+		return arena;
+	}
+
+	void DestroyBufferArenas() {
+		GetMeshArena().Destroy();
+		GetScratchArena().Destroy();
+		GetReadbackArena().Destroy();
+	}
+
+	void ReleaseRange(BufferRange& range) {
+		if (range.arena != nullptr) {
+			range.arena->Release(range);
+		}
+	}
+
+	void ReleaseRanges(std::initializer_list<BufferRange*> ranges) {
+		SharedFence fence;
+		for (BufferRange* range : ranges) {
+			if (range->arena == nullptr || !*range) continue;
+			if (!fence) fence = PlaceFence();
+			range->arena->Release(*range, fence);
+		}
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <glad/glad.h>
+
+#include <initializer_list>
+#include <map>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Core {
+	class BufferArena;
+	//A fence shared by every range released together, deleted with the last of them
+	using SharedFence = std::shared_ptr<std::remove_pointer_t<GLsync>>;
+
+	//A byte range in one page of a BufferArena. Copies refer to the same memory, so only one of them may be released.
+	struct BufferRange {
+		BufferArena* arena = nullptr;
+		GLuint buffer = 0;
+		GLintptr offset = 0;
+		GLsizeiptr size = 0;
+
+		explicit operator bool() const { return buffer != 0; }
+		//The offset as the pointer argument of glVertexAttribPointer, glDrawElements and the indirect draws
+		const void* Pointer(GLintptr extra = 0) const { return (const void*)(offset + extra); }
+	};
+
+	//Suballocates chunk buffers out of a few large GL buffers (pages), so streaming chunks in and out does no glGenBuffers or glBufferData.
+	//Each page keeps its free space as ranges sorted by offset: allocation takes the best fit over all pages and releasing merges a range
+	//with its free neighbours. A released range is only handed out again once a fence placed at release has passed, since draws and
+	//dispatches issued before may still use it. Pages are persistently mapped when glBufferStorage is available (GL 4.4), so Write and Read
+	//are plain copies; on GL 4.3 they fall back to glBufferSubData and glGetBufferSubData. Only use it on the thread that owns the GL context.
+	class BufferArena {
+	public:
+		//access is GL_MAP_WRITE_BIT for data the CPU uploads, GL_MAP_READ_BIT for data it reads back, or 0 for memory only the GPU touches
+		BufferArena(GLsizeiptr pageSize, GLbitfield access);
+		BufferArena(const BufferArena&) = delete;
+		BufferArena& operator=(const BufferArena&) = delete;
+
+		//Aligned to GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, so every range can also be bound with glBindBufferRange
+		BufferRange Allocate(GLsizeiptr size);
+		//count ranges of the same size back to back in one page, so a single binding from the first to the last covers all of them.
+		//Each one is released on its own.
+		void Allocate(GLsizeiptr size, BufferRange* ranges, int count);
+		//Gives the range back once the GPU is done with it and clears it
+		void Release(BufferRange& range);
+		//Same, waiting on a fence already placed for other ranges released at the same time
+		void Release(BufferRange& range, const SharedFence& fence);
+		void Write(const BufferRange& range, const void* data, GLsizeiptr size, GLintptr offset = 0);
+		//Waits for the GPU when the page is not mapped, check a fence first to avoid the stall
+		void Read(const BufferRange& range, void* data, GLsizeiptr size, GLintptr offset = 0);
+		//Deletes every page, ranges still handed out become invalid
+		void Destroy();
+
+		GLsizeiptr GetUsedBytes() const { return _usedBytes; }
+		GLsizeiptr GetCapacity() const;
+
+	private:
+		struct Page {
+			GLuint buffer = 0;
+			GLsizeiptr size = 0;
+			char* mapped = nullptr;
+			std::map<GLintptr, GLsizeiptr> freeRanges; //offset -> size
+		};
+		struct RetiredRange {
+			BufferRange range;
+			SharedFence fence;
+		};
+
+		GLsizeiptr _pageSize;
+		GLbitfield _access;
+		GLsizeiptr _alignment = 0;
+		GLsizeiptr _usedBytes = 0;
+		std::vector<Page> _pages;
+		std::vector<RetiredRange> _retired;
+
+		GLsizeiptr AlignSize(GLsizeiptr size);
+		void AddPage(GLsizeiptr size);
+		Page* FindPage(GLuint buffer);
+		bool TryAllocate(GLsizeiptr size, BufferRange& range);
+		void Free(const BufferRange& range);
+		//Frees the retired ranges whose fence has passed, without waiting for the others
+		void Reclaim();
+	};
+
+	//Core wide arenas, the first page is made on the first Allocate. Mesh holds what gets drawn, scratch the intermediate stages of GPU
+	//generation and readback the results that come back to the CPU.
+	BufferArena& GetMeshArena();
+	BufferArena& GetScratchArena();
+	BufferArena& GetReadbackArena();
+	//Deletes the pages of all three, call it once every mesh is released and before the GL context goes away. Core::Cleanup leaves
+	//them alone since the CleanUp paths call it between generations.
+	void DestroyBufferArenas();
+
+	//Releases the range into the arena it came from, does nothing for an empty range
+	void ReleaseRange(BufferRange& range);
+	//Releases ranges that are done with at the same time, from any of the arenas, behind a single fence
+	void ReleaseRanges(std::initializer_list<BufferRange*> ranges);
+
+	inline void BindStorageRange(GLuint binding, const BufferRange& range) {
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, range.buffer, range.offset, range.size);
+	}
+
+	//Binds first up to the end of last, for ranges that came from one Allocate call
+	inline void BindStorageRanges(GLuint binding, const BufferRange& first, const BufferRange& last) {
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, binding, first.buffer, first.offset, last.offset + last.size - first.offset);
+	}
+}
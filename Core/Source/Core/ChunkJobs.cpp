@@ -0,0 +1,157 @@
+#include "ChunkJobs.h"
+#include "CpuBackend.h"
+
+namespace Core {
+	void ScheduleHeightMapChunk(JobSystem& jobs, HeightMapChunkJob& chunk, int width, int height, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity) {
+		HeightMapChunkJob* c = &chunk;
+		JobHandle indices = jobs.Schedule([c, width, height] {
+			ProfileScope scope(ProfileStage::HeightMapIndices);
+			Cpu::CreateIndices(c->mesh, width, height);
+		});
+		JobHandle vertices = jobs.Schedule([c, width, height] {
+			ProfileScope scope(ProfileStage::HeightMapVertices);
+			Cpu::CreateVertices(c->mesh, width, height, c->coord);
+		});
+		JobHandle displaced = jobs.Schedule([=] {
+			ProfileScope scope(ProfileStage::HeightMapDisplace);
+			Cpu::DisplaceVertices(c->mesh, width, height, scale, amplitude, frequency, octaves, persistance, lacunarity);
+		}, { vertices });
+		chunk.done = jobs.Schedule([c, width, height] {
+			ProfileScope scope(ProfileStage::HeightMapNormals);
+			Cpu::InterpolatedNormals(c->mesh, width, height);
+		}, { displaced, indices }, c);
+	}
+
+	void ScheduleHeightMapTextureChunk(JobSystem& jobs, HeightMapTextureChunkJob& chunk, int width, int height, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity) {
+		HeightMapTextureChunkJob* c = &chunk;
+		chunk.done = jobs.Schedule([=] {
+			CreateHeightMapTexture(c->heights, width, height, c->coord, scale, amplitude, frequency, octaves, persistance, lacunarity);
+		}, {}, c);
+	}
+
+	void ScheduleVoxelCubesChunk(JobSystem& jobs, VoxelCubesChunkJob& chunk, int width, int height, int depth, float frequency, bool greedy, RegionStore* regions) {
+		//Padded by one voxel on each side like CreateVoxelCubes3DMesh
+		int paddedWidth = width + 2;
+		int paddedHeight = height + 2;
+		int paddedDepth = depth + 2;
+		glm::vec3 offset = glm::vec3(chunk.coord.x * width, 0, chunk.coord.y * depth);
+		glm::ivec3 regionCoord = glm::ivec3(chunk.coord.x, 0, chunk.coord.y);
+		VoxelCubesChunkJob* c = &chunk;
+
+		auto density = [=] {
+			ProfileScope scope(ProfileStage::VoxelSpline);
+			Spline spline = CreateVoxelCubesSpline();
+			Cpu::CreateFlat3DNoiseMapPipeLine(c->blockIDs, spline, paddedWidth, paddedHeight, paddedDepth, offset, frequency, true);
+		};
+		auto paint = [=] {
+			ProfileScope scope(ProfileStage::VoxelPaint);
+			Cpu::TerrainPaint(c->blockIDs, paddedWidth, paddedHeight, paddedDepth);
+		};
+		auto mesh = [=] {
+			ProfileScope scope(ProfileStage::VoxelMesh);
+			if (greedy) {
+				int quadCount = Cpu::VoxelCubesQuadCount(paddedWidth, paddedHeight, paddedDepth, c->blockIDs);
+				Cpu::VoxelCubesGreedyGeometryInit(c->mesh, paddedWidth, paddedHeight, paddedDepth, offset, c->blockIDs, quadCount);
+			}
+			else {
+				Cpu::VoxelCubesBinaryGeometryInit(c->mesh, paddedWidth, paddedHeight, paddedDepth, offset, c->blockIDs, 3, 16);
+			}
+			c->packedIDs.Encode(c->blockIDs);
+			c->blockIDs = BlockIds();
+			if (regions) {
+				RegionChunk saved;
+				saved.blockIDs = c->packedIDs;
+				saved.mesh = c->mesh;
+				regions->Save(regionCoord, saved);
+			}
+		};
+
+		if (regions && regions->Contains(regionCoord)) {
+			//A damaged record falls back to generating the chunk in the same job
+			chunk.done = jobs.Schedule([=] {
+				RegionChunk saved;
+				if (regions->Load(regionCoord, saved)) {
+					c->packedIDs = std::move(saved.blockIDs);
+					c->mesh = std::move(saved.mesh);
+					return;
+				}
+				density();
+				paint();
+				mesh();
+			}, {}, c);
+			return;
+		}
+
+		JobHandle densityJob = jobs.Schedule(density);
+		JobHandle paintJob = jobs.Schedule(paint, { densityJob });
+		chunk.done = jobs.Schedule(mesh, { paintJob }, c);
+	}
+
+	void ScheduleMarchingCubesChunk(JobSystem& jobs, MarchingCubesChunkJob& chunk, int width, int height, int depth, float frequency, bool indexed, DensityStore* store, MarchingCubesLod lod) {
+		//Coarser chunks cover the same box with a lattice of a larger stride. Sampling the noise at (origin + i) * frequency * stride gives
+		//the same densities as the full resolution lattice at every stride-th point.
+		int stride = lod.Stride();
+		int paddedWidth = width / stride + 1;
+		int paddedHeight = height / stride + 1;
+		int paddedDepth = depth / stride + 1;
+		glm::ivec3 paddedSize = glm::ivec3(paddedWidth, paddedHeight, paddedDepth);
+		glm::vec3 offset = glm::vec3(chunk.coord) * glm::vec3(width, height, depth);
+		glm::vec3 latticeOffset = offset / (float)stride;
+		float latticeFrequency = (store ? store->GetFrequency() : frequency) * stride;
+		//The store only keeps the full resolution lattice
+		bool fromStore = store && lod.level == 0;
+		chunk.lod = lod;
+		MarchingCubesChunkJob* c = &chunk;
+
+		JobHandle density = jobs.Schedule([=] {
+			c->occupancy = ClassifyMarchingCubesChunk(paddedWidth, paddedHeight, paddedDepth, latticeOffset, latticeFrequency);
+			if (c->occupancy != ChunkOccupancy::Mixed) return;
+			c->mesh = new VoxelMesh;
+			ProfileScope scope(ProfileStage::Noise);
+			if (fromStore) {
+				glm::ivec3 origin, size;
+				MarchingCubesChunkBox(c->coord, width, height, depth, origin, size);
+				c->densities.resize(size.x * size.y * size.z);
+				store->Acquire(origin, size, c->densities.data());
+			}
+			else {
+				Cpu::CreateFlat3DNoiseMap(c->densities, paddedWidth, paddedHeight, paddedDepth, latticeOffset, latticeFrequency);
+			}
+			StitchMarchingCubesDensities(c->densities, paddedSize, latticeOffset, latticeFrequency, lod, 0.0f);
+		});
+		JobHandle culling = jobs.Schedule([=] {
+			if (c->occupancy != ChunkOccupancy::Mixed) return;
+			ProfileScope scope(ProfileStage::SurfaceCulling);
+			Cpu::PerformSurfaceCulling(c->densities, c->activeVoxels, paddedWidth, paddedHeight, paddedDepth, 0.0f);
+		}, { density });
+		chunk.done = jobs.Schedule([=] {
+			if (c->occupancy != ChunkOccupancy::Mixed) return;
+			int size;
+			{
+				ProfileScope scope(ProfileStage::TriangleCount);
+				size = Cpu::CountMarchingCubesTriangleCount(c->densities, c->activeVoxels, paddedWidth, paddedHeight, 0.0f);
+			}
+			ProfileScope scope(ProfileStage::MarchingCubesMesh);
+			//Meshed relative to the chunk in lattice units, the border snapping works on those
+			if (indexed) {
+				c->mesh->cpuMesh.indices.reserve(size / 3);
+				Cpu::CreateMarchingCubesIndexed(c->mesh->cpuMesh, c->densities, c->activeVoxels, paddedWidth, paddedHeight, paddedDepth, glm::vec3(0.0f), 0.0f);
+			}
+			else {
+				c->mesh->cpuMesh.vertices.reserve(size / 3);
+				c->mesh->cpuMesh.normals.reserve(size / 3);
+				Cpu::CreateMarchingCubesTriangles(c->mesh->cpuMesh, c->densities, c->activeVoxels, paddedWidth, paddedHeight, glm::vec3(0.0f), 0.0f);
+			}
+			SnapMarchingCubesBorder(c->mesh->cpuMesh, c->densities, paddedSize, lod, 0.0f);
+			for (glm::vec3& vertex : c->mesh->cpuMesh.vertices)
+				vertex = vertex * (float)stride + offset;
+			c->mesh->maxVertexCount = (int)c->mesh->cpuMesh.vertices.size();
+			c->mesh->maxIndexCount = (int)c->mesh->cpuMesh.indices.size();
+			c->mesh->cpuMesh.isReady = true;
+			c->densities.clear();
+			c->densities.shrink_to_fit();
+			c->activeVoxels.clear();
+			c->activeVoxels.shrink_to_fit();
+		}, { culling }, c);
+	}
+}
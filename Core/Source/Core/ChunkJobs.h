@@ -0,0 +1,63 @@
+#pragma once
+#include "Core.h"
+#include "DensityStore.h"
+#include "JobSystem.h"
+#include "MarchingCubesLod.h"
+#include "PalettedBlockIds.h"
+#include "RegionFile.h"
+
+namespace Core {
+	//Chunk generation split into jobs on a JobSystem. Every stage runs the CPU backend on the worker threads, so these work with either backend
+	//and never touch GL. The caller owns the chunk struct and must keep it alive until its address comes back from JobSystem::PopCompleted,
+	//after which the mesh can be uploaded on the GL thread.
+	struct HeightMapChunkJob {
+		glm::ivec2 coord = glm::ivec2(0);
+		PlaneMesh mesh;
+		JobHandle done;
+	};
+
+	struct HeightMapTextureChunkJob {
+		glm::ivec2 coord = glm::ivec2(0);
+		HeightMapTexture heights; //pass it to UploadHeightMapTexture on the GL thread
+		JobHandle done;
+	};
+
+	struct VoxelCubesChunkJob {
+		glm::ivec2 coord = glm::ivec2(0);
+		BlockIds blockIDs; //emptied once the mesh is done
+		PalettedBlockIds packedIDs; //blockIDs packed after meshing, what a chunk map should keep
+		PlaneMesh mesh;
+		JobHandle done;
+	};
+
+	struct MarchingCubesChunkJob {
+		glm::ivec3 coord = glm::ivec3(0);
+		ChunkOccupancy occupancy = ChunkOccupancy::Mixed;
+		MarchingCubesLod lod;
+		VoxelMesh* mesh = nullptr; //only cpuMesh is filled, pass it to UploadVoxelMesh on the GL thread. Stays null for Air and Solid chunks.
+		std::vector<float> densities;
+		std::vector<uint32_t> activeVoxels;
+		JobHandle done;
+	};
+
+	//Same vertices and indices as CreateHeightMapPlaneMeshGPU, normals from the neighbouring triangles like HeightMapNormal.comp. Vertices,
+	//displacement and normals run after each other, indices in parallel with them.
+	void ScheduleHeightMapChunk(JobSystem& jobs, HeightMapChunkJob& chunk, int width, int height, float scale = 0.1f, float amplitude = 1.0f, float frequency = 1.0f, int octaves = 5, float persistance = 0.5f, float lacunarity = 2.0f);
+	//Heights of the same chunk for drawing with a shared grid, one job with no vertex, index or normal work
+	void ScheduleHeightMapTextureChunk(JobSystem& jobs, HeightMapTextureChunkJob& chunk, int width, int height, float scale = 0.1f, float amplitude = 1.0f, float frequency = 1.0f, int octaves = 5, float persistance = 0.5f, float lacunarity = 2.0f);
+	//Same output as CreateVoxelCubes3DMesh: density, painting and meshing jobs, the block IDs come out packed. With regions a chunk saved there
+	//(at coord (x, 0, y)) is one job that copies it out of its region file, and a generated chunk is saved by its meshing job. The regions must
+	//have been saved with the same settings.
+	void ScheduleVoxelCubesChunk(JobSystem& jobs, VoxelCubesChunkJob& chunk, int width, int height, int depth, float frequency = 1.0f, bool greedy = false, RegionStore* regions = nullptr);
+	//Same output as CreateMarchingCubes3DMeshGPU with the CPU backend: density, surface culling and meshing jobs. The density job classifies the
+	//chunk first and Air and Solid chunks skip everything else. With a store the densities of Mixed chunks are acquired from it (and its frequency
+	//is used), so borders shared with neighbouring chunks are only evaluated once. Release the box from MarchingCubesChunkBox of a Mixed chunk
+	//once it is unloaded or discarded. Chunks above level 0 of lod sample their own coarser lattice and never use the store, and are stitched
+	//to their coarser neighbours (see MarchingCubesLod.h); the chunk size has to be divisible by the stride of the coarsest neighbour.
+	void ScheduleMarchingCubesChunk(JobSystem& jobs, MarchingCubesChunkJob& chunk, int width, int height, int depth, float frequency = 1.0f, bool indexed = false, DensityStore* store = nullptr, MarchingCubesLod lod = {});
+	//Lattice origin and size of the padded density box of a marching cubes chunk
+	inline void MarchingCubesChunkBox(glm::ivec3 coord, int width, int height, int depth, glm::ivec3& origin, glm::ivec3& size) {
+		origin = coord * glm::ivec3(width, height, depth);
+		size = glm::ivec3(width + 1, height + 1, depth + 1);
+	}
+}
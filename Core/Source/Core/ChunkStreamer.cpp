@@ -0,0 +1,296 @@
+#include "ChunkStreamer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace Core {
+	namespace {
+		bool CloserFirst(const ChunkStreamer::Candidate& a, const ChunkStreamer::Candidate& b) { return a.score > b.score; }
+	}
+
+	void ExtractFrustum(const glm::mat4& m, glm::vec4 planes[6]) {
+		glm::vec4 r0(m[0][0], m[1][0], m[2][0], m[3][0]);
+		glm::vec4 r1(m[0][1], m[1][1], m[2][1], m[3][1]);
+		glm::vec4 r2(m[0][2], m[1][2], m[2][2], m[3][2]);
+		glm::vec4 r3(m[0][3], m[1][3], m[2][3], m[3][3]);
+		planes[0] = r3 + r0;
+		planes[1] = r3 - r0;
+		planes[2] = r3 + r1;
+		planes[3] = r3 - r1;
+		planes[4] = r3 + r2;
+		planes[5] = r3 - r2;
+	}
+
+	bool BoxInFrustum(const glm::vec4 planes[6], glm::vec3 boxMin, glm::vec3 boxMax) {
+		for (int i = 0; i < 6; i++) {
+			//Corner furthest along the plane normal
+			glm::vec3 p(planes[i].x >= 0.0f ? boxMax.x : boxMin.x, planes[i].y >= 0.0f ? boxMax.y : boxMin.y, planes[i].z >= 0.0f ? boxMax.z : boxMin.z);
+			if (glm::dot(glm::vec3(planes[i]), p) + planes[i].w < 0.0f)
+				return false;
+		}
+		return true;
+	}
+
+	ChunkStreamer::ChunkStreamer(const ChunkStreamCallbacks& callbacks, int threadCount) : _callbacks(callbacks), _jobs(threadCount) {
+		BuildExtents();
+	}
+
+	ChunkStreamer::~ChunkStreamer() {
+		//Only free what is still in flight, the owner of the loaded chunks cleans those up itself
+		_jobs.WaitAll();
+		void* data;
+		while (_jobs.PopCompleted(data)) {
+			auto it = _pending.find(data);
+			if (it != _pending.end())
+				_ready.push_back({ it->second.coord, data, it->second.variant });
+		}
+		for (const ReadyChunk& chunk : _ready)
+			_callbacks.discard(chunk.coord, chunk.data);
+	}
+
+	void ChunkStreamer::Configure(const ChunkStreamSettings& settings) {
+		_settings = settings;
+		BuildExtents();
+		if (_hasCenter) {
+			for (auto it = _loaded.begin(); it != _loaded.end(); ) {
+				if (!InRange(it->first, _unloadExtents, _settings.viewRadius + _settings.unloadMargin)) {
+					_callbacks.unload(it->first);
+					it = _loaded.erase(it);
+				}
+				else {
+					++it;
+				}
+			}
+		}
+		//Enumerate the whole view again on the next Update, chunks that are loaded or generating are skipped
+		_queue.clear();
+		_hasCenter = false;
+	}
+
+	void ChunkStreamer::Reset() {
+		_jobs.WaitAll();
+		void* data;
+		while (_jobs.PopCompleted(data)) {
+			auto it = _pending.find(data);
+			if (it != _pending.end())
+				_ready.push_back({ it->second.coord, data, it->second.variant });
+		}
+		for (const ReadyChunk& chunk : _ready)
+			_callbacks.discard(chunk.coord, chunk.data);
+		for (auto& [coord, variant] : _loaded)
+			_callbacks.unload(coord);
+
+		_ready.clear();
+		_pending.clear();
+		_pendingCoords.clear();
+		_loaded.clear();
+		_queue.clear();
+		_hasCenter = false;
+	}
+
+	void ChunkStreamer::Update(const glm::vec3& cameraPosition, const glm::mat4& viewProjection) {
+		UpdateStreaming(cameraPosition, &viewProjection);
+	}
+
+	void ChunkStreamer::Update(const glm::vec3& cameraPosition) {
+		UpdateStreaming(cameraPosition, nullptr);
+	}
+
+	void ChunkStreamer::UpdateStreaming(const glm::vec3& cameraPosition, const glm::mat4* viewProjection) {
+		glm::ivec3 center = glm::ivec3(glm::floor(cameraPosition / _settings.chunkSize));
+		if (_settings.flat)
+			center.y = 0;
+
+		if (!_hasCenter || center != _center) {
+			int viewRadius = _settings.viewRadius;
+			int unloadRadius = _settings.viewRadius + _settings.unloadMargin;
+
+			//Chunks that entered the view radius
+			ForEachEntering(_hasCenter, _center, center, _viewExtents, viewRadius, [this](glm::ivec3 coord) {
+				if (_loaded.count(coord) == 0 && _pendingCoords.count(coord) == 0)
+					_queue.push_back({ coord, 0.0f });
+			});
+			//Chunks that left the unload radius, seen from the new center these are the ones "entering" the old one
+			if (_hasCenter) {
+				ForEachEntering(true, center, _center, _unloadExtents, unloadRadius, [this](glm::ivec3 coord) {
+					if (_loaded.erase(coord))
+						_callbacks.unload(coord);
+				});
+			}
+			_center = center;
+			_hasCenter = true;
+			_rescore = true;
+			QueueChangedVariants();
+		}
+
+		if (cameraPosition != _scoredPosition || (viewProjection && *viewProjection != _scoredViewProjection))
+			_rescore = true;
+		if (_rescore)
+			Rescore(cameraPosition, viewProjection);
+
+		ScheduleChunks();
+		HandOutChunks();
+	}
+
+	void ChunkStreamer::BuildExtents() {
+		auto build = [this](std::vector<int>& extents, int radius) {
+			int size = 2 * radius + 1;
+			extents.assign(size * size, -1);
+			for (int dy = -radius; dy <= radius; dy++) {
+				if (_settings.flat && dy != 0)
+					continue;
+				for (int dz = -radius; dz <= radius; dz++) {
+					int rest = radius * radius - dy * dy - dz * dz;
+					if (rest >= 0)
+						extents[(dy + radius) * size + dz + radius] = (int)std::sqrt((float)rest);
+				}
+			}
+		};
+		build(_viewExtents, _settings.viewRadius);
+		build(_unloadExtents, _settings.viewRadius + _settings.unloadMargin);
+	}
+
+	int ChunkStreamer::Extent(const std::vector<int>& extents, int radius, int dy, int dz) const {
+		if (dy < -radius || dy > radius || dz < -radius || dz > radius)
+			return -1;
+		return extents[(dy + radius) * (2 * radius + 1) + dz + radius];
+	}
+
+	bool ChunkStreamer::InRange(glm::ivec3 coord, const std::vector<int>& extents, int radius) const {
+		int e = Extent(extents, radius, coord.y - _center.y, coord.z - _center.z);
+		return e >= 0 && std::abs(coord.x - _center.x) <= e;
+	}
+
+	//Calls fn for every coordinate in the sphere around to that is not in the sphere around from. Walks the (y, z) lines of the sphere and
+	//subtracts the x interval of the old sphere on the same line, so only the shell is visited.
+	template<typename Fn>
+	void ChunkStreamer::ForEachEntering(bool hasFrom, glm::ivec3 from, glm::ivec3 to, const std::vector<int>& extents, int radius, Fn fn) const {
+		for (int dy = -radius; dy <= radius; dy++) {
+			for (int dz = -radius; dz <= radius; dz++) {
+				int e = Extent(extents, radius, dy, dz);
+				if (e < 0)
+					continue;
+				int y = to.y + dy;
+				int z = to.z + dz;
+				int lo = to.x - e;
+				int hi = to.x + e;
+
+				int fromE = hasFrom ? Extent(extents, radius, y - from.y, z - from.z) : -1;
+				if (fromE < 0) {
+					for (int x = lo; x <= hi; x++)
+						fn(glm::ivec3(x, y, z));
+					continue;
+				}
+				int fromLo = from.x - fromE;
+				int fromHi = from.x + fromE;
+				for (int x = lo; x <= std::min(hi, fromLo - 1); x++)
+					fn(glm::ivec3(x, y, z));
+				for (int x = std::max(lo, fromHi + 1); x <= hi; x++)
+					fn(glm::ivec3(x, y, z));
+			}
+		}
+	}
+
+	void ChunkStreamer::Rescore(const glm::vec3& cameraPosition, const glm::mat4* viewProjection) {
+		glm::vec4 planes[6];
+		if (viewProjection)
+			ExtractFrustum(*viewProjection, planes);
+
+		//Candidates that left the view radius since they were queued are dropped here
+		size_t kept = 0;
+		for (size_t i = 0; i < _queue.size(); i++) {
+			glm::ivec3 coord = _queue[i].coord;
+			if (!InRange(coord, _viewExtents, _settings.viewRadius))
+				continue;
+
+			glm::vec3 boxMin = glm::vec3(coord) * _settings.chunkSize;
+			glm::vec3 boxMax = boxMin + _settings.chunkSize;
+			glm::vec3 centerPos = (boxMin + boxMax) * 0.5f;
+			if (_settings.flat)
+				centerPos.y = cameraPosition.y;
+			glm::vec3 d = centerPos - cameraPosition;
+			float score = glm::dot(d, d);
+			//Chunks behind the camera are generated as if they were twice as far away
+			if (viewProjection && !BoxInFrustum(planes, boxMin, boxMax))
+				score *= 4.0f;
+
+			_queue[kept++] = { coord, score };
+		}
+		_queue.resize(kept);
+		std::make_heap(_queue.begin(), _queue.end(), CloserFirst);
+
+		_scoredPosition = cameraPosition;
+		if (viewProjection)
+			_scoredViewProjection = *viewProjection;
+		_rescore = false;
+	}
+
+	void ChunkStreamer::ScheduleChunks() {
+		size_t maxInFlight = _settings.maxInFlight > 0 ? (size_t)_settings.maxInFlight : (size_t)_jobs.GetWorkerCount() * 2;
+		while (_pending.size() < maxInFlight && !_queue.empty()) {
+			std::pop_heap(_queue.begin(), _queue.end(), CloserFirst);
+			glm::ivec3 coord = _queue.back().coord;
+			_queue.pop_back();
+			if (!InRange(coord, _viewExtents, _settings.viewRadius) || _pendingCoords.count(coord))
+				continue;
+			uint32_t variant = Variant(coord);
+			auto loaded = _loaded.find(coord);
+			if (loaded != _loaded.end() && loaded->second == variant)
+				continue;
+
+			void* data = _callbacks.schedule(_jobs, coord);
+			_pending[data] = { coord, variant };
+			_pendingCoords.insert(coord);
+		}
+	}
+
+	void ChunkStreamer::HandOutChunks() {
+		void* data;
+		while (_jobs.PopCompleted(data)) {
+			auto it = _pending.find(data);
+			if (it == _pending.end())
+				continue;
+			_ready.push_back({ it->second.coord, data, it->second.variant });
+			_pendingCoords.erase(it->second.coord);
+			_pending.erase(it);
+		}
+
+		//At least one chunk per frame is handed out so streaming never stalls on a tight budget
+		auto start = std::chrono::steady_clock::now();
+		int unloadRadius = _settings.viewRadius + _settings.unloadMargin;
+		while (!_ready.empty()) {
+			ReadyChunk chunk = _ready.front();
+			_ready.pop_front();
+			if (!InRange(chunk.coord, _unloadExtents, unloadRadius)) {
+				_callbacks.discard(chunk.coord, chunk.data);
+				continue;
+			}
+			_callbacks.ready(chunk.coord, chunk.data);
+			_loaded[chunk.coord] = chunk.variant;
+			//The camera moved on while it was generating, it is shown until the one with the current variant replaces it
+			if (chunk.variant != Variant(chunk.coord)) {
+				_queue.push_back({ chunk.coord, 0.0f });
+				_rescore = true;
+			}
+
+			double elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+			if (elapsed >= _settings.frameBudgetMs)
+				break;
+		}
+	}
+
+	uint32_t ChunkStreamer::Variant(glm::ivec3 coord) const {
+		return _callbacks.variant ? _callbacks.variant(coord, _center) : 0;
+	}
+
+	//Visits every loaded chunk, but only when the camera enters another chunk and only for streamers with variants
+	void ChunkStreamer::QueueChangedVariants() {
+		if (!_callbacks.variant)
+			return;
+		for (auto& [coord, variant] : _loaded) {
+			if (!_pendingCoords.count(coord) && InRange(coord, _viewExtents, _settings.viewRadius) && variant != Variant(coord))
+				_queue.push_back({ coord, 0.0f });
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#pragma once
+#include "Core.h"
+#include "JobSystem.h"
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Core {
+	struct ChunkCoordHash {
+		size_t operator()(const glm::ivec3& c) const {
+			return ((size_t)(uint32_t)c.x * 73856093u) ^ ((size_t)(uint32_t)c.y * 19349663u) ^ ((size_t)(uint32_t)c.z * 83492791u);
+		}
+	};
+
+	//Planes of the view frustum as (normal, distance) from the rows of a view projection matrix, normals pointing inwards
+	void ExtractFrustum(const glm::mat4& viewProjection, glm::vec4 planes[6]);
+	//Conservative, boxes near a corner of the frustum can pass without touching it
+	bool BoxInFrustum(const glm::vec4 planes[6], glm::vec3 boxMin, glm::vec3 boxMax);
+
+	//The chunk grid the streamer walks. Flat grids (heightmaps, voxel columns) only stream along x and z and always use y = 0 in their coordinates.
+	struct ChunkStreamSettings {
+		glm::vec3 chunkSize = glm::vec3(16.0f); //world size of one chunk, for flat grids y is the column height used for the frustum test
+		bool flat = false;
+		int viewRadius = 4; //in chunks
+		int unloadMargin = 2; //loaded chunks are kept until they are this many chunks outside the view radius
+		int maxInFlight = 0; //chunks generating at the same time, 0 uses two per worker thread
+		double frameBudgetMs = 2.0; //time per Update spent handing finished chunks to the ready callback
+	};
+
+	//What the streamer calls to generate and hand out chunks. All callbacks run on the thread that calls Update.
+	struct ChunkStreamCallbacks {
+		//Schedule the jobs of one chunk and return the completion data the last job pushes (see ChunkJobs.h)
+		std::function<void* (JobSystem& jobs, glm::ivec3 coord)> schedule;
+		//A chunk finished and is still in range, take its mesh
+		std::function<void(glm::ivec3 coord, void* chunk)> ready;
+		//A chunk finished after it went out of range, or the streamer was reset while it was generating
+		std::function<void(glm::ivec3 coord, void* chunk)> discard;
+		//A chunk handed out by ready went out of range
+		std::function<void(glm::ivec3 coord)> unload;
+		//Optional, anything the chunk depends on besides its coordinate, e.g. its level of detail, for the chunk the camera is in. When the
+		//camera moves to another chunk, loaded chunks whose variant changed are generated again and handed to ready once more, which has to
+		//replace the old chunk. The old one stays loaded until then.
+		std::function<uint32_t(glm::ivec3 coord, glm::ivec3 center)> variant;
+	};
+
+	//Keeps the chunks around a camera loaded. Missing chunks sit in a priority queue ordered by distance to the camera, with chunks outside the
+	//view frustum pushed back. When the camera crosses a chunk border only the shell of chunks that enter or leave the radius is visited, so the
+	//cost does not grow with the volume of the view. Finished chunks are handed out a few at a time under a per frame time budget.
+	class ChunkStreamer {
+	public:
+		ChunkStreamer(const ChunkStreamCallbacks& callbacks, int threadCount = 0);
+		~ChunkStreamer();
+		ChunkStreamer(const ChunkStreamer&) = delete;
+		ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+		//Loaded chunks that fall outside the new radius are unloaded, changing the chunk size or flat needs a Reset first
+		void Configure(const ChunkStreamSettings& settings);
+		void Update(const glm::vec3& cameraPosition, const glm::mat4& viewProjection);
+		void Update(const glm::vec3& cameraPosition);
+		//Waits for the chunks in flight and discards them, then unloads every loaded chunk
+		void Reset();
+
+		bool IsLoaded(glm::ivec3 coord) const { return _loaded.count(coord) != 0; }
+		//Chunk the camera was in at the last Update, what schedule should compute a variant for
+		glm::ivec3 GetCenter() const { return _center; }
+		size_t GetLoadedCount() const { return _loaded.size(); }
+		size_t GetPendingCount() const { return _pending.size() + _ready.size(); }
+		size_t GetQueuedCount() const { return _queue.size(); }
+		JobSystem& GetJobSystem() { return _jobs; }
+
+		struct Candidate {
+			glm::ivec3 coord;
+			float score; //squared distance to the camera, lower is generated first
+		};
+
+	private:
+		void UpdateStreaming(const glm::vec3& cameraPosition, const glm::mat4* viewProjection);
+		void BuildExtents();
+		int Extent(const std::vector<int>& extents, int radius, int dy, int dz) const;
+		bool InRange(glm::ivec3 coord, const std::vector<int>& extents, int radius) const;
+		template<typename Fn> void ForEachEntering(bool hasFrom, glm::ivec3 from, glm::ivec3 to, const std::vector<int>& extents, int radius, Fn fn) const;
+		void Rescore(const glm::vec3& cameraPosition, const glm::mat4* viewProjection);
+		void ScheduleChunks();
+		void HandOutChunks();
+		uint32_t Variant(glm::ivec3 coord) const;
+		void QueueChangedVariants();
+
+		ChunkStreamCallbacks _callbacks;
+		ChunkStreamSettings _settings;
+		JobSystem _jobs;
+
+		struct PendingChunk {
+			glm::ivec3 coord;
+			uint32_t variant;
+		};
+		struct ReadyChunk {
+			glm::ivec3 coord;
+			void* data;
+			uint32_t variant;
+		};
+
+		std::unordered_map<glm::ivec3, uint32_t, ChunkCoordHash> _loaded; //chunk -> variant it was generated with
+		std::unordered_set<glm::ivec3, ChunkCoordHash> _pendingCoords;
+		std::unordered_map<void*, PendingChunk> _pending; //completion data -> chunk
+		std::deque<ReadyChunk> _ready; //finished but not handed out yet
+		std::vector<Candidate> _queue; //heap with the lowest score on top
+
+		//Half width along x of the view and unload spheres for every (y, z) line
+		std::vector<int> _viewExtents;
+		std::vector<int> _unloadExtents;
+
+		glm::ivec3 _center = glm::ivec3(0);
+		bool _hasCenter = false;
+		bool _rescore = false;
+		glm::vec3 _scoredPosition = glm::vec3(0.0f);
+		glm::mat4 _scoredViewProjection = glm::mat4(0.0f);
+	};
+}
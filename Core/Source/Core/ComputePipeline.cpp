@@ -0,0 +1,185 @@
+#include "ComputePipeline.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+namespace Core {
+	namespace {
+		std::string readFile(const std::string& filePath) {
+			std::ifstream file(filePath);
+			std::stringstream buffer;
+			if (file) {
+				buffer << file.rdbuf();
+			}
+			else {
+				std::cerr << "Failed to open file: " << filePath << "\n";
+			}
+			return buffer.str();
+		}
+	}
+
+	GLuint CreateComputeShaderProgram(const std::string& path) {
+		GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+		std::string source = readFile(path);
+		const char* src = source.c_str();
+		glShaderSource(shader, 1, &src, nullptr);
+		glCompileShader(shader);
+
+		// Check compilation status
+		GLint success;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+		if (!success) {
+			GLint logLength;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+			std::vector<char> log(logLength);
+			glGetShaderInfoLog(shader, logLength, nullptr, log.data());
+			std::cerr << "Compute Shader compilation failed:\n" << log.data() << std::endl;
+			glDeleteShader(shader);
+			return 0;
+		}
+
+		// Link shader into a program
+		GLuint program = glCreateProgram();
+		glAttachShader(program, shader);
+		glLinkProgram(program);
+
+		glGetProgramiv(program, GL_LINK_STATUS, &success);
+		if (!success) {
+			GLint logLength;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
+			std::vector<char> log(logLength);
+			glGetProgramInfoLog(program, logLength, nullptr, log.data());
+			std::cerr << "Program linking failed:\n" << log.data() << std::endl;
+			glDeleteShader(shader);
+			glDeleteProgram(program);
+			return 0;
+		}
+
+		glDeleteShader(shader); // Safe to delete after linking
+		return program;
+	}
+
+	void ComputePipeline::Create(GLuint program) {
+		struct Name { const char* name; Field field; };
+		static const Name names[] = {
+			{ "width", Field::Width }, { "gridWidth", Field::Width },
+			{ "height", Field::Height }, { "gridHeight", Field::Height },
+			{ "depth", Field::Depth }, { "gridDepth", Field::Depth },
+			{ "offset", Field::Offset },
+			{ "amplitude", Field::Amplitude },
+			{ "frequency", Field::Frequency },
+			{ "persistance", Field::Persistance },
+			{ "lacunarity", Field::Lacunarity },
+			{ "octaves", Field::Octaves },
+			{ "useHeightDropoff", Field::UseHeightDropoff },
+			{ "splinePointsCount", Field::SplinePointsCount },
+			{ "isoLevel", Field::IsoLevel },
+			{ "scale", Field::Scale },
+			{ "columns", Field::Columns },
+			{ "rows", Field::Rows },
+		};
+
+		Reset();
+		_program = program;
+		if (program == 0) return;
+
+		GLint count = 0;
+		glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+		std::string unknown;
+		for (GLint i = 0; i < count; i++) {
+			char name[64];
+			GLint size = 0;
+			GLenum type = 0;
+			glGetActiveUniform(program, (GLuint)i, sizeof(name), nullptr, &size, &type, name);
+			GLint location = glGetUniformLocation(program, name);
+			if (location < 0) continue; //block members have no location
+
+			bool known = false;
+			for (const Name& entry : names) {
+				if (std::strcmp(entry.name, name) == 0) {
+					_uniforms.push_back({ entry.field, location, type, Value(), false });
+					known = true;
+					break;
+				}
+			}
+			if (!known) unknown += unknown.empty() ? name : std::string(", ") + name;
+		}
+		//Such a uniform keeps its default value, one line per program when it is compiled
+		if (!unknown.empty())
+			std::cerr << "ComputePipeline: uniforms of program " << program << " not in ComputeParams: " << unknown << "\n";
+	}
+
+	void ComputePipeline::Reset() {
+		_program = 0;
+		_uniforms.clear();
+	}
+
+	void ComputePipeline::Release() {
+		if (_path && _program) glDeleteProgram(_program);
+		if (_handle) *_handle = 0;
+		Reset();
+		_compiled = false;
+	}
+
+	void ComputePipeline::Bind(const ComputeParams& params) {
+		if (_path && !_compiled) {
+			Create(CreateComputeShaderProgram(_path));
+			if (_handle) *_handle = _program;
+			_compiled = true;
+		}
+		glUseProgram(_program);
+		for (Uniform& uniform : _uniforms) {
+			Value value = GetValue(params, uniform.field);
+			if (uniform.uploaded && value == uniform.value) continue;
+
+			const glm::ivec3& ints = value.ints;
+			const glm::vec3& floats = value.floats;
+			//The GL type picks the slot, integer uniforms never see a float
+			switch (uniform.type) {
+			case GL_FLOAT: glUniform1f(uniform.location, floats.x); break;
+			case GL_FLOAT_VEC2: glUniform2f(uniform.location, floats.x, floats.y); break;
+			case GL_FLOAT_VEC3: glUniform3f(uniform.location, floats.x, floats.y, floats.z); break;
+			case GL_INT_VEC2: glUniform2i(uniform.location, ints.x, ints.y); break;
+			case GL_INT_VEC3: glUniform3i(uniform.location, ints.x, ints.y, ints.z); break;
+			default: glUniform1i(uniform.location, ints.x); break; //int and bool
+			}
+			uniform.value = value;
+			uniform.uploaded = true;
+		}
+	}
+
+	ComputePipeline::Value ComputePipeline::GetValue(const ComputeParams& params, Field field) {
+		Value value;
+		auto setInt = [&](int x) {
+			value.ints.x = x;
+			value.floats.x = (float)x;
+		};
+		auto setFloat = [&](float x) {
+			value.ints.x = (int)x;
+			value.floats.x = x;
+		};
+		switch (field) {
+		case Field::Width: setInt(params.size.x); break;
+		case Field::Height: setInt(params.size.y); break;
+		case Field::Depth: setInt(params.size.z); break;
+		case Field::Offset:
+			value.ints = glm::ivec3(params.gridOffset, 0);
+			value.floats = params.offset;
+			break;
+		case Field::Amplitude: setFloat(params.amplitude); break;
+		case Field::Frequency: setFloat(params.frequency); break;
+		case Field::Persistance: setFloat(params.persistance); break;
+		case Field::Lacunarity: setFloat(params.lacunarity); break;
+		case Field::Octaves: setInt(params.octaves); break;
+		case Field::UseHeightDropoff: setInt(params.useHeightDropoff ? 1 : 0); break;
+		case Field::SplinePointsCount: setInt(params.splinePointsCount); break;
+		case Field::IsoLevel: setFloat(params.isoLevel); break;
+		case Field::Scale: setFloat(params.scale); break;
+		case Field::Columns: setFloat(params.columns); break;
+		case Field::Rows: setFloat(params.rows); break;
+		}
+		return value;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <glad/glad.h>
+
+#include "glm.hpp"
+
+#include <string>
+#include <vector>
+
+namespace Core {
+	//Every value a Core compute program takes as a uniform. A program reads the fields it declares and ignores the rest; fields left at
+	//zero upload zero, same as a uniform that is never set.
+	struct ComputeParams {
+		glm::ivec3 size = glm::ivec3(0); //width, height, depth, also bound to gridWidth, gridHeight, gridDepth
+		glm::vec3 offset = glm::vec3(0.0f);
+		glm::ivec2 gridOffset = glm::ivec2(0); //what programs with an ivec2 offset take instead
+		float amplitude = 0.0f;
+		float frequency = 0.0f;
+		float persistance = 0.0f;
+		float lacunarity = 0.0f;
+		int octaves = 0;
+		bool useHeightDropoff = false;
+		int splinePointsCount = 0;
+		float isoLevel = 0.0f;
+		float scale = 0.0f;
+		float columns = 0.0f;
+		float rows = 0.0f;
+	};
+
+	//The active uniforms of one compute program, looked up by reflection once when it is created. Bind uploads the ComputeParams fields
+	//the program declares, and only those that changed since its last Bind since a program keeps its uniform values, so dispatching a
+	//chunk costs no string lookups and usually only the offset upload. Set the program's uniforms through Bind only, or the cache goes
+	//stale. Storage buffers need nothing resolved, every .comp fixes its bindings in the layout qualifier.
+	class ComputePipeline {
+	public:
+		ComputePipeline() = default;
+		//Compiles the .comp file at path on the first Bind instead, so only the programs that get dispatched are ever compiled. program
+		//is kept pointing at the compiled program when given.
+		ComputePipeline(const char* path, GLuint* program = nullptr) : _path(path), _handle(program) {}
+
+		void Create(GLuint program);
+		//Forgets the program, it is not deleted
+		void Reset();
+		//Deletes a program compiled from the path, the next Bind compiles it again. Call it before the GL context goes away.
+		void Release();
+		void Bind(const ComputeParams& params);
+		GLuint GetProgram() const { return _program; }
+
+	private:
+		enum class Field {
+			Width, Height, Depth, Offset, Amplitude, Frequency, Persistance, Lacunarity, Octaves,
+			UseHeightDropoff, SplinePointsCount, IsoLevel, Scale, Columns, Rows
+		};
+		//A field as both an integer and a float, Bind uploads the one the reflected type asks for. Integer fields keep their exact value in
+		//ints, so sizes and counts never go through a float.
+		struct Value {
+			glm::ivec3 ints = glm::ivec3(0);
+			glm::vec3 floats = glm::vec3(0.0f);
+			bool operator==(const Value& other) const { return ints == other.ints && floats == other.floats; }
+		};
+		struct Uniform {
+			Field field;
+			GLint location;
+			GLenum type;
+			Value value; //last upload
+			bool uploaded = false;
+		};
+
+		GLuint _program = 0;
+		std::vector<Uniform> _uniforms;
+		const char* _path = nullptr;
+		GLuint* _handle = nullptr;
+		bool _compiled = false; //also after a failed compile, so the error is printed once
+
+		static Value GetValue(const ComputeParams& params, Field field);
+	};
+
+	//Reads, compiles and links one compute shader, 0 with the log on std::cerr when that fails
+	GLuint CreateComputeShaderProgram(const std::string& path);
+}
@@ -1,4 +1,15 @@
 #include "Core.h"
+#include "BufferArena.h"
+#include "ComputePipeline.h"
+#include "CpuBackend.h"
+#include "SimdNoise.h"
+#include "MarchingCubesTables.h"
+#include "PalettedBlockIds.h"
+#include "PackedVertices.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
 
 namespace Core {
 	//Used for functions that are not exposed to the user, but are used internally in the library. Some are CPU implementation of the GPU functions, that are meant for debugging,
@@ -6,57 +17,6 @@ namespace Core {
 	//If for any reason there would be a need to expose these functions, they can be moved to the Core namespace and made public. Just remember to declare them in the
 	//header file Core.h.
 	namespace {
-		std::string readFile(const std::string& filePath) {
-			std::ifstream file(filePath);
-			std::stringstream buffer;
-			if (file) {
-				buffer << file.rdbuf();
-			}
-			else {
-				std::cerr << "Failed to open file: " << filePath << "\n";
-			}
-			return buffer.str();
-		}
-		GLuint CreateComputeShaderProgram(const std::string& path) {
-			GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
-			std::string source = readFile(path);
-			const char* src = source.c_str();
-			glShaderSource(shader, 1, &src, nullptr);
-			glCompileShader(shader);
-
-			// Check compilation status
-			GLint success;
-			glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
-			if (!success) {
-				GLint logLength;
-				glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
-				std::vector<char> log(logLength);
-				glGetShaderInfoLog(shader, logLength, nullptr, log.data());
-				std::cerr << "Compute Shader compilation failed:\n" << log.data() << std::endl;
-				glDeleteShader(shader);
-				return 0;
-			}
-
-			// Link shader into a program
-			GLuint program = glCreateProgram();
-			glAttachShader(program, shader);
-			glLinkProgram(program);
-
-			glGetProgramiv(program, GL_LINK_STATUS, &success);
-			if (!success) {
-				GLint logLength;
-				glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
-				std::vector<char> log(logLength);
-				glGetProgramInfoLog(program, logLength, nullptr, log.data());
-				std::cerr << "Program linking failed:\n" << log.data() << std::endl;
-				glDeleteShader(shader);
-				glDeleteProgram(program);
-				return 0;
-			}
-
-			glDeleteShader(shader); // Safe to delete after linking
-			return program;
-		}
 		int getIndex(int x, int z, int width) {
 			return z * width + x;
 		}
@@ -105,7 +65,11 @@ namespace Core {
 
 
 
-			return PlaneMesh(vertices, indices, normals);
+			PlaneMesh mesh;
+			mesh.vertices = std::move(vertices);
+			mesh.indices = std::move(indices);
+			mesh.normals = std::move(normals);
+			return mesh;
 		}
 		void CreateHeightMapPlaneMeshCPU(PlaneMesh& planeData, int height, int width) {
 
@@ -294,296 +258,6 @@ namespace Core {
 
 
 		}
-		int edgeTable[] =  {
-			0x0, 0x109, 0x203, 0x30a, 0x406, 0x50f, 0x605, 0x70c,
-				0x80c, 0x905, 0xa0f, 0xb06, 0xc0a, 0xd03, 0xe09, 0xf00,
-				0x190, 0x99, 0x393, 0x29a, 0x596, 0x49f, 0x795, 0x69c,
-				0x99c, 0x895, 0xb9f, 0xa96, 0xd9a, 0xc93, 0xf99, 0xe90,
-				0x230, 0x339, 0x33, 0x13a, 0x636, 0x73f, 0x435, 0x53c,
-				0xa3c, 0xb35, 0x83f, 0x936, 0xe3a, 0xf33, 0xc39, 0xd30,
-				0x3a0, 0x2a9, 0x1a3, 0xaa, 0x7a6, 0x6af, 0x5a5, 0x4ac,
-				0xbac, 0xaa5, 0x9af, 0x8a6, 0xfaa, 0xea3, 0xda9, 0xca0,
-				0x460, 0x569, 0x663, 0x76a, 0x66, 0x16f, 0x265, 0x36c,
-				0xc6c, 0xd65, 0xe6f, 0xf66, 0x86a, 0x963, 0xa69, 0xb60,
-				0x5f0, 0x4f9, 0x7f3, 0x6fa, 0x1f6, 0xff, 0x3f5, 0x2fc,
-				0xdfc, 0xcf5, 0xfff, 0xef6, 0x9fa, 0x8f3, 0xbf9, 0xaf0,
-				0x650, 0x759, 0x453, 0x55a, 0x256, 0x35f, 0x55, 0x15c,
-				0xe5c, 0xf55, 0xc5f, 0xd56, 0xa5a, 0xb53, 0x859, 0x950,
-				0x7c0, 0x6c9, 0x5c3, 0x4ca, 0x3c6, 0x2cf, 0x1c5, 0xcc,
-				0xfcc, 0xec5, 0xdcf, 0xcc6, 0xbca, 0xac3, 0x9c9, 0x8c0,
-				0x8c0, 0x9c9, 0xac3, 0xbca, 0xcc6, 0xdcf, 0xec5, 0xfcc,
-				0xcc, 0x1c5, 0x2cf, 0x3c6, 0x4ca, 0x5c3, 0x6c9, 0x7c0,
-				0x950, 0x859, 0xb53, 0xa5a, 0xd56, 0xc5f, 0xf55, 0xe5c,
-				0x15c, 0x55, 0x35f, 0x256, 0x55a, 0x453, 0x759, 0x650,
-				0xaf0, 0xbf9, 0x8f3, 0x9fa, 0xef6, 0xfff, 0xcf5, 0xdfc,
-				0x2fc, 0x3f5, 0xff, 0x1f6, 0x6fa, 0x7f3, 0x4f9, 0x5f0,
-				0xb60, 0xa69, 0x963, 0x86a, 0xf66, 0xe6f, 0xd65, 0xc6c,
-				0x36c, 0x265, 0x16f, 0x66, 0x76a, 0x663, 0x569, 0x460,
-				0xca0, 0xda9, 0xea3, 0xfaa, 0x8a6, 0x9af, 0xaa5, 0xbac,
-				0x4ac, 0x5a5, 0x6af, 0x7a6, 0xaa, 0x1a3, 0x2a9, 0x3a0,
-				0xd30, 0xc39, 0xf33, 0xe3a, 0x936, 0x83f, 0xb35, 0xa3c,
-				0x53c, 0x435, 0x73f, 0x636, 0x13a, 0x33, 0x339, 0x230,
-				0xe90, 0xf99, 0xc93, 0xd9a, 0xa96, 0xb9f, 0x895, 0x99c,
-				0x69c, 0x795, 0x49f, 0x596, 0x29a, 0x393, 0x99, 0x190,
-				0xf00, 0xe09, 0xd03, 0xc0a, 0xb06, 0xa0f, 0x905, 0x80c,
-				0x70c, 0x605, 0x50f, 0x406, 0x30a, 0x203, 0x109, 0x0   };
-		int FlatTriTable[256 * 16] = {
-		 -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 8, 3, 9, 8, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 2, 10, 0, 2, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		2, 8, 3, 2, 10, 8, 10, 9, 8, -1, -1, -1, -1, -1, -1, -1,
-		3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 11, 2, 8, 11, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 9, 0, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 11, 2, 1, 9, 11, 9, 8, 11, -1, -1, -1, -1, -1, -1, -1,
-		3, 10, 1, 11, 10, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 10, 1, 0, 8, 10, 8, 11, 10, -1, -1, -1, -1, -1, -1, -1,
-		3, 9, 0, 3, 11, 9, 11, 10, 9, -1, -1, -1, -1, -1, -1, -1,
-		9, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 3, 0, 7, 3, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 1, 9, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 1, 9, 4, 7, 1, 7, 3, 1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 4, 7, 3, 0, 4, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1,
-		9, 2, 10, 9, 0, 2, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1,
-		2, 10, 9, 2, 9, 7, 2, 7, 3, 7, 9, 4, -1, -1, -1, -1,
-		8, 4, 7, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		11, 4, 7, 11, 2, 4, 2, 0, 4, -1, -1, -1, -1, -1, -1, -1,
-		9, 0, 1, 8, 4, 7, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1,
-		4, 7, 11, 9, 4, 11, 9, 11, 2, 9, 2, 1, -1, -1, -1, -1,
-		3, 10, 1, 3, 11, 10, 7, 8, 4, -1, -1, -1, -1, -1, -1, -1,
-		1, 11, 10, 1, 4, 11, 1, 0, 4, 7, 11, 4, -1, -1, -1, -1,
-		4, 7, 8, 9, 0, 11, 9, 11, 10, 11, 0, 3, -1, -1, -1, -1,
-		4, 7, 11, 4, 11, 9, 9, 11, 10, -1, -1, -1, -1, -1, -1, -1,
-		9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 5, 4, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 5, 4, 1, 5, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		8, 5, 4, 8, 3, 5, 3, 1, 5, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 0, 8, 1, 2, 10, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1,
-		5, 2, 10, 5, 4, 2, 4, 0, 2, -1, -1, -1, -1, -1, -1, -1,
-		2, 10, 5, 3, 2, 5, 3, 5, 4, 3, 4, 8, -1, -1, -1, -1,
-		9, 5, 4, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 11, 2, 0, 8, 11, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1,
-		0, 5, 4, 0, 1, 5, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1,
-		2, 1, 5, 2, 5, 8, 2, 8, 11, 4, 8, 5, -1, -1, -1, -1,
-		10, 3, 11, 10, 1, 3, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1,
-		4, 9, 5, 0, 8, 1, 8, 10, 1, 8, 11, 10, -1, -1, -1, -1,
-		5, 4, 0, 5, 0, 11, 5, 11, 10, 11, 0, 3, -1, -1, -1, -1,
-		5, 4, 8, 5, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1,
-		9, 7, 8, 5, 7, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 3, 0, 9, 5, 3, 5, 7, 3, -1, -1, -1, -1, -1, -1, -1,
-		0, 7, 8, 0, 1, 7, 1, 5, 7, -1, -1, -1, -1, -1, -1, -1,
-		1, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 7, 8, 9, 5, 7, 10, 1, 2, -1, -1, -1, -1, -1, -1, -1,
-		10, 1, 2, 9, 5, 0, 5, 3, 0, 5, 7, 3, -1, -1, -1, -1,
-		8, 0, 2, 8, 2, 5, 8, 5, 7, 10, 5, 2, -1, -1, -1, -1,
-		2, 10, 5, 2, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1,
-		7, 9, 5, 7, 8, 9, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1,
-		9, 5, 7, 9, 7, 2, 9, 2, 0, 2, 7, 11, -1, -1, -1, -1,
-		2, 3, 11, 0, 1, 8, 1, 7, 8, 1, 5, 7, -1, -1, -1, -1,
-		11, 2, 1, 11, 1, 7, 7, 1, 5, -1, -1, -1, -1, -1, -1, -1,
-		9, 5, 8, 8, 5, 7, 10, 1, 3, 10, 3, 11, -1, -1, -1, -1,
-		5, 7, 0, 5, 0, 9, 7, 11, 0, 1, 0, 10, 11, 10, 0, -1,
-		11, 10, 0, 11, 0, 3, 10, 5, 0, 8, 0, 7, 5, 7, 0, -1,
-		11, 10, 5, 7, 11, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 0, 1, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 8, 3, 1, 9, 8, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1,
-		1, 6, 5, 2, 6, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 6, 5, 1, 2, 6, 3, 0, 8, -1, -1, -1, -1, -1, -1, -1,
-		9, 6, 5, 9, 0, 6, 0, 2, 6, -1, -1, -1, -1, -1, -1, -1,
-		5, 9, 8, 5, 8, 2, 5, 2, 6, 3, 2, 8, -1, -1, -1, -1,
-		2, 3, 11, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		11, 0, 8, 11, 2, 0, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1,
-		0, 1, 9, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1,
-		5, 10, 6, 1, 9, 2, 9, 11, 2, 9, 8, 11, -1, -1, -1, -1,
-		6, 3, 11, 6, 5, 3, 5, 1, 3, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 11, 0, 11, 5, 0, 5, 1, 5, 11, 6, -1, -1, -1, -1,
-		3, 11, 6, 0, 3, 6, 0, 6, 5, 0, 5, 9, -1, -1, -1, -1,
-		6, 5, 9, 6, 9, 11, 11, 9, 8, -1, -1, -1, -1, -1, -1, -1,
-		5, 10, 6, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 3, 0, 4, 7, 3, 6, 5, 10, -1, -1, -1, -1, -1, -1, -1,
-		1, 9, 0, 5, 10, 6, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1,
-		10, 6, 5, 1, 9, 7, 1, 7, 3, 7, 9, 4, -1, -1, -1, -1,
-		6, 1, 2, 6, 5, 1, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 5, 5, 2, 6, 3, 0, 4, 3, 4, 7, -1, -1, -1, -1,
-		8, 4, 7, 9, 0, 5, 0, 6, 5, 0, 2, 6, -1, -1, -1, -1,
-		7, 3, 9, 7, 9, 4, 3, 2, 9, 5, 9, 6, 2, 6, 9, -1,
-		3, 11, 2, 7, 8, 4, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1,
-		5, 10, 6, 4, 7, 2, 4, 2, 0, 2, 7, 11, -1, -1, -1, -1,
-		0, 1, 9, 4, 7, 8, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1,
-		9, 2, 1, 9, 11, 2, 9, 4, 11, 7, 11, 4, 5, 10, 6, -1,
-		8, 4, 7, 3, 11, 5, 3, 5, 1, 5, 11, 6, -1, -1, -1, -1,
-		5, 1, 11, 5, 11, 6, 1, 0, 11, 7, 11, 4, 0, 4, 11, -1,
-		0, 5, 9, 0, 6, 5, 0, 3, 6, 11, 6, 3, 8, 4, 7, -1,
-		6, 5, 9, 6, 9, 11, 4, 7, 9, 7, 11, 9, -1, -1, -1, -1,
-		10, 4, 9, 6, 4, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 10, 6, 4, 9, 10, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1,
-		10, 0, 1, 10, 6, 0, 6, 4, 0, -1, -1, -1, -1, -1, -1, -1,
-		8, 3, 1, 8, 1, 6, 8, 6, 4, 6, 1, 10, -1, -1, -1, -1,
-		1, 4, 9, 1, 2, 4, 2, 6, 4, -1, -1, -1, -1, -1, -1, -1,
-		3, 0, 8, 1, 2, 9, 2, 4, 9, 2, 6, 4, -1, -1, -1, -1,
-		0, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		8, 3, 2, 8, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1,
-		10, 4, 9, 10, 6, 4, 11, 2, 3, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 2, 2, 8, 11, 4, 9, 10, 4, 10, 6, -1, -1, -1, -1,
-		3, 11, 2, 0, 1, 6, 0, 6, 4, 6, 1, 10, -1, -1, -1, -1,
-		6, 4, 1, 6, 1, 10, 4, 8, 1, 2, 1, 11, 8, 11, 1, -1,
-		9, 6, 4, 9, 3, 6, 9, 1, 3, 11, 6, 3, -1, -1, -1, -1,
-		8, 11, 1, 8, 1, 0, 11, 6, 1, 9, 1, 4, 6, 4, 1, -1,
-		3, 11, 6, 3, 6, 0, 0, 6, 4, -1, -1, -1, -1, -1, -1, -1,
-		6, 4, 8, 11, 6, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		7, 10, 6, 7, 8, 10, 8, 9, 10, -1, -1, -1, -1, -1, -1, -1,
-		0, 7, 3, 0, 10, 7, 0, 9, 10, 6, 7, 10, -1, -1, -1, -1,
-		10, 6, 7, 1, 10, 7, 1, 7, 8, 1, 8, 0, -1, -1, -1, -1,
-		10, 6, 7, 10, 7, 1, 1, 7, 3, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 6, 1, 6, 8, 1, 8, 9, 8, 6, 7, -1, -1, -1, -1,
-		2, 6, 9, 2, 9, 1, 6, 7, 9, 0, 9, 3, 7, 3, 9, -1,
-		7, 8, 0, 7, 0, 6, 6, 0, 2, -1, -1, -1, -1, -1, -1, -1,
-		7, 3, 2, 6, 7, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		2, 3, 11, 10, 6, 8, 10, 8, 9, 8, 6, 7, -1, -1, -1, -1,
-		2, 0, 7, 2, 7, 11, 0, 9, 7, 6, 7, 10, 9, 10, 7, -1,
-		1, 8, 0, 1, 7, 8, 1, 10, 7, 6, 7, 10, 2, 3, 11, -1,
-		11, 2, 1, 11, 1, 7, 10, 6, 1, 6, 7, 1, -1, -1, -1, -1,
-		8, 9, 6, 8, 6, 7, 9, 1, 6, 11, 6, 3, 1, 3, 6, -1,
-		0, 9, 1, 11, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		7, 8, 0, 7, 0, 6, 3, 11, 0, 11, 6, 0, -1, -1, -1, -1,
-		7, 11, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 0, 8, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 1, 9, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		8, 1, 9, 8, 3, 1, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1,
-		10, 1, 2, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, 3, 0, 8, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1,
-		2, 9, 0, 2, 10, 9, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1,
-		6, 11, 7, 2, 10, 3, 10, 8, 3, 10, 9, 8, -1, -1, -1, -1,
-		7, 2, 3, 6, 2, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		7, 0, 8, 7, 6, 0, 6, 2, 0, -1, -1, -1, -1, -1, -1, -1,
-		2, 7, 6, 2, 3, 7, 0, 1, 9, -1, -1, -1, -1, -1, -1, -1,
-		1, 6, 2, 1, 8, 6, 1, 9, 8, 8, 7, 6, -1, -1, -1, -1,
-		10, 7, 6, 10, 1, 7, 1, 3, 7, -1, -1, -1, -1, -1, -1, -1,
-		10, 7, 6, 1, 7, 10, 1, 8, 7, 1, 0, 8, -1, -1, -1, -1,
-		0, 3, 7, 0, 7, 10, 0, 10, 9, 6, 10, 7, -1, -1, -1, -1,
-		7, 6, 10, 7, 10, 8, 8, 10, 9, -1, -1, -1, -1, -1, -1, -1,
-		6, 8, 4, 11, 8, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 6, 11, 3, 0, 6, 0, 4, 6, -1, -1, -1, -1, -1, -1, -1,
-		8, 6, 11, 8, 4, 6, 9, 0, 1, -1, -1, -1, -1, -1, -1, -1,
-		9, 4, 6, 9, 6, 3, 9, 3, 1, 11, 3, 6, -1, -1, -1, -1,
-		6, 8, 4, 6, 11, 8, 2, 10, 1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, 3, 0, 11, 0, 6, 11, 0, 4, 6, -1, -1, -1, -1,
-		4, 11, 8, 4, 6, 11, 0, 2, 9, 2, 10, 9, -1, -1, -1, -1,
-		10, 9, 3, 10, 3, 2, 9, 4, 3, 11, 3, 6, 4, 6, 3, -1,
-		8, 2, 3, 8, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1,
-		0, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 9, 0, 2, 3, 4, 2, 4, 6, 4, 3, 8, -1, -1, -1, -1,
-		1, 9, 4, 1, 4, 2, 2, 4, 6, -1, -1, -1, -1, -1, -1, -1,
-		8, 1, 3, 8, 6, 1, 8, 4, 6, 6, 10, 1, -1, -1, -1, -1,
-		10, 1, 0, 10, 0, 6, 6, 0, 4, -1, -1, -1, -1, -1, -1, -1,
-		4, 6, 3, 4, 3, 8, 6, 10, 3, 0, 3, 9, 10, 9, 3, -1,
-		10, 9, 4, 6, 10, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 9, 5, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, 4, 9, 5, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1,
-		5, 0, 1, 5, 4, 0, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1,
-		11, 7, 6, 8, 3, 4, 3, 5, 4, 3, 1, 5, -1, -1, -1, -1,
-		9, 5, 4, 10, 1, 2, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1,
-		6, 11, 7, 1, 2, 10, 0, 8, 3, 4, 9, 5, -1, -1, -1, -1,
-		7, 6, 11, 5, 4, 10, 4, 2, 10, 4, 0, 2, -1, -1, -1, -1,
-		3, 4, 8, 3, 5, 4, 3, 2, 5, 10, 5, 2, 11, 7, 6, -1,
-		7, 2, 3, 7, 6, 2, 5, 4, 9, -1, -1, -1, -1, -1, -1, -1,
-		9, 5, 4, 0, 8, 6, 0, 6, 2, 6, 8, 7, -1, -1, -1, -1,
-		3, 6, 2, 3, 7, 6, 1, 5, 0, 5, 4, 0, -1, -1, -1, -1,
-		6, 2, 8, 6, 8, 7, 2, 1, 8, 4, 8, 5, 1, 5, 8, -1,
-		9, 5, 4, 10, 1, 6, 1, 7, 6, 1, 3, 7, -1, -1, -1, -1,
-		1, 6, 10, 1, 7, 6, 1, 0, 7, 8, 7, 0, 9, 5, 4, -1,
-		4, 0, 10, 4, 10, 5, 0, 3, 10, 6, 10, 7, 3, 7, 10, -1,
-		7, 6, 10, 7, 10, 8, 5, 4, 10, 4, 8, 10, -1, -1, -1, -1,
-		6, 9, 5, 6, 11, 9, 11, 8, 9, -1, -1, -1, -1, -1, -1, -1,
-		3, 6, 11, 0, 6, 3, 0, 5, 6, 0, 9, 5, -1, -1, -1, -1,
-		0, 11, 8, 0, 5, 11, 0, 1, 5, 5, 6, 11, -1, -1, -1, -1,
-		6, 11, 3, 6, 3, 5, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, 9, 5, 11, 9, 11, 8, 11, 5, 6, -1, -1, -1, -1,
-		0, 11, 3, 0, 6, 11, 0, 9, 6, 5, 6, 9, 1, 2, 10, -1,
-		11, 8, 5, 11, 5, 6, 8, 0, 5, 10, 5, 2, 0, 2, 5, -1,
-		6, 11, 3, 6, 3, 5, 2, 10, 3, 10, 5, 3, -1, -1, -1, -1,
-		5, 8, 9, 5, 2, 8, 5, 6, 2, 3, 8, 2, -1, -1, -1, -1,
-		9, 5, 6, 9, 6, 0, 0, 6, 2, -1, -1, -1, -1, -1, -1, -1,
-		1, 5, 8, 1, 8, 0, 5, 6, 8, 3, 8, 2, 6, 2, 8, -1,
-		1, 5, 6, 2, 1, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 3, 6, 1, 6, 10, 3, 8, 6, 5, 6, 9, 8, 9, 6, -1,
-		10, 1, 0, 10, 0, 6, 9, 5, 0, 5, 6, 0, -1, -1, -1, -1,
-		0, 3, 8, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		10, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		11, 5, 10, 7, 5, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		11, 5, 10, 11, 7, 5, 8, 3, 0, -1, -1, -1, -1, -1, -1, -1,
-		5, 11, 7, 5, 10, 11, 1, 9, 0, -1, -1, -1, -1, -1, -1, -1,
-		10, 7, 5, 10, 11, 7, 9, 8, 1, 8, 3, 1, -1, -1, -1, -1,
-		11, 1, 2, 11, 7, 1, 7, 5, 1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, 1, 2, 7, 1, 7, 5, 7, 2, 11, -1, -1, -1, -1,
-		9, 7, 5, 9, 2, 7, 9, 0, 2, 2, 11, 7, -1, -1, -1, -1,
-		7, 5, 2, 7, 2, 11, 5, 9, 2, 3, 2, 8, 9, 8, 2, -1,
-		2, 5, 10, 2, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1,
-		8, 2, 0, 8, 5, 2, 8, 7, 5, 10, 2, 5, -1, -1, -1, -1,
-		9, 0, 1, 5, 10, 3, 5, 3, 7, 3, 10, 2, -1, -1, -1, -1,
-		9, 8, 2, 9, 2, 1, 8, 7, 2, 10, 2, 5, 7, 5, 2, -1,
-		1, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 7, 0, 7, 1, 1, 7, 5, -1, -1, -1, -1, -1, -1, -1,
-		9, 0, 3, 9, 3, 5, 5, 3, 7, -1, -1, -1, -1, -1, -1, -1,
-		9, 8, 7, 5, 9, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		5, 8, 4, 5, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1,
-		5, 0, 4, 5, 11, 0, 5, 10, 11, 11, 3, 0, -1, -1, -1, -1,
-		0, 1, 9, 8, 4, 10, 8, 10, 11, 10, 4, 5, -1, -1, -1, -1,
-		10, 11, 4, 10, 4, 5, 11, 3, 4, 9, 4, 1, 3, 1, 4, -1,
-		2, 5, 1, 2, 8, 5, 2, 11, 8, 4, 5, 8, -1, -1, -1, -1,
-		0, 4, 11, 0, 11, 3, 4, 5, 11, 2, 11, 1, 5, 1, 11, -1,
-		0, 2, 5, 0, 5, 9, 2, 11, 5, 4, 5, 8, 11, 8, 5, -1,
-		9, 4, 5, 2, 11, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		2, 5, 10, 3, 5, 2, 3, 4, 5, 3, 8, 4, -1, -1, -1, -1,
-		5, 10, 2, 5, 2, 4, 4, 2, 0, -1, -1, -1, -1, -1, -1, -1,
-		3, 10, 2, 3, 5, 10, 3, 8, 5, 4, 5, 8, 0, 1, 9, -1,
-		5, 10, 2, 5, 2, 4, 1, 9, 2, 9, 4, 2, -1, -1, -1, -1,
-		8, 4, 5, 8, 5, 3, 3, 5, 1, -1, -1, -1, -1, -1, -1, -1,
-		0, 4, 5, 1, 0, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		8, 4, 5, 8, 5, 3, 9, 0, 5, 0, 3, 5, -1, -1, -1, -1,
-		9, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 11, 7, 4, 9, 11, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, 4, 9, 7, 9, 11, 7, 9, 10, 11, -1, -1, -1, -1,
-		1, 10, 11, 1, 11, 4, 1, 4, 0, 7, 4, 11, -1, -1, -1, -1,
-		3, 1, 4, 3, 4, 8, 1, 10, 4, 7, 4, 11, 10, 11, 4, -1,
-		4, 11, 7, 9, 11, 4, 9, 2, 11, 9, 1, 2, -1, -1, -1, -1,
-		9, 7, 4, 9, 11, 7, 9, 1, 11, 2, 11, 1, 0, 8, 3, -1,
-		11, 7, 4, 11, 4, 2, 2, 4, 0, -1, -1, -1, -1, -1, -1, -1,
-		11, 7, 4, 11, 4, 2, 8, 3, 4, 3, 2, 4, -1, -1, -1, -1,
-		2, 9, 10, 2, 7, 9, 2, 3, 7, 7, 4, 9, -1, -1, -1, -1,
-		9, 10, 7, 9, 7, 4, 10, 2, 7, 8, 7, 0, 2, 0, 7, -1,
-		3, 7, 10, 3, 10, 2, 7, 4, 10, 1, 10, 0, 4, 0, 10, -1,
-		1, 10, 2, 8, 7, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 9, 1, 4, 1, 7, 7, 1, 3, -1, -1, -1, -1, -1, -1, -1,
-		4, 9, 1, 4, 1, 7, 0, 8, 1, 8, 7, 1, -1, -1, -1, -1,
-		4, 0, 3, 7, 4, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 0, 9, 3, 9, 11, 11, 9, 10, -1, -1, -1, -1, -1, -1, -1,
-		0, 1, 10, 0, 10, 8, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1,
-		3, 1, 10, 11, 3, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 11, 1, 11, 9, 9, 11, 8, -1, -1, -1, -1, -1, -1, -1,
-		3, 0, 9, 3, 9, 11, 1, 2, 9, 2, 11, 9, -1, -1, -1, -1,
-		0, 2, 11, 8, 0, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		2, 3, 8, 2, 8, 10, 10, 8, 9, -1, -1, -1, -1, -1, -1, -1,
-		9, 10, 2, 0, 9, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		2, 3, 8, 2, 8, 10, 0, 1, 8, 1, 10, 8, -1, -1, -1, -1,
-		1, 10, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 3, 8, 9, 1, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 9, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };	
 	}
 
 	void PrintNumTrisTable() {
@@ -614,271 +288,27 @@ namespace Core {
 		std::cout << "\n};\n";
 	}
 
+	//One entry of the chunk table of a marching cubes batch, same layout as the Chunk struct of the .comp files. The bases are in
+	//floats of the batch vertex and normal ranges, uints of the index range and uints of the draw command range.
+	struct MarchingCubesChunk {
+		glm::vec4 offset;
+		glm::uvec4 bases;
+	};
+
+	//Zero work groups of 1 by chunkCount, then zero items in every chunk
+	void ResetAppendCounters(AppendBuffer& ab) {
+		std::vector<uint32_t> reset(4 + ab.chunkCount, 0);
+		reset[1] = (uint32_t)ab.chunkCount;
+		reset[2] = 1;
+		GetScratchArena().Write(ab.counterRange, reset.data(), reset.size() * sizeof(uint32_t));
+	}
+
 	inline GLuint GetTriTableSSBO() {
 		static GLuint handle = 0; // This exists exactly once in the binary
 		if (handle == 0) {
-			// Define the table locally or as a const in the header
-			const int table[256 * 16] = {
-		 -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 1, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 8, 3, 9, 8, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 2, 10, 0, 2, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		2, 8, 3, 2, 10, 8, 10, 9, 8, -1, -1, -1, -1, -1, -1, -1,
-		3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 11, 2, 8, 11, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 9, 0, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 11, 2, 1, 9, 11, 9, 8, 11, -1, -1, -1, -1, -1, -1, -1,
-		3, 10, 1, 11, 10, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 10, 1, 0, 8, 10, 8, 11, 10, -1, -1, -1, -1, -1, -1, -1,
-		3, 9, 0, 3, 11, 9, 11, 10, 9, -1, -1, -1, -1, -1, -1, -1,
-		9, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 3, 0, 7, 3, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 1, 9, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 1, 9, 4, 7, 1, 7, 3, 1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 4, 7, 3, 0, 4, 1, 2, 10, -1, -1, -1, -1, -1, -1, -1,
-		9, 2, 10, 9, 0, 2, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1,
-		2, 10, 9, 2, 9, 7, 2, 7, 3, 7, 9, 4, -1, -1, -1, -1,
-		8, 4, 7, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		11, 4, 7, 11, 2, 4, 2, 0, 4, -1, -1, -1, -1, -1, -1, -1,
-		9, 0, 1, 8, 4, 7, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1,
-		4, 7, 11, 9, 4, 11, 9, 11, 2, 9, 2, 1, -1, -1, -1, -1,
-		3, 10, 1, 3, 11, 10, 7, 8, 4, -1, -1, -1, -1, -1, -1, -1,
-		1, 11, 10, 1, 4, 11, 1, 0, 4, 7, 11, 4, -1, -1, -1, -1,
-		4, 7, 8, 9, 0, 11, 9, 11, 10, 11, 0, 3, -1, -1, -1, -1,
-		4, 7, 11, 4, 11, 9, 9, 11, 10, -1, -1, -1, -1, -1, -1, -1,
-		9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 5, 4, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 5, 4, 1, 5, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		8, 5, 4, 8, 3, 5, 3, 1, 5, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 0, 8, 1, 2, 10, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1,
-		5, 2, 10, 5, 4, 2, 4, 0, 2, -1, -1, -1, -1, -1, -1, -1,
-		2, 10, 5, 3, 2, 5, 3, 5, 4, 3, 4, 8, -1, -1, -1, -1,
-		9, 5, 4, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 11, 2, 0, 8, 11, 4, 9, 5, -1, -1, -1, -1, -1, -1, -1,
-		0, 5, 4, 0, 1, 5, 2, 3, 11, -1, -1, -1, -1, -1, -1, -1,
-		2, 1, 5, 2, 5, 8, 2, 8, 11, 4, 8, 5, -1, -1, -1, -1,
-		10, 3, 11, 10, 1, 3, 9, 5, 4, -1, -1, -1, -1, -1, -1, -1,
-		4, 9, 5, 0, 8, 1, 8, 10, 1, 8, 11, 10, -1, -1, -1, -1,
-		5, 4, 0, 5, 0, 11, 5, 11, 10, 11, 0, 3, -1, -1, -1, -1,
-		5, 4, 8, 5, 8, 10, 10, 8, 11, -1, -1, -1, -1, -1, -1, -1,
-		9, 7, 8, 5, 7, 9, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 3, 0, 9, 5, 3, 5, 7, 3, -1, -1, -1, -1, -1, -1, -1,
-		0, 7, 8, 0, 1, 7, 1, 5, 7, -1, -1, -1, -1, -1, -1, -1,
-		1, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 7, 8, 9, 5, 7, 10, 1, 2, -1, -1, -1, -1, -1, -1, -1,
-		10, 1, 2, 9, 5, 0, 5, 3, 0, 5, 7, 3, -1, -1, -1, -1,
-		8, 0, 2, 8, 2, 5, 8, 5, 7, 10, 5, 2, -1, -1, -1, -1,
-		2, 10, 5, 2, 5, 3, 3, 5, 7, -1, -1, -1, -1, -1, -1, -1,
-		7, 9, 5, 7, 8, 9, 3, 11, 2, -1, -1, -1, -1, -1, -1, -1,
-		9, 5, 7, 9, 7, 2, 9, 2, 0, 2, 7, 11, -1, -1, -1, -1,
-		2, 3, 11, 0, 1, 8, 1, 7, 8, 1, 5, 7, -1, -1, -1, -1,
-		11, 2, 1, 11, 1, 7, 7, 1, 5, -1, -1, -1, -1, -1, -1, -1,
-		9, 5, 8, 8, 5, 7, 10, 1, 3, 10, 3, 11, -1, -1, -1, -1,
-		5, 7, 0, 5, 0, 9, 7, 11, 0, 1, 0, 10, 11, 10, 0, -1,
-		11, 10, 0, 11, 0, 3, 10, 5, 0, 8, 0, 7, 5, 7, 0, -1,
-		11, 10, 5, 7, 11, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 0, 1, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 8, 3, 1, 9, 8, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1,
-		1, 6, 5, 2, 6, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 6, 5, 1, 2, 6, 3, 0, 8, -1, -1, -1, -1, -1, -1, -1,
-		9, 6, 5, 9, 0, 6, 0, 2, 6, -1, -1, -1, -1, -1, -1, -1,
-		5, 9, 8, 5, 8, 2, 5, 2, 6, 3, 2, 8, -1, -1, -1, -1,
-		2, 3, 11, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		11, 0, 8, 11, 2, 0, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1,
-		0, 1, 9, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1, -1, -1, -1,
-		5, 10, 6, 1, 9, 2, 9, 11, 2, 9, 8, 11, -1, -1, -1, -1,
-		6, 3, 11, 6, 5, 3, 5, 1, 3, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 11, 0, 11, 5, 0, 5, 1, 5, 11, 6, -1, -1, -1, -1,
-		3, 11, 6, 0, 3, 6, 0, 6, 5, 0, 5, 9, -1, -1, -1, -1,
-		6, 5, 9, 6, 9, 11, 11, 9, 8, -1, -1, -1, -1, -1, -1, -1,
-		5, 10, 6, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 3, 0, 4, 7, 3, 6, 5, 10, -1, -1, -1, -1, -1, -1, -1,
-		1, 9, 0, 5, 10, 6, 8, 4, 7, -1, -1, -1, -1, -1, -1, -1,
-		10, 6, 5, 1, 9, 7, 1, 7, 3, 7, 9, 4, -1, -1, -1, -1,
-		6, 1, 2, 6, 5, 1, 4, 7, 8, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 5, 5, 2, 6, 3, 0, 4, 3, 4, 7, -1, -1, -1, -1,
-		8, 4, 7, 9, 0, 5, 0, 6, 5, 0, 2, 6, -1, -1, -1, -1,
-		7, 3, 9, 7, 9, 4, 3, 2, 9, 5, 9, 6, 2, 6, 9, -1,
-		3, 11, 2, 7, 8, 4, 10, 6, 5, -1, -1, -1, -1, -1, -1, -1,
-		5, 10, 6, 4, 7, 2, 4, 2, 0, 2, 7, 11, -1, -1, -1, -1,
-		0, 1, 9, 4, 7, 8, 2, 3, 11, 5, 10, 6, -1, -1, -1, -1,
-		9, 2, 1, 9, 11, 2, 9, 4, 11, 7, 11, 4, 5, 10, 6, -1,
-		8, 4, 7, 3, 11, 5, 3, 5, 1, 5, 11, 6, -1, -1, -1, -1,
-		5, 1, 11, 5, 11, 6, 1, 0, 11, 7, 11, 4, 0, 4, 11, -1,
-		0, 5, 9, 0, 6, 5, 0, 3, 6, 11, 6, 3, 8, 4, 7, -1,
-		6, 5, 9, 6, 9, 11, 4, 7, 9, 7, 11, 9, -1, -1, -1, -1,
-		10, 4, 9, 6, 4, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 10, 6, 4, 9, 10, 0, 8, 3, -1, -1, -1, -1, -1, -1, -1,
-		10, 0, 1, 10, 6, 0, 6, 4, 0, -1, -1, -1, -1, -1, -1, -1,
-		8, 3, 1, 8, 1, 6, 8, 6, 4, 6, 1, 10, -1, -1, -1, -1,
-		1, 4, 9, 1, 2, 4, 2, 6, 4, -1, -1, -1, -1, -1, -1, -1,
-		3, 0, 8, 1, 2, 9, 2, 4, 9, 2, 6, 4, -1, -1, -1, -1,
-		0, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		8, 3, 2, 8, 2, 4, 4, 2, 6, -1, -1, -1, -1, -1, -1, -1,
-		10, 4, 9, 10, 6, 4, 11, 2, 3, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 2, 2, 8, 11, 4, 9, 10, 4, 10, 6, -1, -1, -1, -1,
-		3, 11, 2, 0, 1, 6, 0, 6, 4, 6, 1, 10, -1, -1, -1, -1,
-		6, 4, 1, 6, 1, 10, 4, 8, 1, 2, 1, 11, 8, 11, 1, -1,
-		9, 6, 4, 9, 3, 6, 9, 1, 3, 11, 6, 3, -1, -1, -1, -1,
-		8, 11, 1, 8, 1, 0, 11, 6, 1, 9, 1, 4, 6, 4, 1, -1,
-		3, 11, 6, 3, 6, 0, 0, 6, 4, -1, -1, -1, -1, -1, -1, -1,
-		6, 4, 8, 11, 6, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		7, 10, 6, 7, 8, 10, 8, 9, 10, -1, -1, -1, -1, -1, -1, -1,
-		0, 7, 3, 0, 10, 7, 0, 9, 10, 6, 7, 10, -1, -1, -1, -1,
-		10, 6, 7, 1, 10, 7, 1, 7, 8, 1, 8, 0, -1, -1, -1, -1,
-		10, 6, 7, 10, 7, 1, 1, 7, 3, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 6, 1, 6, 8, 1, 8, 9, 8, 6, 7, -1, -1, -1, -1,
-		2, 6, 9, 2, 9, 1, 6, 7, 9, 0, 9, 3, 7, 3, 9, -1,
-		7, 8, 0, 7, 0, 6, 6, 0, 2, -1, -1, -1, -1, -1, -1, -1,
-		7, 3, 2, 6, 7, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		2, 3, 11, 10, 6, 8, 10, 8, 9, 8, 6, 7, -1, -1, -1, -1,
-		2, 0, 7, 2, 7, 11, 0, 9, 7, 6, 7, 10, 9, 10, 7, -1,
-		1, 8, 0, 1, 7, 8, 1, 10, 7, 6, 7, 10, 2, 3, 11, -1,
-		11, 2, 1, 11, 1, 7, 10, 6, 1, 6, 7, 1, -1, -1, -1, -1,
-		8, 9, 6, 8, 6, 7, 9, 1, 6, 11, 6, 3, 1, 3, 6, -1,
-		0, 9, 1, 11, 6, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		7, 8, 0, 7, 0, 6, 3, 11, 0, 11, 6, 0, -1, -1, -1, -1,
-		7, 11, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 0, 8, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 1, 9, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		8, 1, 9, 8, 3, 1, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1,
-		10, 1, 2, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, 3, 0, 8, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1,
-		2, 9, 0, 2, 10, 9, 6, 11, 7, -1, -1, -1, -1, -1, -1, -1,
-		6, 11, 7, 2, 10, 3, 10, 8, 3, 10, 9, 8, -1, -1, -1, -1,
-		7, 2, 3, 6, 2, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		7, 0, 8, 7, 6, 0, 6, 2, 0, -1, -1, -1, -1, -1, -1, -1,
-		2, 7, 6, 2, 3, 7, 0, 1, 9, -1, -1, -1, -1, -1, -1, -1,
-		1, 6, 2, 1, 8, 6, 1, 9, 8, 8, 7, 6, -1, -1, -1, -1,
-		10, 7, 6, 10, 1, 7, 1, 3, 7, -1, -1, -1, -1, -1, -1, -1,
-		10, 7, 6, 1, 7, 10, 1, 8, 7, 1, 0, 8, -1, -1, -1, -1,
-		0, 3, 7, 0, 7, 10, 0, 10, 9, 6, 10, 7, -1, -1, -1, -1,
-		7, 6, 10, 7, 10, 8, 8, 10, 9, -1, -1, -1, -1, -1, -1, -1,
-		6, 8, 4, 11, 8, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 6, 11, 3, 0, 6, 0, 4, 6, -1, -1, -1, -1, -1, -1, -1,
-		8, 6, 11, 8, 4, 6, 9, 0, 1, -1, -1, -1, -1, -1, -1, -1,
-		9, 4, 6, 9, 6, 3, 9, 3, 1, 11, 3, 6, -1, -1, -1, -1,
-		6, 8, 4, 6, 11, 8, 2, 10, 1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, 3, 0, 11, 0, 6, 11, 0, 4, 6, -1, -1, -1, -1,
-		4, 11, 8, 4, 6, 11, 0, 2, 9, 2, 10, 9, -1, -1, -1, -1,
-		10, 9, 3, 10, 3, 2, 9, 4, 3, 11, 3, 6, 4, 6, 3, -1,
-		8, 2, 3, 8, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1,
-		0, 4, 2, 4, 6, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 9, 0, 2, 3, 4, 2, 4, 6, 4, 3, 8, -1, -1, -1, -1,
-		1, 9, 4, 1, 4, 2, 2, 4, 6, -1, -1, -1, -1, -1, -1, -1,
-		8, 1, 3, 8, 6, 1, 8, 4, 6, 6, 10, 1, -1, -1, -1, -1,
-		10, 1, 0, 10, 0, 6, 6, 0, 4, -1, -1, -1, -1, -1, -1, -1,
-		4, 6, 3, 4, 3, 8, 6, 10, 3, 0, 3, 9, 10, 9, 3, -1,
-		10, 9, 4, 6, 10, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 9, 5, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, 4, 9, 5, 11, 7, 6, -1, -1, -1, -1, -1, -1, -1,
-		5, 0, 1, 5, 4, 0, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1,
-		11, 7, 6, 8, 3, 4, 3, 5, 4, 3, 1, 5, -1, -1, -1, -1,
-		9, 5, 4, 10, 1, 2, 7, 6, 11, -1, -1, -1, -1, -1, -1, -1,
-		6, 11, 7, 1, 2, 10, 0, 8, 3, 4, 9, 5, -1, -1, -1, -1,
-		7, 6, 11, 5, 4, 10, 4, 2, 10, 4, 0, 2, -1, -1, -1, -1,
-		3, 4, 8, 3, 5, 4, 3, 2, 5, 10, 5, 2, 11, 7, 6, -1,
-		7, 2, 3, 7, 6, 2, 5, 4, 9, -1, -1, -1, -1, -1, -1, -1,
-		9, 5, 4, 0, 8, 6, 0, 6, 2, 6, 8, 7, -1, -1, -1, -1,
-		3, 6, 2, 3, 7, 6, 1, 5, 0, 5, 4, 0, -1, -1, -1, -1,
-		6, 2, 8, 6, 8, 7, 2, 1, 8, 4, 8, 5, 1, 5, 8, -1,
-		9, 5, 4, 10, 1, 6, 1, 7, 6, 1, 3, 7, -1, -1, -1, -1,
-		1, 6, 10, 1, 7, 6, 1, 0, 7, 8, 7, 0, 9, 5, 4, -1,
-		4, 0, 10, 4, 10, 5, 0, 3, 10, 6, 10, 7, 3, 7, 10, -1,
-		7, 6, 10, 7, 10, 8, 5, 4, 10, 4, 8, 10, -1, -1, -1, -1,
-		6, 9, 5, 6, 11, 9, 11, 8, 9, -1, -1, -1, -1, -1, -1, -1,
-		3, 6, 11, 0, 6, 3, 0, 5, 6, 0, 9, 5, -1, -1, -1, -1,
-		0, 11, 8, 0, 5, 11, 0, 1, 5, 5, 6, 11, -1, -1, -1, -1,
-		6, 11, 3, 6, 3, 5, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 10, 9, 5, 11, 9, 11, 8, 11, 5, 6, -1, -1, -1, -1,
-		0, 11, 3, 0, 6, 11, 0, 9, 6, 5, 6, 9, 1, 2, 10, -1,
-		11, 8, 5, 11, 5, 6, 8, 0, 5, 10, 5, 2, 0, 2, 5, -1,
-		6, 11, 3, 6, 3, 5, 2, 10, 3, 10, 5, 3, -1, -1, -1, -1,
-		5, 8, 9, 5, 2, 8, 5, 6, 2, 3, 8, 2, -1, -1, -1, -1,
-		9, 5, 6, 9, 6, 0, 0, 6, 2, -1, -1, -1, -1, -1, -1, -1,
-		1, 5, 8, 1, 8, 0, 5, 6, 8, 3, 8, 2, 6, 2, 8, -1,
-		1, 5, 6, 2, 1, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 3, 6, 1, 6, 10, 3, 8, 6, 5, 6, 9, 8, 9, 6, -1,
-		10, 1, 0, 10, 0, 6, 9, 5, 0, 5, 6, 0, -1, -1, -1, -1,
-		0, 3, 8, 5, 6, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		10, 5, 6, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		11, 5, 10, 7, 5, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		11, 5, 10, 11, 7, 5, 8, 3, 0, -1, -1, -1, -1, -1, -1, -1,
-		5, 11, 7, 5, 10, 11, 1, 9, 0, -1, -1, -1, -1, -1, -1, -1,
-		10, 7, 5, 10, 11, 7, 9, 8, 1, 8, 3, 1, -1, -1, -1, -1,
-		11, 1, 2, 11, 7, 1, 7, 5, 1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, 1, 2, 7, 1, 7, 5, 7, 2, 11, -1, -1, -1, -1,
-		9, 7, 5, 9, 2, 7, 9, 0, 2, 2, 11, 7, -1, -1, -1, -1,
-		7, 5, 2, 7, 2, 11, 5, 9, 2, 3, 2, 8, 9, 8, 2, -1,
-		2, 5, 10, 2, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1,
-		8, 2, 0, 8, 5, 2, 8, 7, 5, 10, 2, 5, -1, -1, -1, -1,
-		9, 0, 1, 5, 10, 3, 5, 3, 7, 3, 10, 2, -1, -1, -1, -1,
-		9, 8, 2, 9, 2, 1, 8, 7, 2, 10, 2, 5, 7, 5, 2, -1,
-		1, 3, 5, 3, 7, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 7, 0, 7, 1, 1, 7, 5, -1, -1, -1, -1, -1, -1, -1,
-		9, 0, 3, 9, 3, 5, 5, 3, 7, -1, -1, -1, -1, -1, -1, -1,
-		9, 8, 7, 5, 9, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		5, 8, 4, 5, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1,
-		5, 0, 4, 5, 11, 0, 5, 10, 11, 11, 3, 0, -1, -1, -1, -1,
-		0, 1, 9, 8, 4, 10, 8, 10, 11, 10, 4, 5, -1, -1, -1, -1,
-		10, 11, 4, 10, 4, 5, 11, 3, 4, 9, 4, 1, 3, 1, 4, -1,
-		2, 5, 1, 2, 8, 5, 2, 11, 8, 4, 5, 8, -1, -1, -1, -1,
-		0, 4, 11, 0, 11, 3, 4, 5, 11, 2, 11, 1, 5, 1, 11, -1,
-		0, 2, 5, 0, 5, 9, 2, 11, 5, 4, 5, 8, 11, 8, 5, -1,
-		9, 4, 5, 2, 11, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		2, 5, 10, 3, 5, 2, 3, 4, 5, 3, 8, 4, -1, -1, -1, -1,
-		5, 10, 2, 5, 2, 4, 4, 2, 0, -1, -1, -1, -1, -1, -1, -1,
-		3, 10, 2, 3, 5, 10, 3, 8, 5, 4, 5, 8, 0, 1, 9, -1,
-		5, 10, 2, 5, 2, 4, 1, 9, 2, 9, 4, 2, -1, -1, -1, -1,
-		8, 4, 5, 8, 5, 3, 3, 5, 1, -1, -1, -1, -1, -1, -1, -1,
-		0, 4, 5, 1, 0, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		8, 4, 5, 8, 5, 3, 9, 0, 5, 0, 3, 5, -1, -1, -1, -1,
-		9, 4, 5, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 11, 7, 4, 9, 11, 9, 10, 11, -1, -1, -1, -1, -1, -1, -1,
-		0, 8, 3, 4, 9, 7, 9, 11, 7, 9, 10, 11, -1, -1, -1, -1,
-		1, 10, 11, 1, 11, 4, 1, 4, 0, 7, 4, 11, -1, -1, -1, -1,
-		3, 1, 4, 3, 4, 8, 1, 10, 4, 7, 4, 11, 10, 11, 4, -1,
-		4, 11, 7, 9, 11, 4, 9, 2, 11, 9, 1, 2, -1, -1, -1, -1,
-		9, 7, 4, 9, 11, 7, 9, 1, 11, 2, 11, 1, 0, 8, 3, -1,
-		11, 7, 4, 11, 4, 2, 2, 4, 0, -1, -1, -1, -1, -1, -1, -1,
-		11, 7, 4, 11, 4, 2, 8, 3, 4, 3, 2, 4, -1, -1, -1, -1,
-		2, 9, 10, 2, 7, 9, 2, 3, 7, 7, 4, 9, -1, -1, -1, -1,
-		9, 10, 7, 9, 7, 4, 10, 2, 7, 8, 7, 0, 2, 0, 7, -1,
-		3, 7, 10, 3, 10, 2, 7, 4, 10, 1, 10, 0, 4, 0, 10, -1,
-		1, 10, 2, 8, 7, 4, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 9, 1, 4, 1, 7, 7, 1, 3, -1, -1, -1, -1, -1, -1, -1,
-		4, 9, 1, 4, 1, 7, 0, 8, 1, 8, 7, 1, -1, -1, -1, -1,
-		4, 0, 3, 7, 4, 3, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		4, 8, 7, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		9, 10, 8, 10, 11, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 0, 9, 3, 9, 11, 11, 9, 10, -1, -1, -1, -1, -1, -1, -1,
-		0, 1, 10, 0, 10, 8, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1,
-		3, 1, 10, 11, 3, 10, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 2, 11, 1, 11, 9, 9, 11, 8, -1, -1, -1, -1, -1, -1, -1,
-		3, 0, 9, 3, 9, 11, 1, 2, 9, 2, 11, 9, -1, -1, -1, -1,
-		0, 2, 11, 8, 0, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		3, 2, 11, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		2, 3, 8, 2, 8, 10, 10, 8, 9, -1, -1, -1, -1, -1, -1, -1,
-		9, 10, 2, 0, 9, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		2, 3, 8, 2, 8, 10, 0, 1, 8, 1, 10, 8, -1, -1, -1, -1,
-		1, 10, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		1, 3, 8, 9, 1, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 9, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		0, 3, 8, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
-		-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 };
-		
 			glGenBuffers(1, &handle);
 			glBindBuffer(GL_SHADER_STORAGE_BUFFER, handle);
-			glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(table), table, GL_STATIC_DRAW);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(FlatTriTable), FlatTriTable, GL_STATIC_DRAW);
 		}
 		return handle;
 	}
@@ -886,46 +316,79 @@ namespace Core {
 	GLuint _indexInitComputeShaderProgram = 0;
 	GLuint _vertexDisplacementComputeShaderProgram = 0;
 	GLuint _normalInterpelationComputeShaderProgram = 0;
+	GLuint _heightMapChunkComputeShader = 0;
 	GLuint _3dNoiseMapComputeShader = 0;
 	GLuint _3DNoiseMapPipelineComputeShader = 0;
 	GLuint _marchingCubesSurfaceCullingComputeShader = 0;
 	GLuint _marchingCubesTriCounterComputeShader = 0;
 	GLuint _marchingCubesTriCreatorComputeShader = 0;
+	GLuint _marchingCubesIndexedVertsComputeShader = 0;
+	GLuint _marchingCubesIndexedTrisComputeShader = 0;
+	GLuint _marchingCubesPrefixSumComputeShader = 0;
 	GLuint _voxelCubesGeometryInitComputeShader = 0;
+	GLuint _voxelCubesGreedyGeometryInitComputeShader = 0;
 	GLuint _voxelCubesTriangleCounterComputeShader = 0;
 	GLuint _voxelTerrainPainterComputeShader = 0;
-	
+	//Each program is compiled from its .comp file the first time it is dispatched, its uniform locations are resolved then
+	namespace {
+		ComputePipeline _vertexInitPipeline("../Core/Source/Core/HeightMapVertexInit.comp", &_vertexInitComputeShaderProgram);
+		ComputePipeline _indexInitPipeline("../Core/Source/Core/HeightMapIndexInit.comp", &_indexInitComputeShaderProgram);
+		ComputePipeline _vertexDisplacementPipeline("../Core/Source/Core/HeightMapVertexDisplacement.comp", &_vertexDisplacementComputeShaderProgram);
+		ComputePipeline _normalInterpelationPipeline("../Core/Source/Core/HeightMapNormal.comp", &_normalInterpelationComputeShaderProgram);
+		ComputePipeline _heightMapChunkPipeline("../Core/Source/Core/HeightMapChunk.comp", &_heightMapChunkComputeShader);
+		ComputePipeline _3dNoiseMapPipeline("../Core/Source/Core/Create3DNoise.comp", &_3dNoiseMapComputeShader);
+		ComputePipeline _3DVoxelCubeNoisePipeline("../Core/Source/Core/3DVoxelCubeNoise.comp", &_3DNoiseMapPipelineComputeShader);
+		ComputePipeline _marchingCubesSurfaceCullingPipeline("../Core/Source/Core/MarchingCubesSurfaceCulling.comp", &_marchingCubesSurfaceCullingComputeShader);
+		ComputePipeline _marchingCubesTriCounterPipeline("../Core/Source/Core/MarchingCubesCountTris.comp", &_marchingCubesTriCounterComputeShader);
+		ComputePipeline _marchingCubesTriCreatorPipeline("../Core/Source/Core/MarchingCubesCreateTris.comp", &_marchingCubesTriCreatorComputeShader);
+		ComputePipeline _marchingCubesIndexedVertsPipeline("../Core/Source/Core/MarchingCubesIndexedVerts.comp", &_marchingCubesIndexedVertsComputeShader);
+		ComputePipeline _marchingCubesIndexedTrisPipeline("../Core/Source/Core/MarchingCubesIndexedTris.comp", &_marchingCubesIndexedTrisComputeShader);
+		ComputePipeline _marchingCubesPrefixSumPipeline("../Core/Source/Core/MarchingCubesPrefixSum.comp", &_marchingCubesPrefixSumComputeShader);
+		ComputePipeline _voxelCubesGeometryInitPipeline("../Core/Source/Core/VoxelCubesGeometryInit.comp", &_voxelCubesGeometryInitComputeShader);
+		ComputePipeline _voxelCubesGreedyGeometryInitPipeline("../Core/Source/Core/VoxelCubesGreedyGeometryInit.comp", &_voxelCubesGreedyGeometryInitComputeShader);
+		ComputePipeline _voxelCubesTriangleCounterPipeline("../Core/Source/Core/VoxelCubesCountTriangles.comp", &_voxelCubesTriangleCounterComputeShader);
+		ComputePipeline _voxelTerrainPainterPipeline("../Core/Source/Core/VoxelTerrainPainter.comp", &_voxelTerrainPainterComputeShader);
+		//Init calls not matched by a Cleanup yet
+		int _initCount = 0;
+	}
+	Backend _backend = Backend::GPU;
 
-	void Init() {
-		_vertexInitComputeShaderProgram = CreateComputeShaderProgram("../Core/Source/Core/HeightMapVertexInit.comp");
-		_indexInitComputeShaderProgram = CreateComputeShaderProgram("../Core/Source/Core/HeightMapIndexInit.comp");
-		_vertexDisplacementComputeShaderProgram = CreateComputeShaderProgram("../Core/Source/Core/HeightMapVertexDisplacement.comp");
-		_normalInterpelationComputeShaderProgram = CreateComputeShaderProgram("../Core/Source/Core/HeightMapNormal.comp");
-		_3dNoiseMapComputeShader = CreateComputeShaderProgram("../Core/Source/Core/Create3DNoise.comp");
-		_3DNoiseMapPipelineComputeShader = CreateComputeShaderProgram("../Core/Source/Core/3DVoxelCubeNoise.comp");
-		_marchingCubesSurfaceCullingComputeShader = CreateComputeShaderProgram("../Core/Source/Core/MarchingCubesSurfaceCulling.comp");
-		_marchingCubesTriCounterComputeShader = CreateComputeShaderProgram("../Core/Source/Core/MarchingCubesCountTris.comp");
-		_marchingCubesTriCreatorComputeShader = CreateComputeShaderProgram("../Core/Source/Core/MarchingCubesCreateTris.comp");
-		_voxelCubesGeometryInitComputeShader = CreateComputeShaderProgram("../Core/Source/Core/VoxelCubesGeometryInit.comp");
-		_voxelCubesTriangleCounterComputeShader = CreateComputeShaderProgram("../Core/Source/Core/VoxelCubesCountTriangles.comp");
-		_voxelTerrainPainterComputeShader = CreateComputeShaderProgram("../Core/Source/Core/VoxelTerrainPainter.comp");
+	void SetBackend(Backend backend) {
+		_backend = backend;
+	}
 
+	Backend GetBackend() {
+		return _backend;
 	}
 
-	void Cleanup() {
-		glDeleteProgram(_vertexInitComputeShaderProgram);
-		glDeleteProgram(_indexInitComputeShaderProgram);
-		glDeleteProgram(_vertexDisplacementComputeShaderProgram);
-		glDeleteProgram(_normalInterpelationComputeShaderProgram);
-		glDeleteProgram(_3dNoiseMapComputeShader);
-		glDeleteProgram(_3DNoiseMapPipelineComputeShader);
-		glDeleteProgram(_marchingCubesSurfaceCullingComputeShader);
-		glDeleteProgram(_marchingCubesTriCounterComputeShader);
-		glDeleteProgram(_marchingCubesTriCreatorComputeShader);
-		glDeleteProgram(_voxelCubesGeometryInitComputeShader);
-		glDeleteProgram(_voxelCubesTriangleCounterComputeShader);
-		glDeleteProgram(_voxelTerrainPainterComputeShader);
+	void Init() {
+		//Nothing is compiled up front, the programs a process never dispatches are never read from disk
+		_initCount++;
+	}
 
+	void Cleanup() {
+		if (_initCount > 0) _initCount--;
+		//Whatever the backend is now, programs compiled while it was the GPU go away. Release makes no GL call for the others.
+		if (_initCount > 0)
+			return;
+		_vertexInitPipeline.Release();
+		_indexInitPipeline.Release();
+		_vertexDisplacementPipeline.Release();
+		_normalInterpelationPipeline.Release();
+		_heightMapChunkPipeline.Release();
+		_3dNoiseMapPipeline.Release();
+		_3DVoxelCubeNoisePipeline.Release();
+		_marchingCubesSurfaceCullingPipeline.Release();
+		_marchingCubesTriCounterPipeline.Release();
+		_marchingCubesTriCreatorPipeline.Release();
+		_marchingCubesIndexedVertsPipeline.Release();
+		_marchingCubesIndexedTrisPipeline.Release();
+		_marchingCubesPrefixSumPipeline.Release();
+		_voxelCubesGeometryInitPipeline.Release();
+		_voxelCubesGreedyGeometryInitPipeline.Release();
+		_voxelCubesTriangleCounterPipeline.Release();
+		_voxelTerrainPainterPipeline.Release();
+		ReleaseProfileQueries();
 	}
 
 	std::vector<float> CreateFlat2DNoiseMap(const int width, const int height, const int depth, const glm::vec2 offset, bool CleanUp) {
@@ -941,20 +404,20 @@ namespace Core {
 		glBufferData(GL_SHADER_STORAGE_BUFFER, noiseMap.size() * sizeof(float), noiseMap.data(), GL_DYNAMIC_COPY);
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssboNoise);
 
-		GLint widthLoc = glGetUniformLocation(_vertexInitComputeShaderProgram, "width");
-		GLint heightLoc = glGetUniformLocation(_vertexInitComputeShaderProgram, "height");
-		GLint offsetLoc = glGetUniformLocation(_vertexInitComputeShaderProgram, "offset");
-
-		glUseProgram(_vertexInitComputeShaderProgram);
-
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
-		glUniform2fv(offsetLoc, 1, &offset[0]);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, 0);
+		params.gridOffset = offset;
+		_vertexInitPipeline.Bind(params);
 
 		return noiseMap;
 	}
 	std::vector<float> CreateFlat3DNoiseMap(const int width,const int height,const int depth,const glm::vec3 offset, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves, const bool useDropoff) {
+		ProfileScope scope(ProfileStage::Noise, _backend == Backend::GPU);
 		std::vector<float> noiseMap;
+		if (_backend == Backend::CPU) {
+			Cpu::CreateFlat3DNoiseMap(noiseMap, width, height, depth, offset, frequency);
+			return noiseMap;
+		}
 		int sizeOfNoiseMap = width * height * depth;
 		noiseMap.resize(sizeOfNoiseMap);
 
@@ -964,30 +427,21 @@ namespace Core {
 		glBufferData(GL_SHADER_STORAGE_BUFFER, noiseMap.size() * sizeof(float), noiseMap.data(), GL_DYNAMIC_COPY);
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssboNoise);
 
-		GLint widthLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "width");
-		GLint heightLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "height");
-		GLint depthLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "depth");
-		GLint offsetLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "offset");
-		GLint amiplitudeLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "amplitude");
-		GLint frequencyLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "frequency");
-		GLint persistanceLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "persistance");
-		GLint lacunarityLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "lacunarity");
-		GLint octavesLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "octaves");
-		GLint dropoffLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "useHeightDropoff");
-
-		glUseProgram(_3dNoiseMapComputeShader);
-
-
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
-		glUniform1i(depthLoc, depth);
-		glUniform3fv(offsetLoc, 1, &offset[0]);
-		glUniform1f(amiplitudeLoc, amplitude);
-		glUniform1f(frequencyLoc, frequency);
-		glUniform1f(persistanceLoc, persistance);
-		glUniform1f(lacunarityLoc, lacunarity);
-		glUniform1i(octavesLoc, octaves);
-		glUniform1i(dropoffLoc, useDropoff);
+		//A batch of one chunk
+		MarchingCubesChunk chunk = { glm::vec4(offset, 0.0f), glm::uvec4(0) };
+		BufferRange chunkRange = GetScratchArena().Allocate(sizeof(chunk));
+		GetScratchArena().Write(chunkRange, &chunk, sizeof(chunk));
+		BindStorageRange(1, chunkRange);
+
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, depth);
+		params.amplitude = amplitude;
+		params.frequency = frequency;
+		params.persistance = persistance;
+		params.lacunarity = lacunarity;
+		params.octaves = octaves;
+		params.useHeightDropoff = useDropoff;
+		_3dNoiseMapPipeline.Bind(params);
 
 		glDispatchCompute(
 			(GLuint)ceil(width / 8.0f),
@@ -995,7 +449,9 @@ namespace Core {
 			(GLuint)ceil(depth / 8.0f)
 		);
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+		ReleaseRange(chunkRange);
 
+		ProfileScope readbackScope(ProfileStage::Readback);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboNoise);
 		float* ptr = (float*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
 		// Copy or use data
@@ -1009,37 +465,90 @@ namespace Core {
 		glDeleteBuffers(1, &ssboNoise);
 		return noiseMap;
 	}
-	void CreateFlat3DNoiseMap(VoxelMesh& mesh, const int width, const int height, const int depth, const glm::vec3 offset, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves, const bool useDropoff) {
-		
-		int sizeOfNoiseMap = width * height * depth;
-
-		glUseProgram(_3dNoiseMapComputeShader);
+	void CreateFlat3DNoiseMap(const std::vector<VoxelMesh*>& meshes, const AppendBuffer& ab, const int width, const int height, const int depth, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves, const bool useDropoff) {
+		ProfileScope scope(ProfileStage::Noise, true);
+		if (meshes.empty()) return;
 
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mesh.densitySSBO);
+		BindStorageRanges(0, meshes.front()->densityRange, meshes.back()->densityRange);
+		BindStorageRange(1, ab.chunkRange);
 
-		GLint widthLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "width");
-		GLint heightLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "height");
-		GLint depthLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "depth");
-		GLint offsetLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "offset");
-		GLint frequencyLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "frequency");
-		GLint dropoffLoc = glGetUniformLocation(_3dNoiseMapComputeShader, "useHeightDropoff");
-
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
-		glUniform1i(depthLoc, depth);
-		glUniform3fv(offsetLoc, 1, &offset[0]);
-		glUniform1f(frequencyLoc, frequency);
-		glUniform1i(dropoffLoc, useDropoff);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, depth);
+		params.frequency = frequency;
+		params.useHeightDropoff = useDropoff;
+		_3dNoiseMapPipeline.Bind(params);
 
+		//The z work groups of every chunk follow each other
 		glDispatchCompute(
 			(GLuint)ceil(width / 8.0f),
 			(GLuint)ceil(height / 8.0f),
-			(GLuint)ceil(depth / 8.0f)
+			(GLuint)ceil(depth / 8.0f) * (GLuint)meshes.size()
 		);
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
 	}
+	namespace {
+		//Bounds of snoise(vec3) measured over millions of random points, 1.031 and 5.94, with some room. No point of a chunk is further than
+		//stride * sqrt(3) / 2 from a sample of a grid with that stride, so its density is within NoiseMaxSlope * frequency times that of the sample.
+		constexpr float NoiseMaxValue = 1.1f;
+		constexpr float NoiseMaxSlope = 7.0f;
+
+		//Range of the densities on a grid of the given stride that always includes the last sample of each axis
+		void CoarseDensityRange(int width, int height, int depth, glm::vec3 offset, float frequency, int stride, float& minDensity, float& maxDensity) {
+			auto axis = [stride](int count) {
+				std::vector<int> samples;
+				for (int i = 0; i < count - 1; i += stride) samples.push_back(i);
+				samples.push_back(count - 1);
+				return samples;
+			};
+			std::vector<int> xs = axis(width), ys = axis(height), zs = axis(depth);
+			size_t count = xs.size() * ys.size() * zs.size();
+			std::vector<float> px, py, pz, densities(count);
+			px.reserve(count);
+			py.reserve(count);
+			pz.reserve(count);
+			for (int z : zs) {
+				for (int y : ys) {
+					for (int x : xs) {
+						px.push_back((x + offset.x) * frequency);
+						py.push_back((y + offset.y) * frequency);
+						pz.push_back((z + offset.z) * frequency);
+					}
+				}
+			}
+			Cpu::SimplexNoiseBatch(px.data(), py.data(), pz.data(), densities.data(), (int)count);
+			auto [minIt, maxIt] = std::minmax_element(densities.begin(), densities.end());
+			minDensity = *minIt;
+			maxDensity = *maxIt;
+		}
+	}
+
+	ChunkOccupancy ClassifyMarchingCubesChunk(int width, int height, int depth, glm::vec3 offset, float frequency, float isoLevel) {
+		ProfileScope scope(ProfileStage::Classify);
+		if (width <= 0 || height <= 0 || depth <= 0) return ChunkOccupancy::Air;
+		//The noise never reaches an iso level outside its range
+		if (isoLevel > NoiseMaxValue) return ChunkOccupancy::Air;
+		if (isoLevel <= -NoiseMaxValue) return ChunkOccupancy::Solid;
+
+		//The finer grid only runs for chunks whose coarse samples are all on one side
+		for (int stride : { 4, 2 }) {
+			float minDensity, maxDensity;
+			CoarseDensityRange(width, height, depth, offset, frequency, stride, minDensity, maxDensity);
+			if (minDensity < isoLevel && maxDensity >= isoLevel) return ChunkOccupancy::Mixed;
+
+			float margin = NoiseMaxSlope * std::abs(frequency) * stride * 0.8660254f;
+			if (minDensity - margin >= isoLevel) return ChunkOccupancy::Solid;
+			if (maxDensity + margin < isoLevel) return ChunkOccupancy::Air;
+		}
+		return ChunkOccupancy::Mixed;
+	}
+
 	void CreateFlat3DNoiseMapPipeLine(BlockIds& blockIDs, const Spline& spline, const int width, const int height, const int depth, const glm::vec3 offset, bool CleanUp, const float frequency, const bool useDropoff) {
+		ProfileScope scope(ProfileStage::VoxelSpline, _backend == Backend::GPU);
+		if (_backend == Backend::CPU) {
+			Cpu::CreateFlat3DNoiseMapPipeLine(blockIDs, spline, width, height, depth, offset, frequency, useDropoff);
+			return;
+		}
 		int sizeOfNoiseMap = width * height * depth;
 		blockIDs.IDs.resize(sizeOfNoiseMap);
 
@@ -1055,23 +564,13 @@ namespace Core {
 		glBufferData(GL_SHADER_STORAGE_BUFFER, spline.points.size() * sizeof(glm::vec2), spline.points.data(), GL_DYNAMIC_COPY);
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ssboSplinePoints);
 
-		GLint widthLoc = glGetUniformLocation(_3DNoiseMapPipelineComputeShader, "width");
-		GLint heightLoc = glGetUniformLocation(_3DNoiseMapPipelineComputeShader, "height");
-		GLint depthLoc = glGetUniformLocation(_3DNoiseMapPipelineComputeShader, "depth");
-		GLint offsetLoc = glGetUniformLocation(_3DNoiseMapPipelineComputeShader, "offset");
-		GLint frequencyLoc = glGetUniformLocation(_3DNoiseMapPipelineComputeShader, "frequency");
-		GLint dropoffLoc = glGetUniformLocation(_3DNoiseMapPipelineComputeShader, "useHeightDropoff");
-		GLint splinePointsLoc = glGetUniformLocation(_3DNoiseMapPipelineComputeShader, "splinePointsCount");
-
-		glUseProgram(_3DNoiseMapPipelineComputeShader);
-
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
-		glUniform1i(depthLoc, depth);
-		glUniform3fv(offsetLoc, 1, &offset[0]);
-		glUniform1f(frequencyLoc, frequency);
-		glUniform1i(dropoffLoc, useDropoff);
-		glUniform1i(splinePointsLoc, (int)spline.points.size());
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, depth);
+		params.offset = offset;
+		params.frequency = frequency;
+		params.useHeightDropoff = useDropoff;
+		params.splinePointsCount = (int)spline.points.size();
+		_3DVoxelCubeNoisePipeline.Bind(params);
 
 		glDispatchCompute(
 			(GLuint)ceil(width / 8.0f),
@@ -1080,6 +579,7 @@ namespace Core {
 		);
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
+		ProfileScope readbackScope(ProfileStage::Readback);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboNoise);
 		int* ptr = (int*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
 		// Copy or use data
@@ -1095,6 +595,11 @@ namespace Core {
 		glDeleteBuffers(1, &ssboSplinePoints);
 	}
 	void TerrainPaint(BlockIds& blockIDs, int width, int height, int depth) {
+		ProfileScope scope(ProfileStage::VoxelPaint, _backend == Backend::GPU);
+		if (_backend == Backend::CPU) {
+			Cpu::TerrainPaint(blockIDs, width, height, depth);
+			return;
+		}
 
 		GLuint ssboIDs;
 		glGenBuffers(1, &ssboIDs);
@@ -1103,15 +608,9 @@ namespace Core {
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssboIDs);
 
 
-		GLint widthLoc = glGetUniformLocation(_voxelTerrainPainterComputeShader, "width");
-		GLint heightLoc = glGetUniformLocation(_voxelTerrainPainterComputeShader, "height");
-		GLint depthLoc = glGetUniformLocation(_voxelTerrainPainterComputeShader, "depth");
-
-		glUseProgram(_voxelTerrainPainterComputeShader);
-
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
-		glUniform1i(depthLoc, depth);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, depth);
+		_voxelTerrainPainterPipeline.Bind(params);
 
 		glDispatchCompute(
 			(GLuint)ceil(width / 8.0f),
@@ -1120,6 +619,7 @@ namespace Core {
 		);
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
+		ProfileScope readbackScope(ProfileStage::Readback);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboIDs);
 		int* ptr = (int*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
 		// Copy or use data
@@ -1135,6 +635,11 @@ namespace Core {
 	}
 
 	void CreateVertices(PlaneMesh& planeData, int width, int height, glm::ivec2 offset, bool CleanUp) {
+		ProfileScope scope(ProfileStage::HeightMapVertices, _backend == Backend::GPU);
+		if (_backend == Backend::CPU) {
+			Cpu::CreateVertices(planeData, width, height, offset);
+			return;
+		}
 		GLuint ssboVertices;
 		glGenBuffers(1, &ssboVertices);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboVertices);
@@ -1143,20 +648,16 @@ namespace Core {
 
 
 
-		GLint widthLoc = glGetUniformLocation(_vertexInitComputeShaderProgram, "width");
-		GLint heightLoc = glGetUniformLocation(_vertexInitComputeShaderProgram, "height");
-		GLint offsetLoc = glGetUniformLocation(_vertexInitComputeShaderProgram, "offset");
-
-		glUseProgram(_vertexInitComputeShaderProgram);
-
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
-		glUniform2iv(offsetLoc, 1, &offset[0]);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, 0);
+		params.gridOffset = offset;
+		_vertexInitPipeline.Bind(params);
 
 		glDispatchCompute((GLuint)ceil(width / 16.0f),
 			(GLuint)ceil(height / 16.0f), 1);
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
+		ProfileScope readbackScope(ProfileStage::Readback);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboVertices);
 		glm::fvec3* ptr = (glm::fvec3*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
 
@@ -1174,6 +675,11 @@ namespace Core {
 	}
 
 	void CreateIndices(PlaneMesh& planeData, int width, int height, bool CleanUp) {
+		ProfileScope scope(ProfileStage::HeightMapIndices, _backend == Backend::GPU);
+		if (_backend == Backend::CPU) {
+			Cpu::CreateIndices(planeData, width, height);
+			return;
+		}
 		GLuint ssboIndices;
 		glGenBuffers(1, &ssboIndices);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboIndices);
@@ -1182,19 +688,16 @@ namespace Core {
 
 		
 
-		GLint widthLoc = glGetUniformLocation(_indexInitComputeShaderProgram, "width");
-		GLint heightLoc = glGetUniformLocation(_indexInitComputeShaderProgram, "height");
-
-		glUseProgram(_indexInitComputeShaderProgram);
-
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, 0);
+		_indexInitPipeline.Bind(params);
 
 		GLuint numGroups = (((width) * (height)) + 63) / 64;
 		glDispatchCompute((GLuint)ceil(width / 16.0f),
 			(GLuint)ceil(height / 16.0f), 1);
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
+		ProfileScope readbackScope(ProfileStage::Readback);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboIndices);
 		int* ptr = (int*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
 
@@ -1212,6 +715,11 @@ namespace Core {
 	}
 	
 	void DisplaceVertices(PlaneMesh& planeData, int width, int height, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity, bool CleanUp) {
+		ProfileScope scope(ProfileStage::HeightMapDisplace, _backend == Backend::GPU);
+		if (_backend == Backend::CPU) {
+			Cpu::DisplaceVertices(planeData, width, height, scale, amplitude, frequency, octaves, persistance, lacunarity);
+			return;
+		}
 		GLuint ssboVertices;
 		if ((width + 1) * (height + 1) != planeData.vertices.size()) {
 			std::cout << "wrong sizes!";
@@ -1221,31 +729,22 @@ namespace Core {
 		glBufferData(GL_SHADER_STORAGE_BUFFER, planeData.vertices.size() * 3 * sizeof(float), planeData.vertices.data(), GL_DYNAMIC_COPY);
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, ssboVertices);
 
-		GLint widthLoc = glGetUniformLocation(_vertexDisplacementComputeShaderProgram, "width");
-		GLint heightLoc = glGetUniformLocation(_vertexDisplacementComputeShaderProgram, "height");
-		GLint scaleLoc = glGetUniformLocation(_vertexDisplacementComputeShaderProgram, "scale");
-		GLint amplitudeLoc = glGetUniformLocation(_vertexDisplacementComputeShaderProgram, "amplitude");
-		GLint frequencyLoc = glGetUniformLocation(_vertexDisplacementComputeShaderProgram, "frequency");
-		GLint octavesLoc = glGetUniformLocation(_vertexDisplacementComputeShaderProgram, "octaves");
-		GLint persistanceLoc = glGetUniformLocation(_vertexDisplacementComputeShaderProgram, "persistance");
-		GLint lacunarityLoc = glGetUniformLocation(_vertexDisplacementComputeShaderProgram, "lacunarity");
-
-		glUseProgram(_vertexDisplacementComputeShaderProgram);
-
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
-		glUniform1f(scaleLoc, scale);
-		glUniform1f(amplitudeLoc, amplitude);
-		glUniform1f(frequencyLoc, frequency);
-		glUniform1i(octavesLoc, octaves);
-		glUniform1f(persistanceLoc, persistance);
-		glUniform1f(lacunarityLoc, lacunarity);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, 0);
+		params.scale = scale;
+		params.amplitude = amplitude;
+		params.frequency = frequency;
+		params.octaves = octaves;
+		params.persistance = persistance;
+		params.lacunarity = lacunarity;
+		_vertexDisplacementPipeline.Bind(params);
 
 		GLuint numGroups = (((width + 1) * (height + 1)) + 63) / 64;
 		glDispatchCompute((GLuint)ceil(width / 16.0f),
 			(GLuint)ceil(height / 16.0f), 1);
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
+		ProfileScope readbackScope(ProfileStage::Readback);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboVertices);
 		glm::fvec3* ptr = (glm::fvec3*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
 
@@ -1263,7 +762,40 @@ namespace Core {
 		
 	}
 
+	void CreateHeightMapNoise(float* noise, int width, int height, glm::ivec2 offset, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity, int apron) {
+		ProfileScope scope(ProfileStage::Noise);
+		//Same vertex positions as HeightMapVertexInit.comp
+		float xScale = 100.0f / width;
+		float zScale = 100.0f / height;
+		int columns = width + 1 + 2 * apron;
+		int rows = height + 1 + 2 * apron;
+		std::vector<float> xs(columns), zs(rows);
+		for (int i = 0; i < columns; ++i) {
+			int x = i - apron;
+			xs[i] = (x * xScale + (offset.x * width) * xScale) * scale;
+		}
+		for (int i = 0; i < rows; ++i) {
+			int z = i - apron;
+			zs[i] = (z * zScale + (offset.y * height) * zScale) * scale;
+		}
+		Cpu::PNoiseGrid(noise, xs.data(), columns, zs.data(), rows, amplitude, frequency, octaves, persistance, lacunarity);
+	}
+
+	void CreateHeightMapTexture(HeightMapTexture& chunk, int width, int height, glm::ivec2 offset, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity) {
+		chunk.width = width;
+		chunk.height = height;
+		chunk.heights.resize(size_t(width + 3) * (height + 3));
+		CreateHeightMapNoise(chunk.heights.data(), width, height, offset, scale, amplitude, frequency, octaves, persistance, lacunarity, 1);
+		for (float& h : chunk.heights)
+			h *= 20.0f;
+	}
+
 	void InterpolatedNormals(PlaneMesh& planeData, int width, int height, bool CleanUp){
+		ProfileScope scope(ProfileStage::HeightMapNormals, _backend == Backend::GPU);
+		if (_backend == Backend::CPU) {
+			Cpu::InterpolatedNormals(planeData, width, height);
+			return;
+		}
 		GLuint ssboVertices, ssboNormals;
 		if ((width + 1) * (height + 1) != planeData.vertices.size()) {
 			std::cout << "wrong sizes!";
@@ -1281,19 +813,16 @@ namespace Core {
 		glBufferData(GL_SHADER_STORAGE_BUFFER, planeData.normals.size() * 3 * sizeof(float), planeData.normals.data(), GL_DYNAMIC_COPY);
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ssboNormals);
 
-		GLint widthLoc = glGetUniformLocation(_normalInterpelationComputeShaderProgram, "width");
-		GLint heightLoc = glGetUniformLocation(_normalInterpelationComputeShaderProgram, "height");
-
-		glUseProgram(_normalInterpelationComputeShaderProgram);
-
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, 0);
+		_normalInterpelationPipeline.Bind(params);
 
 		GLuint numGroups = (((width + 1) * (height + 1)) + 63) / 64;
 		glDispatchCompute((GLuint)ceil(width / 16.0f),
 			(GLuint)ceil(height / 16.0f), 1);
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
+		ProfileScope readbackScope(ProfileStage::Readback);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboNormals);
 		glm::fvec3* ptrNormals = (glm::fvec3*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
 
@@ -1307,263 +836,484 @@ namespace Core {
 	
 	PlaneMesh CreateHeightMapPlaneMeshGPU(int width, int height, glm::vec2 offset, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity, bool CleanUp) {
 		PlaneMesh planeData;
-		if(CleanUp)
-			Init();
-		std::vector<glm::fvec3> vertices;
-		vertices.resize((width+1) * (height+1));
-		std::vector<int> indices;
-		indices.resize((width) * (height) * 6);
-		std::vector<glm::fvec3> normals;
-		normals.resize((width+1)*(height+1));
-
-		planeData.vertices = vertices;
-		planeData.indices = indices;
-		planeData.normals = normals;
+		planeData.vertices.resize((width + 1) * (height + 1));
+		planeData.indices.resize(width * height * 6);
+		planeData.normals.resize((width + 1) * (height + 1));
 
 		CreateVertices(planeData, width, height, offset, CleanUp);
 		CreateIndices(planeData, width, height, CleanUp);
 		DisplaceVertices(planeData, width, height, scale, amplitude, frequency, octaves, persistance, lacunarity, CleanUp);
 		InterpolatedNormals(planeData, width, height, CleanUp);
-		//CalculateNormalsHeightMap(planeData, width, height);
-		if (CleanUp)
-			Cleanup();
 		return planeData;
 	}	
 
 	
 
-	void InitializeVoxelMesh(VoxelMesh& mesh, int width, int height, int depth) {
+	void InitializeVoxelMesh(const std::vector<VoxelMesh*>& meshes, int width, int height, int depth) {
 
 		int totalVoxels = width * height * depth;
+		int count = (int)meshes.size();
+		std::vector<BufferRange> densityRanges(count);
+		std::vector<BufferRange> indirectRanges(count);
 
-		glGenBuffers(1, &mesh.densitySSBO);
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, mesh.densitySSBO);
-		// Allocate enough space for all the floats, uninitialized (nullptr) is fine since the GPU will fill it
-		glBufferData(GL_SHADER_STORAGE_BUFFER, totalVoxels * sizeof(float), nullptr, GL_STATIC_DRAW);
-
+		//Only the generation passes read the densities, CreateMarchingCubes3DMeshesGPU gives them back once they are dispatched
+		GetScratchArena().Allocate(totalVoxels * sizeof(float), densityRanges.data(), count);
 
-		glGenBuffers(1, &mesh.indirectBuffer);
-		uint32_t drawCmd[] = { 0, 1, 0, 0 };
-		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, mesh.indirectBuffer);
-		glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(drawCmd), drawCmd, GL_DYNAMIC_DRAW);
+		//DrawArraysIndirectCommand, or DrawElementsIndirectCommand plus the vertex count for indexed meshes. They sit in the readback arena
+		//so PollAsyncReadback can read the counts without a staging copy.
+		uint32_t drawCmd[] = { 0, 1, 0, 0, 0, 0 };
+		GLsizeiptr drawCmdSize = meshes.front()->indexed ? 24 : 16;
+		GetReadbackArena().Allocate(drawCmdSize, indirectRanges.data(), count);
 
-		glGenVertexArrays(1, &mesh.vao);
-		glBindVertexArray(mesh.vao);
+		for (int i = 0; i < count; i++) {
+			VoxelMesh& mesh = *meshes[i];
+			mesh.densityRange = densityRanges[i];
+			mesh.indirectRange = indirectRanges[i];
+			GetReadbackArena().Write(mesh.indirectRange, drawCmd, drawCmdSize);
 
-		glGenBuffers(1, &mesh.stagingIndirect);
-		glBindBuffer(GL_COPY_READ_BUFFER, mesh.stagingIndirect);
-		glBufferData(GL_COPY_READ_BUFFER, 16, nullptr, GL_STREAM_READ);
+			glGenVertexArrays(1, &mesh.vao);
 
-		mesh.gpuLoaded = true;
+			mesh.gpuLoaded = true;
+		}
 	}
 
-	void InitializeVoxelMeshSize(VoxelMesh& mesh, int size) {
-		if (size > -1) {
-			mesh.maxVertexCount = size;
-			// 2. Allocate the "Tight" buffers
-			glGenBuffers(1, &mesh.vboVertices);
-			glBindBuffer(GL_ARRAY_BUFFER, mesh.vboVertices);
-			glBufferData(GL_ARRAY_BUFFER, size * sizeof(float) * 3, nullptr, GL_STATIC_DRAW);
+	void InitializeVoxelMeshSize(const std::vector<VoxelMesh*>& meshes, int size, int maxVertexCount) {
+		if (size < 0 || meshes.empty()) return;
+		int count = (int)meshes.size();
+		bool indexed = meshes.front()->indexed;
+
+		//size counts 9 floats per triangle, so size / 3 bounds the vertices of both layouts and is the index count of an indexed mesh
+		int maxVertices = size / 3;
+		int maxIndices = 0;
+		if (indexed) {
+			maxIndices = size / 3;
+			if (maxVertexCount > -1)
+				maxVertices = std::min(maxVertices, maxVertexCount);
+		}
 
-			glGenBuffers(1, &mesh.vboNormals);
-			glBindBuffer(GL_ARRAY_BUFFER, mesh.vboNormals);
-			glBufferData(GL_ARRAY_BUFFER, size * sizeof(float) * 3, nullptr, GL_STATIC_DRAW);
+		//The generation passes write straight into the readback arena, PollAsyncReadback copies them out once the fence has passed.
+		//Every chunk gets the same room, so the vertices of chunk i start i ranges after those of the first.
+		BufferArena& readback = GetReadbackArena();
+		std::vector<BufferRange> vertexRanges(count);
+		std::vector<BufferRange> normalRanges(count);
+		std::vector<BufferRange> indexRanges(count);
+		readback.Allocate((GLsizeiptr)maxVertices * sizeof(glm::vec3), vertexRanges.data(), count);
+		readback.Allocate((GLsizeiptr)maxVertices * sizeof(glm::vec3), normalRanges.data(), count);
+		if (indexed)
+			readback.Allocate((GLsizeiptr)maxIndices * sizeof(uint32_t), indexRanges.data(), count);
+
+		for (int i = 0; i < count; i++) {
+			VoxelMesh& mesh = *meshes[i];
+			mesh.maxVertexCount = maxVertices;
+			mesh.maxIndexCount = maxIndices;
+			mesh.vertexRange = vertexRanges[i];
+			mesh.normalRange = normalRanges[i];
 
-			// 3. NOW link them to the VAO
 			glBindVertexArray(mesh.vao);
 
-			glBindBuffer(GL_ARRAY_BUFFER, mesh.vboVertices);
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+			glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexRange.buffer);
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, mesh.vertexRange.Pointer());
 			glEnableVertexAttribArray(0);
 
-			glBindBuffer(GL_ARRAY_BUFFER, mesh.vboNormals);
-			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+			glBindBuffer(GL_ARRAY_BUFFER, mesh.normalRange.buffer);
+			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, mesh.normalRange.Pointer());
 			glEnableVertexAttribArray(1);
 
-			glGenBuffers(1, &mesh.stagingVertices);
-			glBindBuffer(GL_COPY_WRITE_BUFFER, mesh.stagingVertices);
-			glBufferData(GL_COPY_WRITE_BUFFER, size * sizeof(float) * 3, nullptr, GL_STREAM_READ);
+			if (indexed) {
+				mesh.indexType = GL_UNSIGNED_INT;
+				mesh.indexRange = indexRanges[i];
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexRange.buffer);
 
-			glGenBuffers(1, &mesh.stagingNormals);
-			glBindBuffer(GL_COPY_WRITE_BUFFER, mesh.stagingNormals);
-			glBufferData(GL_COPY_WRITE_BUFFER, size * sizeof(float) * 3, nullptr, GL_STREAM_READ);
+				//firstIndex counts from the start of the element buffer, not the range
+				uint32_t firstIndex = (uint32_t)(mesh.indexRange.offset / sizeof(uint32_t));
+				readback.Write(mesh.indirectRange, &firstIndex, sizeof(uint32_t), 2 * sizeof(uint32_t));
+			}
 
 			glBindVertexArray(0);
 		}
 	}
-	void SetupAppendBuffer(AppendBuffer& ab, int width, int height, int depth) {
-		ab.maxCapacity = width * height * depth;
 
-		// 1. Setup Counter (just 4 bytes)
-		glGenBuffers(1, &ab.counterSSBO);
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ab.counterSSBO);
-		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+	namespace {
+		//The element buffer and indirect command of UploadVoxelMesh, with the VAO of the mesh bound
+		void UploadVoxelMeshIndices(VoxelMesh& mesh) {
+			const CpuVoxelMesh& cpuMesh = mesh.cpuMesh;
+			BufferArena& arena = GetMeshArena();
+			GLuint vertexCount = (GLuint)cpuMesh.vertices.size();
+			mesh.maxVertexCount = (int)vertexCount;
+
+			GLuint firstIndex = 0;
+			mesh.maxIndexCount = (int)cpuMesh.indices.size();
+			if (!cpuMesh.indices.empty()) {
+				//The element buffer is part of the VAO state, so it is bound before the VAO is unbound
+				mesh.indexed = true;
+				if (vertexCount <= 0xFFFF) {
+					std::vector<uint16_t> shortIndices(cpuMesh.indices.begin(), cpuMesh.indices.end());
+					mesh.indexRange = arena.Allocate(shortIndices.size() * sizeof(uint16_t));
+					arena.Write(mesh.indexRange, shortIndices.data(), shortIndices.size() * sizeof(uint16_t));
+					mesh.indexType = GL_UNSIGNED_SHORT;
+					firstIndex = (GLuint)(mesh.indexRange.offset / sizeof(uint16_t));
+				}
+				else {
+					mesh.indexRange = arena.Allocate(cpuMesh.indices.size() * sizeof(uint32_t));
+					arena.Write(mesh.indexRange, cpuMesh.indices.data(), cpuMesh.indices.size() * sizeof(uint32_t));
+					mesh.indexType = GL_UNSIGNED_INT;
+					firstIndex = (GLuint)(mesh.indexRange.offset / sizeof(uint32_t));
+				}
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexRange.buffer);
+			}
+
+			glBindVertexArray(0);
+
+			//Same layout as the command MarchingCubesCreateTris.comp or MarchingCubesIndexedTris.comp writes, so the mesh draws like a GPU one
+			if (mesh.indexed) {
+				uint32_t drawCmd[] = { (GLuint)mesh.maxIndexCount, 1, firstIndex, 0, 0, vertexCount };
+				mesh.indirectRange = arena.Allocate(sizeof(drawCmd));
+				arena.Write(mesh.indirectRange, drawCmd, sizeof(drawCmd));
+			}
+			else {
+				uint32_t drawCmd[] = { vertexCount, 1, 0, 0 };
+				mesh.indirectRange = arena.Allocate(sizeof(drawCmd));
+				arena.Write(mesh.indirectRange, drawCmd, sizeof(drawCmd));
+			}
 
-		// 2. Setup Data List
-		glGenBuffers(1, &ab.dataSSBO);
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ab.dataSSBO);
-		glBufferData(GL_SHADER_STORAGE_BUFFER, ab.maxCapacity * sizeof(uint32_t), nullptr, GL_STATIC_DRAW);
+			mesh.gpuLoaded = true;
+		}
 	}
 
-	void ClearAndBindAppendBuffer(AppendBuffer& ab) {
-		// Reset counter to 0
-		uint32_t zero = 0;
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ab.counterSSBO);
-		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(uint32_t), &zero);
+	void UploadVoxelMesh(VoxelMesh& mesh) {
+		ProfileScope scope(ProfileStage::Upload, true);
+		const CpuVoxelMesh& cpuMesh = mesh.cpuMesh;
+		BufferArena& arena = GetMeshArena();
+		GLsizeiptr vertexCount = (GLsizeiptr)cpuMesh.vertices.size();
 
-		// Bind to the binding points defined in the shader
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ab.counterSSBO);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, ab.dataSSBO);
+		if (mesh.vao == 0)
+			glGenVertexArrays(1, &mesh.vao);
+		glBindVertexArray(mesh.vao);
+
+		mesh.vertexRange = arena.Allocate(vertexCount * sizeof(glm::vec3));
+		arena.Write(mesh.vertexRange, cpuMesh.vertices.data(), vertexCount * sizeof(glm::vec3));
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexRange.buffer);
+		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, mesh.vertexRange.Pointer());
+		glEnableVertexAttribArray(0);
 
+		mesh.normalRange = arena.Allocate(vertexCount * sizeof(glm::vec3));
+		arena.Write(mesh.normalRange, cpuMesh.normals.data(), vertexCount * sizeof(glm::vec3));
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.normalRange.buffer);
+		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, mesh.normalRange.Pointer());
+		glEnableVertexAttribArray(1);
 
+		mesh.format = VertexFormat::Float;
+		UploadVoxelMeshIndices(mesh);
 	}
 
-	void StartAsyncReadback(VoxelMesh& mesh) {
-		// 1. Copy the Vertex Buffer
-		glBindBuffer(GL_COPY_READ_BUFFER, mesh.vboVertices);
-		glBindBuffer(GL_COPY_WRITE_BUFFER, mesh.stagingVertices);
-		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, mesh.maxVertexCount * sizeof(float) * 3);
-
-		// 2. Copy the Normal Buffer
-		glBindBuffer(GL_COPY_READ_BUFFER, mesh.vboNormals);
-		glBindBuffer(GL_COPY_WRITE_BUFFER, mesh.stagingNormals);
-		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, mesh.maxVertexCount * sizeof(float) * 3);
-
-		// 3. Copy the Indirect Buffer (Crucial: we need to know HOW MANY vertices were generated!)
-		glBindBuffer(GL_COPY_READ_BUFFER, mesh.indirectBuffer);
-		glBindBuffer(GL_COPY_WRITE_BUFFER, mesh.stagingIndirect);
-		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, 16); // 16 bytes = 4 uints
-
-		// 4. Drop the sync fence!
-		mesh.syncObj = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	void UploadPackedVoxelMesh(VoxelMesh& mesh, glm::vec3 origin, glm::vec3 extent) {
+		ProfileScope scope(ProfileStage::Upload, true);
+		BufferArena& arena = GetMeshArena();
+		std::vector<PackedMarchingCubesVertex> vertices;
+		PackMarchingCubesVertices(mesh.cpuMesh, origin, extent, vertices);
+
+		if (mesh.vao == 0)
+			glGenVertexArrays(1, &mesh.vao);
+		glBindVertexArray(mesh.vao);
+
+		mesh.vertexRange = arena.Allocate(vertices.size() * sizeof(PackedMarchingCubesVertex));
+		arena.Write(mesh.vertexRange, vertices.data(), vertices.size() * sizeof(PackedMarchingCubesVertex));
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexRange.buffer);
+		glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, sizeof(PackedMarchingCubesVertex), mesh.vertexRange.Pointer(offsetof(PackedMarchingCubesVertex, position)));
+		glEnableVertexAttribArray(0);
+		glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, sizeof(PackedMarchingCubesVertex), mesh.vertexRange.Pointer(offsetof(PackedMarchingCubesVertex, normal)));
+		glEnableVertexAttribArray(1);
+
+		mesh.format = VertexFormat::Packed;
+		mesh.origin = origin;
+		mesh.extent = extent;
+		UploadVoxelMeshIndices(mesh);
 	}
 
-	bool PollAsyncReadback(VoxelMesh& mesh) {
-		// If there is no sync object, or the CPU mesh is already built, do nothing.
-		if (mesh.syncObj == nullptr || mesh.cpuMesh.isReady) return false;
+	void ReleaseVoxelMesh(VoxelMesh& mesh) {
+		ReleaseRanges({ &mesh.densityRange, &mesh.vertexRange, &mesh.normalRange, &mesh.indexRange, &mesh.indirectRange });
+		if (mesh.vao) glDeleteVertexArrays(1, &mesh.vao);
+		if (mesh.syncObj) glDeleteSync(mesh.syncObj);
+		mesh.vao = 0;
+		mesh.syncObj = nullptr;
+		mesh.format = VertexFormat::Float;
+		mesh.gpuLoaded = false;
+	}
 
-		// Ask the GPU: "Are you done?" (Timeout 0 means return instantly)
-		GLenum waitReturn = glClientWaitSync(mesh.syncObj, 0, 0);
+	namespace {
+		//Points the attributes of a new VAO at the ranges of the mesh, the UVs only when it has a range for them
+		void CreatePlaneMeshVao(PlaneMesh& mesh) {
+			glGenVertexArrays(1, &mesh.vao);
+			glBindVertexArray(mesh.vao);
 
-		if (waitReturn == GL_TIMEOUT_EXPIRED || waitReturn == GL_WAIT_FAILED) {
-			return false; // Still working, check again next frame
-		}
+			if (mesh.format == VertexFormat::Packed) {
+				glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexRange.buffer);
+				glVertexAttribIPointer(0, 2, GL_UNSIGNED_INT, sizeof(PackedVoxelVertex), mesh.vertexRange.Pointer());
+				glEnableVertexAttribArray(0);
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexRange.buffer);
+				glBindVertexArray(0);
+				mesh.gpuLoaded = true;
+				return;
+			}
 
-		// --- THE DATA IS READY! Let's harvest it. ---
+			glBindBuffer(GL_ARRAY_BUFFER, mesh.vertexRange.buffer);
+			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), mesh.vertexRange.Pointer());
+			glEnableVertexAttribArray(0);
 
-		// 1. Read the exact vertex count from the Indirect Buffer
-		glBindBuffer(GL_COPY_READ_BUFFER, mesh.stagingIndirect);
-		uint32_t* indirectData = (uint32_t*)glMapBufferRange(GL_COPY_READ_BUFFER, 0, 16, GL_MAP_READ_BIT);
+			glBindBuffer(GL_ARRAY_BUFFER, mesh.normalRange.buffer);
+			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), mesh.normalRange.Pointer());
+			glEnableVertexAttribArray(1);
 
-		if (indirectData == nullptr) {
-			std::cerr << "CRITICAL ERROR: Failed to map Indirect Staging Buffer!" << std::endl;
-			glUnmapBuffer(GL_COPY_READ_BUFFER);
-			return false;
+			if (mesh.uvRange) {
+				glBindBuffer(GL_ARRAY_BUFFER, mesh.uvRange.buffer);
+				glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), mesh.uvRange.Pointer());
+				glEnableVertexAttribArray(2);
+			}
+
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.indexRange.buffer);
+
+			glBindVertexArray(0);
+			mesh.gpuLoaded = true;
 		}
+	}
 
-		uint32_t actualVertexCount = indirectData[0]; // The first integer is 'count'
-		//std::cout << "Actual Vertices: " << actualVertexCount << std::endl;
-		glUnmapBuffer(GL_COPY_READ_BUFFER);
+	namespace {
+		void FreePlaneMeshVectors(PlaneMesh& mesh) {
+			mesh.vertices = std::vector<glm::vec3>();
+			mesh.normals = std::vector<glm::vec3>();
+			mesh.UVs = std::vector<glm::vec2>();
+			mesh.indices = std::vector<int>();
+		}
+	}
 
-		// ==========================================
-		// FIX 1: THE EARLY EXIT TRAP
-		// ==========================================
-		if (actualVertexCount == 0) {
-			mesh.cpuMesh.isReady = true;
-			glDeleteSync(mesh.syncObj);
-			mesh.syncObj = nullptr;
+	void UploadPlaneMesh(PlaneMesh& mesh, bool keepCpuCopy) {
+		if (mesh.gpuLoaded) return;
+		ProfileScope scope(ProfileStage::Upload, true);
+		BufferArena& arena = GetMeshArena();
+
+		mesh.vertexRange = arena.Allocate(mesh.vertices.size() * sizeof(glm::vec3));
+		arena.Write(mesh.vertexRange, mesh.vertices.data(), mesh.vertices.size() * sizeof(glm::vec3));
+		mesh.normalRange = arena.Allocate(mesh.normals.size() * sizeof(glm::vec3));
+		arena.Write(mesh.normalRange, mesh.normals.data(), mesh.normals.size() * sizeof(glm::vec3));
+		if (!mesh.UVs.empty()) {
+			mesh.uvRange = arena.Allocate(mesh.UVs.size() * sizeof(glm::vec2));
+			arena.Write(mesh.uvRange, mesh.UVs.data(), mesh.UVs.size() * sizeof(glm::vec2));
+		}
+		mesh.indexRange = arena.Allocate(mesh.indices.size() * sizeof(int));
+		arena.Write(mesh.indexRange, mesh.indices.data(), mesh.indices.size() * sizeof(int));
+		mesh.indexCount = (int)mesh.indices.size();
+		mesh.format = VertexFormat::Float;
 
-			// The chunk is empty, nuke ALL massive buffers!
-			glDeleteBuffers(1, &mesh.vboVertices);
-			glDeleteBuffers(1, &mesh.vboNormals);
-			glDeleteBuffers(1, &mesh.stagingVertices);
-			glDeleteBuffers(1, &mesh.stagingNormals);
-			glDeleteBuffers(1, &mesh.stagingIndirect);
+		CreatePlaneMeshVao(mesh);
 
-			// Zero the IDs so the destructor doesn't crash later
-			mesh.vboVertices = 0;
-			mesh.vboNormals = 0;
-			mesh.stagingVertices = 0;
-			mesh.stagingNormals = 0;
-			mesh.stagingIndirect = 0;
+		if (!keepCpuCopy) FreePlaneMeshVectors(mesh);
+	}
 
-			return true;
+	void CreateHeightMapChunk(PlaneMesh& planeData, int width, int height, glm::ivec2 offset, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity, MeshTarget target) {
+		ProfileScope scope(ProfileStage::HeightMapChunk, _backend == Backend::GPU);
+		if (planeData.gpuLoaded) ReleasePlaneMesh(planeData);
+		if (_backend == Backend::CPU) {
+			Cpu::CreateHeightMapChunk(planeData, width, height, offset, scale, amplitude, frequency, octaves, persistance, lacunarity);
+			if (target != MeshTarget::Cpu)
+				UploadPlaneMesh(planeData, target == MeshTarget::GpuAndCpu);
+			return;
+		}
+		int vertexCount = (width + 1) * (height + 1);
+		int indexCount = width * height * 6;
+		//Drawable meshes are written straight into the ranges that become their VBOs, the others into scratch ranges that are read back once
+		BufferArena& arena = target == MeshTarget::Cpu ? GetScratchArena() : GetMeshArena();
+		BufferRange vertexRange = arena.Allocate(vertexCount * sizeof(glm::vec3));
+		BufferRange normalRange = arena.Allocate(vertexCount * sizeof(glm::vec3));
+		BufferRange indexRange = arena.Allocate(indexCount * sizeof(int));
+		BindStorageRange(0, vertexRange);
+		BindStorageRange(1, normalRange);
+		BindStorageRange(2, indexRange);
+
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, 0);
+		params.gridOffset = offset;
+		params.scale = scale;
+		params.amplitude = amplitude;
+		params.frequency = frequency;
+		params.octaves = octaves;
+		params.persistance = persistance;
+		params.lacunarity = lacunarity;
+		_heightMapChunkPipeline.Bind(params);
+
+		//One invocation per vertex, the last row and column included
+		glDispatchCompute((GLuint)ceil((width + 1) / 16.0f),
+			(GLuint)ceil((height + 1) / 16.0f), 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+		if (target != MeshTarget::Gpu) {
+			//The first read waits for the dispatch, the rest are copies
+			ProfileScope readbackScope(ProfileStage::Readback);
+			planeData.vertices.resize(vertexCount);
+			planeData.normals.resize(vertexCount);
+			planeData.indices.resize(indexCount);
+			arena.Read(vertexRange, planeData.vertices.data(), vertexCount * sizeof(glm::vec3));
+			arena.Read(normalRange, planeData.normals.data(), vertexCount * sizeof(glm::vec3));
+			arena.Read(indexRange, planeData.indices.data(), indexCount * sizeof(int));
 		}
+		if (target == MeshTarget::Cpu) {
+			ReleaseRanges({ &vertexRange, &normalRange, &indexRange });
+			return;
+		}
+		planeData.vertexRange = vertexRange;
+		planeData.normalRange = normalRange;
+		planeData.indexRange = indexRange;
+		planeData.indexCount = indexCount;
+		planeData.format = VertexFormat::Float;
+		CreatePlaneMeshVao(planeData);
+	}
 
-		// ==========================================
-		// THE SHRINK WRAP (Your code, unchanged)
-		// ==========================================
-		GLuint tightVertices, tightNormals;
-		glGenBuffers(1, &tightVertices);
-		glGenBuffers(1, &tightNormals);
+	void UploadPackedVoxelCubesMesh(PlaneMesh& mesh, glm::vec3 origin, bool tiledUVs, glm::vec2 atlasSize, bool keepCpuCopy) {
+		if (mesh.gpuLoaded) return;
+		ProfileScope scope(ProfileStage::Upload, true);
+		BufferArena& arena = GetMeshArena();
+		std::vector<PackedVoxelVertex> vertices;
+		PackVoxelCubesVertices(mesh, origin, tiledUVs, atlasSize, vertices);
 
-		glBindBuffer(GL_COPY_WRITE_BUFFER, tightVertices);
-		glBufferData(GL_COPY_WRITE_BUFFER, actualVertexCount * sizeof(float) * 3, nullptr, GL_STATIC_DRAW);
+		mesh.vertexRange = arena.Allocate(vertices.size() * sizeof(PackedVoxelVertex));
+		arena.Write(mesh.vertexRange, vertices.data(), vertices.size() * sizeof(PackedVoxelVertex));
+		mesh.indexRange = arena.Allocate(mesh.indices.size() * sizeof(int));
+		arena.Write(mesh.indexRange, mesh.indices.data(), mesh.indices.size() * sizeof(int));
+		mesh.indexCount = (int)mesh.indices.size();
+		mesh.format = VertexFormat::Packed;
+		mesh.origin = origin;
 
-		GLenum err;
-		while ((err = glGetError()) != GL_NO_ERROR) {
-			std::cout << "OpenGL Error in PollAsyncReadback: " << err << std::endl;
-		}
-		glBindBuffer(GL_COPY_WRITE_BUFFER, tightNormals);
-		glBufferData(GL_COPY_WRITE_BUFFER, actualVertexCount * sizeof(float) * 3, nullptr, GL_STATIC_DRAW);
+		CreatePlaneMeshVao(mesh);
 
-		while ((err = glGetError()) != GL_NO_ERROR) {
-			std::cout << "OpenGL Error in PollAsyncReadback: " << err << std::endl;
-		}
-		glBindBuffer(GL_COPY_READ_BUFFER, mesh.vboVertices);
-		glBindBuffer(GL_COPY_WRITE_BUFFER, tightVertices);
-		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, actualVertexCount * sizeof(float) * 3);
+		if (!keepCpuCopy) FreePlaneMeshVectors(mesh);
+	}
 
-		while ((err = glGetError()) != GL_NO_ERROR) {
-			std::cout << "OpenGL Error in PollAsyncReadback: " << err << std::endl;
+	void UploadHeightMapTexture(HeightMapTexture& chunk, bool halfFloat, bool keepCpuCopy) {
+		if (chunk.gpuLoaded) return;
+		ProfileScope scope(ProfileStage::Upload, true);
+		glGenTextures(1, &chunk.texture);
+		glBindTexture(GL_TEXTURE_2D, chunk.texture);
+		glTexStorage2D(GL_TEXTURE_2D, 1, halfFloat ? GL_R16F : GL_R32F, chunk.width + 3, chunk.height + 3);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, chunk.width + 3, chunk.height + 3, GL_RED, GL_FLOAT, chunk.heights.data());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		chunk.halfFloat = halfFloat;
+		chunk.gpuLoaded = true;
+
+		if (!keepCpuCopy) {
+			chunk.heights.clear();
+			chunk.heights.shrink_to_fit();
 		}
-		glBindBuffer(GL_COPY_READ_BUFFER, mesh.vboNormals);
-		glBindBuffer(GL_COPY_WRITE_BUFFER, tightNormals);
-		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, actualVertexCount * sizeof(float) * 3);
+	}
 
-		while ((err = glGetError()) != GL_NO_ERROR) {
-			std::cout << "OpenGL Error in PollAsyncReadback: " << err << std::endl;
+	void ReleaseHeightMapTexture(HeightMapTexture& chunk) {
+		if (chunk.texture) glDeleteTextures(1, &chunk.texture);
+		chunk.texture = 0;
+		chunk.gpuLoaded = false;
+	}
+
+	void ReleasePlaneMesh(PlaneMesh& mesh) {
+		ReleaseRanges({ &mesh.vertexRange, &mesh.normalRange, &mesh.uvRange, &mesh.indexRange });
+		if (mesh.vao) glDeleteVertexArrays(1, &mesh.vao);
+		mesh.vao = 0;
+		mesh.indexCount = 0;
+		mesh.format = VertexFormat::Float;
+		mesh.gpuLoaded = false;
+	}
+
+	void SetupAppendBuffer(AppendBuffer& ab, int width, int height, int depth, int chunkCount) {
+		ab.maxCapacity = width * height * depth;
+		ab.chunkCount = chunkCount;
+		BufferArena& scratch = GetScratchArena();
+
+		// 1. Setup the work group counts for glDispatchComputeIndirect, followed by the item counter of every chunk
+		ab.counterRange = scratch.Allocate((4 + chunkCount) * sizeof(uint32_t));
+		ResetAppendCounters(ab);
+
+		// 2. Setup Data List, maxCapacity items per chunk
+		ab.dataRange = scratch.Allocate((GLsizeiptr)ab.maxCapacity * chunkCount * sizeof(uint32_t));
+
+		// 3. Setup the per item triangle counts and offsets
+		ab.triangleRange = scratch.Allocate((GLsizeiptr)ab.maxCapacity * chunkCount * sizeof(uint32_t));
+
+		// 4. Setup the chunk table, WriteMarchingCubesChunks fills it
+		ab.chunkRange = scratch.Allocate(chunkCount * sizeof(MarchingCubesChunk));
+	}
+
+	void WriteMarchingCubesChunks(AppendBuffer& ab, const std::vector<VoxelMesh*>& meshes, const std::vector<glm::vec3>& offsets) {
+		const VoxelMesh& first = *meshes.front();
+		std::vector<MarchingCubesChunk> chunks(meshes.size());
+		for (size_t i = 0; i < meshes.size(); i++) {
+			const VoxelMesh& mesh = *meshes[i];
+			chunks[i].offset = glm::vec4(offsets[i], 0.0f);
+			chunks[i].bases.x = (uint32_t)((mesh.vertexRange.offset - first.vertexRange.offset) / sizeof(float));
+			chunks[i].bases.y = (uint32_t)((mesh.indexRange.offset - first.indexRange.offset) / sizeof(uint32_t));
+			chunks[i].bases.z = (uint32_t)((mesh.indirectRange.offset - first.indirectRange.offset) / sizeof(uint32_t));
+			chunks[i].bases.w = 0;
 		}
-		glBindVertexArray(mesh.vao);
-		glBindBuffer(GL_ARRAY_BUFFER, tightVertices);
-		glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-		glBindBuffer(GL_ARRAY_BUFFER, tightNormals);
-		glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-		glBindVertexArray(0);
+		GetScratchArena().Write(ab.chunkRange, chunks.data(), chunks.size() * sizeof(MarchingCubesChunk));
+	}
+
+	void ReleaseAppendBuffer(AppendBuffer& ab) {
+		ReleaseRanges({ &ab.counterRange, &ab.dataRange, &ab.triangleRange, &ab.chunkRange });
+	}
 
-		glDeleteBuffers(1, &mesh.vboVertices);
-		glDeleteBuffers(1, &mesh.vboNormals);
+	void ClearAndBindAppendBuffer(AppendBuffer& ab) {
+		// Reset counter to 0
+		ResetAppendCounters(ab);
 
-		mesh.vboVertices = tightVertices;
-		mesh.vboNormals = tightNormals;
+		// Bind to the binding points defined in the shader
+		BindStorageRange(1, ab.counterRange);
+		BindStorageRange(2, ab.dataRange);
 
-		// ==========================================
-		// CPU READBACK (Your code, unchanged)
-		// ==========================================
-		mesh.cpuMesh.vertices.resize(actualVertexCount);
-		mesh.cpuMesh.normals.resize(actualVertexCount);
 
-		glBindBuffer(GL_COPY_READ_BUFFER, mesh.stagingVertices);
-		float* mappedVerts = (float*)glMapBufferRange(GL_COPY_READ_BUFFER, 0, actualVertexCount * sizeof(float) * 3, GL_MAP_READ_BIT);
-		memcpy(mesh.cpuMesh.vertices.data(), mappedVerts, actualVertexCount * sizeof(glm::vec3));
-		glUnmapBuffer(GL_COPY_READ_BUFFER);
+	}
+
+	void StartAsyncReadback(VoxelMesh& mesh) {
+		//The outputs and the draw command already live in the mapped readback arena, so only the fence is left.
+		//Coherent mappings still need the barrier before shader writes become visible to the CPU.
+		glMemoryBarrier(GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+		mesh.syncObj = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	bool PollAsyncReadback(VoxelMesh& mesh) {
+		// If there is no sync object, or the CPU mesh is already built, do nothing.
+		if (mesh.syncObj == nullptr || mesh.cpuMesh.isReady) return false;
 
-		glBindBuffer(GL_COPY_READ_BUFFER, mesh.stagingNormals);
-		float* mappedNormals = (float*)glMapBufferRange(GL_COPY_READ_BUFFER, 0, actualVertexCount * sizeof(float) * 3, GL_MAP_READ_BIT);
-		memcpy(mesh.cpuMesh.normals.data(), mappedNormals, actualVertexCount * sizeof(glm::vec3));
-		glUnmapBuffer(GL_COPY_READ_BUFFER);
+		// Ask the GPU: "Are you done?" (Timeout 0 means return instantly)
+		GLenum waitReturn = glClientWaitSync(mesh.syncObj, 0, 0);
 
-		//std::cout << "Successfully read back " << actualVertexCount << " vertices and normals to the CPU." << std::endl;
-		// ==========================================
-		// FIX 2: NUKE THE STAGING BUFFERS
-		// ==========================================
-		glDeleteBuffers(1, &mesh.stagingVertices);
-		glDeleteBuffers(1, &mesh.stagingNormals);
-		glDeleteBuffers(1, &mesh.stagingIndirect);
+		if (waitReturn == GL_TIMEOUT_EXPIRED || waitReturn == GL_WAIT_FAILED) {
+			return false; // Still working, check again next frame
+		}
 
-		mesh.stagingVertices = 0;
-		mesh.stagingNormals = 0;
-		mesh.stagingIndirect = 0;
+		// --- THE DATA IS READY! Let's harvest it. ---
+		ProfileScope scope(ProfileStage::Readback);
+		BufferArena& readback = GetReadbackArena();
+
+		// 1. Read the exact counts from the draw command, indexed meshes keep their vertex count after it
+		uint32_t drawCmd[6] = {};
+		readback.Read(mesh.indirectRange, drawCmd, mesh.indexed ? 24 : 16);
+		uint32_t actualVertexCount = mesh.indexed ? drawCmd[5] : drawCmd[0];
+		uint32_t actualIndexCount = mesh.indexed ? drawCmd[0] : 0;
+		//std::cout << "Actual Vertices: " << actualVertexCount << std::endl;
+
+		// 2. CPU copy of exactly the generated part
+		mesh.cpuMesh.vertices.resize(actualVertexCount);
+		mesh.cpuMesh.normals.resize(actualVertexCount);
+		readback.Read(mesh.vertexRange, mesh.cpuMesh.vertices.data(), actualVertexCount * sizeof(glm::vec3));
+		readback.Read(mesh.normalRange, mesh.cpuMesh.normals.data(), actualVertexCount * sizeof(glm::vec3));
+		if (mesh.indexed) {
+			mesh.cpuMesh.indices.resize(actualIndexCount);
+			readback.Read(mesh.indexRange, mesh.cpuMesh.indices.data(), actualIndexCount * sizeof(uint32_t));
+		}
+
+		// 3. The worst case ranges go back to the arena and the mesh gets tight ones from the mesh arena, same as a CPU generated mesh
+		ReleaseRanges({ &mesh.vertexRange, &mesh.normalRange, &mesh.indexRange, &mesh.indirectRange });
+		UploadVoxelMesh(mesh);
 
 		// Clean up the sync object
 		glDeleteSync(mesh.syncObj);
@@ -1575,18 +1325,7 @@ namespace Core {
 
 	void VoxelMeshCleanUp(VoxelMesh& mesh) {
 
-		if (mesh.densitySSBO != 0) {
-			glDeleteBuffers(1, &mesh.densitySSBO);
-			mesh.densitySSBO = 0; 
-		}
-		glDeleteBuffers(1, &mesh.stagingVertices);
-		glDeleteBuffers(1, &mesh.stagingNormals);
-		glDeleteBuffers(1, &mesh.stagingIndirect);
-
-		// Zero them out
-		mesh.stagingVertices = 0;
-		mesh.stagingNormals = 0;
-		mesh.stagingIndirect = 0;
+		ReleaseRange(mesh.densityRange);
 
 		// Clean up the sync object
 		glDeleteSync(mesh.syncObj);
@@ -1595,182 +1334,270 @@ namespace Core {
 	}
 
 	// This is the new step you need to insert into CreateMarchingCubes3DMeshGPU
-	void PerformSurfaceCulling(VoxelMesh& mesh, AppendBuffer& ab, int width, int height, int depth, float isoLevel) {
+	void PerformSurfaceCulling(const std::vector<VoxelMesh*>& meshes, AppendBuffer& ab, int width, int height, int depth, float isoLevel) {
+		ProfileScope scope(ProfileStage::SurfaceCulling, true);
 
-		// 1. Reset the AppendBuffer counter to 0 so we start fresh for this chunk
-		uint32_t zero = 0;
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ab.counterSSBO);
-		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(uint32_t), &zero);
+		// 1. Reset the AppendBuffer counters to 0 so we start fresh for this batch
+		ResetAppendCounters(ab);
 
 		// 2. Memory Barrier: Ensure the Noise Map is finished before we read it
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
 		// 3. Bind the Culling Shader and its buffers
-		glUseProgram(_marchingCubesSurfaceCullingComputeShader);
-
-		// Binding 0: The Noise Density (Input)
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mesh.densitySSBO);
-		// Binding 1: The AppendBuffer Counter (Output)
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ab.counterSSBO);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, depth);
+		params.isoLevel = isoLevel;
+		_marchingCubesSurfaceCullingPipeline.Bind(params);
+
+		// Binding 0: The Noise Density of every chunk (Input)
+		BindStorageRanges(0, meshes.front()->densityRange, meshes.back()->densityRange);
+		// Binding 1: The AppendBuffer Counters (Output)
+		BindStorageRange(1, ab.counterRange);
 		// Binding 2: The AppendBuffer Data List (Output)
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, ab.dataSSBO);
+		BindStorageRange(2, ab.dataRange);
 
-		// 4. Set Uniforms
-		glUniform1i(glGetUniformLocation(_marchingCubesSurfaceCullingComputeShader, "width"), width);
-		glUniform1i(glGetUniformLocation(_marchingCubesSurfaceCullingComputeShader, "height"), height);
-		glUniform1i(glGetUniformLocation(_marchingCubesSurfaceCullingComputeShader, "depth"), depth);
-		glUniform1f(glGetUniformLocation(_marchingCubesSurfaceCullingComputeShader, "isoLevel"), isoLevel);
-
-		// 5. Dispatch: One thread per voxel
+		// 4. Dispatch: One thread per voxel of every chunk
 		glDispatchCompute((GLuint)ceil(width / 8.0f),
 			(GLuint)ceil(height / 8.0f),
-			(GLuint)ceil(depth / 8.0f));
+			(GLuint)ceil(depth / 8.0f) * (GLuint)meshes.size());
 
-		// 6. Memory Barrier: Ensure the Active List is built before the Counting step starts
-		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+		// 5. Memory Barrier: Ensure the Active List and the dispatch arguments are built before the Counting step starts
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
 	}
 
-	int GetActiveCountFromGPU(AppendBuffer& ab) {
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ab.counterSSBO);
-		uint32_t* ptr = (uint32_t*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
+	int GetActiveCountFromGPU(AppendBuffer& ab, int chunk) {
+		ProfileScope scope(ProfileStage::Readback);
 		uint32_t activeCount = 0;
-		if (ptr) {
-			activeCount = *ptr;
-			glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-		}
-		else {
-			std::cout << "Something went wrong in GetActiveCounterFromGPU";
-		}
+		GetScratchArena().Read(ab.counterRange, &activeCount, sizeof(uint32_t), (4 + chunk) * sizeof(uint32_t));
 		return activeCount;
 	}
 
-	int CountMarchingCubesTriangleCount(VoxelMesh& mesh, AppendBuffer& ab, int width, int height, int depth, glm::vec3 offset, bool CleanUp, float iso) {
-
-		GLuint ssboCounter;
-		glGenBuffers(1, &ssboCounter);
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboCounter);
-		// Allocate AND initialize to 0 in one go
-		uint32_t zero = 0;
-		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t), &zero, GL_DYNAMIC_DRAW);
+	int MarchingCubesMaxSize(int width, int height, int depth) {
+		//At most 5 triangles of 9 floats in every cube of the padded grid
+		return (width - 1) * (height - 1) * (depth - 1) * 5 * 9;
+	}
 
-		GLint frequencyLoc = glGetUniformLocation(_marchingCubesTriCounterComputeShader, "frequency");
-		GLint widthLoc = glGetUniformLocation(_marchingCubesTriCounterComputeShader, "width");
-		GLint heightLoc = glGetUniformLocation(_marchingCubesTriCounterComputeShader, "height");
-		GLint depthLoc = glGetUniformLocation(_marchingCubesTriCounterComputeShader, "depth");
-		GLint offsetLoc = glGetUniformLocation(_marchingCubesTriCounterComputeShader, "offset");
-		GLint isoLevelLoc = glGetUniformLocation(_marchingCubesTriCounterComputeShader, "isoLevel");
+	void CountMarchingCubesTriangleCount(const std::vector<VoxelMesh*>& meshes, AppendBuffer& ab, int width, int height, int depth, bool CleanUp, float iso) {
+		ProfileScope scope(ProfileStage::TriangleCount, true);
 
-		glUseProgram(_marchingCubesTriCounterComputeShader);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, depth);
+		params.isoLevel = iso;
+		_marchingCubesTriCounterPipeline.Bind(params);
 
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mesh.densitySSBO);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ssboCounter);
+		BindStorageRanges(0, meshes.front()->densityRange, meshes.back()->densityRange);
+		BindStorageRange(1, ab.triangleRange);
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, GetTriTableSSBO());
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, ab.counterSSBO);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, ab.dataSSBO);
+		BindStorageRange(3, ab.counterRange);
+		BindStorageRange(4, ab.dataRange);
 
+		//One thread per active voxel and a row of work groups per chunk, the work group count was built by the surface culling on the GPU
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, ab.counterRange.buffer);
+		glDispatchComputeIndirect(ab.counterRange.offset);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
-		glUniform1f(frequencyLoc, 0.1f);
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
-		glUniform1i(depthLoc, depth);
-		glUniform3fv(offsetLoc, 1, &offset[0]);
-		glUniform1f(isoLevelLoc, iso);
-
-		
+		//Turn the counts into offsets and write the draw counts, a single work group per chunk
+		_marchingCubesPrefixSumPipeline.Bind(params);
+		BindStorageRange(0, ab.triangleRange);
+		BindStorageRange(1, ab.counterRange);
+		BindStorageRanges(2, meshes.front()->indirectRange, meshes.back()->indirectRange);
+		BindStorageRange(3, ab.chunkRange);
+		glDispatchCompute((GLuint)meshes.size(), 1, 1);
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+	}
 
+	void CreateMarchingCubesTriangles(const std::vector<VoxelMesh*>& meshes, AppendBuffer& ab, int width, int height, int depth, bool CleanUp, float iso, int count) {
+		ProfileScope scope(ProfileStage::MarchingCubesMesh, true);
 
-		int activeCount = GetActiveCountFromGPU(ab); 
-		glDispatchCompute((GLuint)ceil(activeCount / 64.0f), 1, 1);
-		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT | GL_CLIENT_MAPPED_BUFFER_BARRIER_BIT);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, depth);
+		params.isoLevel = iso;
+		_marchingCubesTriCreatorPipeline.Bind(params);
 
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboCounter);
+		// Bind the buffers of the whole batch, the chunk table says where each chunk writes
+		BindStorageRanges(0, meshes.front()->densityRange, meshes.back()->densityRange);
+		BindStorageRanges(1, meshes.front()->vertexRange, meshes.back()->vertexRange);
+		BindStorageRanges(2, meshes.front()->normalRange, meshes.back()->normalRange);
+		BindStorageRange(3, ab.triangleRange);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, GetTriTableSSBO());
+		BindStorageRange(5, ab.counterRange);
+		BindStorageRange(6, ab.dataRange);
+		BindStorageRange(7, ab.chunkRange);
 
-		uint32_t* ptr = (uint32_t*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, ab.counterRange.buffer);
+		glDispatchComputeIndirect(ab.counterRange.offset);
 
-		// Copy or use data
-		uint32_t vertexCount = 0;
-		if (ptr) {
-			vertexCount = *ptr;
-			glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
-		}
-		else {
-			std::cout << "Something went wrong in CreateVertices";
-		}
-		glDeleteBuffers(1, &ssboCounter);
-		//std::cout << "Estimated Vertex Count: " << vertexCount << std::endl;
-		return vertexCount;
+		glMemoryBarrier(GL_COMMAND_BARRIER_BIT |
+			GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+			GL_SHADER_STORAGE_BARRIER_BIT);
 	}
 
-	void CreateMarchingCubesTriangles(VoxelMesh& mesh, AppendBuffer& ab, int width, int height, int depth, glm::vec3 offset, bool CleanUp, float iso, int count) {
-		
+	void CreateMarchingCubesIndexed(const std::vector<VoxelMesh*>& meshes, AppendBuffer& ab, int width, int height, int depth, float iso) {
+		ProfileScope scope(ProfileStage::MarchingCubesMesh, true);
+		//Zero the vertex counts behind the commands, the index counts come from the prefix sum
 		uint32_t zero = 0;
-		glBindBuffer(GL_SHADER_STORAGE_BUFFER, mesh.indirectBuffer);
-		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(uint32_t), &zero);
+		for (VoxelMesh* mesh : meshes)
+			GetReadbackArena().Write(mesh->indirectRange, &zero, sizeof(uint32_t), 5 * sizeof(uint32_t));
+
+		//Vertex index of every lattice edge. Only crossed edges are written and only crossed edges are read, so it needs no clearing.
+		BufferRange edgeVertices = GetScratchArena().Allocate((GLsizeiptr)width * height * depth * 3 * sizeof(uint32_t) * meshes.size());
 
-		// Ensure the reset is finished before the Compute Shader starts
 		glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
 
-		glUseProgram(_marchingCubesTriCreatorComputeShader);
+		ComputeParams params;
+		params.size = glm::ivec3(width, height, depth);
+		params.isoLevel = iso;
+		_marchingCubesIndexedVertsPipeline.Bind(params);
+		BindStorageRanges(0, meshes.front()->densityRange, meshes.back()->densityRange);
+		BindStorageRanges(1, meshes.front()->vertexRange, meshes.back()->vertexRange);
+		BindStorageRanges(2, meshes.front()->normalRange, meshes.back()->normalRange);
+		BindStorageRanges(3, meshes.front()->indirectRange, meshes.back()->indirectRange);
+		BindStorageRange(4, edgeVertices);
+		BindStorageRange(5, ab.chunkRange);
 
-		// Bind this chunk's specific buffers
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mesh.densitySSBO);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, mesh.vboVertices);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, mesh.vboNormals);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, mesh.indirectBuffer);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, GetTriTableSSBO());
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, ab.counterSSBO);
-		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, ab.dataSSBO);
-		
-		GLint frequencyLoc = glGetUniformLocation(_marchingCubesTriCreatorComputeShader, "frequency");
-		GLint widthLoc = glGetUniformLocation(_marchingCubesTriCreatorComputeShader, "width");
-		GLint heightLoc = glGetUniformLocation(_marchingCubesTriCreatorComputeShader, "height");
-		GLint depthLoc = glGetUniformLocation(_marchingCubesTriCreatorComputeShader, "depth");
-		GLint offsetLoc = glGetUniformLocation(_marchingCubesTriCreatorComputeShader, "offset");
-		GLint isoLevelLoc = glGetUniformLocation(_marchingCubesTriCreatorComputeShader, "isoLevel");
-
-		glUniform1f(frequencyLoc, 0.1f);
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, height);
-		glUniform1i(depthLoc, depth);
-		glUniform3fv(offsetLoc, 1, &offset[0]);
-		glUniform1f(isoLevelLoc, iso);
-
-		int activeCount = GetActiveCountFromGPU(ab);
-		glDispatchCompute((GLuint)ceil(activeCount / 64.0f), 1, 1);
+		glDispatchCompute((GLuint)ceil(width / 8.0f),
+			(GLuint)ceil(height / 8.0f),
+			(GLuint)ceil(depth / 8.0f) * (GLuint)meshes.size());
+
+		//The triangles read the edge cache the vertex pass just wrote
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+
+		_marchingCubesIndexedTrisPipeline.Bind(params);
+		BindStorageRanges(0, meshes.front()->densityRange, meshes.back()->densityRange);
+		BindStorageRanges(1, meshes.front()->indexRange, meshes.back()->indexRange);
+		BindStorageRange(3, ab.triangleRange);
+		BindStorageRange(4, edgeVertices);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 5, GetTriTableSSBO());
+		BindStorageRange(6, ab.counterRange);
+		BindStorageRange(7, ab.dataRange);
+		BindStorageRange(8, ab.chunkRange);
+
+		glBindBuffer(GL_DISPATCH_INDIRECT_BUFFER, ab.counterRange.buffer);
+		glDispatchComputeIndirect(ab.counterRange.offset);
 
 		glMemoryBarrier(GL_COMMAND_BARRIER_BIT |
 			GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT |
+			GL_ELEMENT_ARRAY_BARRIER_BIT |
 			GL_SHADER_STORAGE_BARRIER_BIT);
-	}
 
-	VoxelMesh* CreateMarchingCubes3DMeshGPU(int width, int height, int depth, glm::vec3 offset, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves) {
-		
-		int paddedWidth = width + 1;
-		int paddedHeight = height + 1;
-		int paddedDepth = depth + 1;
+		//The arena only hands it out again once the dispatches that use it are done
+		ReleaseRange(edgeVertices);
+	}
 
-		VoxelMesh* mesh = new VoxelMesh;
+	//The GPU passes of CreateMarchingCubes3DMeshesGPU for one batch, every pass covers all of its chunks with a single dispatch
+	static void CreateMarchingCubesBatchGPU(const std::vector<VoxelMesh*>& meshes, const std::vector<glm::vec3>& offsets, int paddedWidth, int paddedHeight, int paddedDepth, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves, const bool indexed) {
+		InitializeVoxelMesh(meshes, paddedWidth, paddedHeight, paddedDepth);
 
-		InitializeVoxelMesh(*mesh, paddedWidth, paddedHeight, paddedDepth);
+		//The real sizes only exist on the GPU, so the ranges are made for the worst case and PollAsyncReadback swaps them for tight ones
+		int size = MarchingCubesMaxSize(paddedWidth, paddedHeight, paddedDepth);
+		InitializeVoxelMeshSize(meshes, size, paddedWidth * paddedHeight * paddedDepth * 3);
 
-		CreateFlat3DNoiseMap(*mesh, paddedWidth, paddedHeight, paddedDepth,offset,CleanUp,amplitude,frequency,persistance,lacunarity,octaves, false);
 		AppendBuffer ab;
-		SetupAppendBuffer(ab, paddedWidth, paddedHeight, paddedDepth);
-		
-		PerformSurfaceCulling(*mesh, ab, paddedWidth, paddedHeight, paddedDepth, 0.0f);
+		SetupAppendBuffer(ab, paddedWidth, paddedHeight, paddedDepth, (int)meshes.size());
+		WriteMarchingCubesChunks(ab, meshes, offsets);
 
-		int size = CountMarchingCubesTriangleCount(*mesh, ab, paddedWidth, paddedHeight, paddedDepth, offset, CleanUp, 0.0f);
+		CreateFlat3DNoiseMap(meshes, ab, paddedWidth, paddedHeight, paddedDepth, CleanUp, amplitude, frequency, persistance, lacunarity, octaves, false);
 		
-		InitializeVoxelMeshSize(*mesh, size);
+		PerformSurfaceCulling(meshes, ab, paddedWidth, paddedHeight, paddedDepth, 0.0f);
 
-		//std::cout << "Predicted size: " << size << " | Actual size:" << mesh->maxVertexCount << std::endl;
+		CountMarchingCubesTriangleCount(meshes, ab, paddedWidth, paddedHeight, paddedDepth, CleanUp, 0.0f);
 
-		CreateMarchingCubesTriangles(*mesh, ab, paddedWidth, paddedHeight, paddedDepth, offset, CleanUp, 0.0f, size);
+		if (indexed)
+			CreateMarchingCubesIndexed(meshes, ab, paddedWidth, paddedHeight, paddedDepth, 0.0f);
+		else
+			CreateMarchingCubesTriangles(meshes, ab, paddedWidth, paddedHeight, paddedDepth, CleanUp, 0.0f, size);
 		
 		glMemoryBarrier(GL_ALL_BARRIER_BITS);
 
-		StartAsyncReadback(*mesh);
-		return mesh;
+		//Released behind a fence, so the arena only reuses them after the passes above
+		ReleaseAppendBuffer(ab);
+		for (VoxelMesh* mesh : meshes) {
+			ReleaseRange(mesh->densityRange);
+			StartAsyncReadback(*mesh);
+		}
+	}
+
+	VoxelMesh* CreateMarchingCubes3DMeshGPU(int width, int height, int depth, glm::vec3 offset, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves, const bool indexed) {
+		return CreateMarchingCubes3DMeshesGPU(width, height, depth, { offset }, CleanUp, amplitude, frequency, persistance, lacunarity, octaves, indexed).front();
+	}
+
+	std::vector<VoxelMesh*> CreateMarchingCubes3DMeshesGPU(int width, int height, int depth, const std::vector<glm::vec3>& offsets, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves, const bool indexed) {
+		
+		int paddedWidth = width + 1;
+		int paddedHeight = height + 1;
+		int paddedDepth = depth + 1;
+
+		std::vector<VoxelMesh*> meshes(offsets.size());
+		//Only the chunks that may have a surface go through the passes
+		std::vector<VoxelMesh*> mixedMeshes;
+		std::vector<glm::vec3> mixedOffsets;
+		for (size_t i = 0; i < meshes.size(); i++) {
+			VoxelMesh* mesh = new VoxelMesh;
+			mesh->indexed = indexed;
+			mesh->occupancy = ClassifyMarchingCubesChunk(paddedWidth, paddedHeight, paddedDepth, offsets[i], frequency);
+			if (mesh->occupancy == ChunkOccupancy::Mixed) {
+				mixedMeshes.push_back(mesh);
+				mixedOffsets.push_back(offsets[i]);
+			}
+			else {
+				mesh->cpuMesh.isReady = true;
+			}
+			meshes[i] = mesh;
+		}
+		if (mixedMeshes.empty()) return meshes;
+
+		if (_backend == Backend::CPU) {
+			//Same stages as below, but the meshes only get their CPU copy and no GL objects
+			std::vector<float> densities;
+			std::vector<uint32_t> activeVoxels;
+			for (size_t i = 0; i < mixedMeshes.size(); i++) {
+				VoxelMesh* mesh = mixedMeshes[i];
+				Cpu::CreateFlat3DNoiseMap(densities, paddedWidth, paddedHeight, paddedDepth, mixedOffsets[i], frequency);
+				Cpu::PerformSurfaceCulling(densities, activeVoxels, paddedWidth, paddedHeight, paddedDepth, 0.0f);
+				int size = Cpu::CountMarchingCubesTriangleCount(densities, activeVoxels, paddedWidth, paddedHeight, 0.0f);
+				if (indexed) {
+					mesh->cpuMesh.indices.reserve(size / 3);
+					Cpu::CreateMarchingCubesIndexed(mesh->cpuMesh, densities, activeVoxels, paddedWidth, paddedHeight, paddedDepth, mixedOffsets[i], 0.0f);
+				}
+				else {
+					mesh->cpuMesh.vertices.reserve(size / 3);
+					mesh->cpuMesh.normals.reserve(size / 3);
+					Cpu::CreateMarchingCubesTriangles(mesh->cpuMesh, densities, activeVoxels, paddedWidth, paddedHeight, mixedOffsets[i], 0.0f);
+				}
+				mesh->maxVertexCount = (int)mesh->cpuMesh.vertices.size();
+				mesh->maxIndexCount = (int)mesh->cpuMesh.indices.size();
+				mesh->cpuMesh.isReady = true;
+			}
+			return meshes;
+		}
+
+		//Every pass binds the ranges of a whole batch as one storage block, so the largest of them stays under the block size limit. Drivers
+		//may report a limit of gigabytes, so everything a batch allocates per chunk, worst case mesh ranges included, also stays under a fixed
+		//budget: densities, draw command, vertices and normals, indices and the edge cache when indexed, and the active list and triangle counts
+		constexpr GLint64 BatchMemoryBudget = 256ll * 1024 * 1024;
+		constexpr GLint64 RangeAlignment = 256;
+		GLint64 maxBlockSize = 0;
+		glGetInteger64v(GL_MAX_SHADER_STORAGE_BLOCK_SIZE, &maxBlockSize);
+		GLint64 voxels = (GLint64)paddedWidth * paddedHeight * paddedDepth;
+		GLint64 maxSize = MarchingCubesMaxSize(paddedWidth, paddedHeight, paddedDepth);
+		GLint64 vertexBytes = (indexed ? std::min(maxSize / 3, voxels * 3) : maxSize / 3) * (GLint64)sizeof(glm::vec3);
+		GLint64 indexBytes = indexed ? maxSize / 3 * (GLint64)sizeof(uint32_t) : 0;
+		GLint64 edgeBytes = indexed ? voxels * 3 * (GLint64)sizeof(uint32_t) : 0;
+		GLint64 densityBytes = voxels * (GLint64)sizeof(float);
+		GLint64 appendBytes = voxels * (GLint64)sizeof(uint32_t);
+		GLint64 blockBytes = std::max({ vertexBytes, indexBytes, edgeBytes, densityBytes, appendBytes });
+		GLint64 chunkBytes = densityBytes + 6 * sizeof(uint32_t) + 2 * vertexBytes + indexBytes + edgeBytes + 2 * appendBytes
+			+ sizeof(uint32_t) + sizeof(MarchingCubesChunk) + 5 * RangeAlignment;
+		size_t batchSize = (size_t)std::max<GLint64>(std::min(maxBlockSize / blockBytes, BatchMemoryBudget / chunkBytes), 1);
+		batchSize = std::min(batchSize, offsets.size());
+
+		for (size_t first = 0; first < mixedMeshes.size(); first += batchSize) {
+			size_t last = std::min(first + batchSize, mixedMeshes.size());
+			std::vector<VoxelMesh*> batch(mixedMeshes.begin() + first, mixedMeshes.begin() + last);
+			std::vector<glm::vec3> batchOffsets(mixedOffsets.begin() + first, mixedOffsets.begin() + last);
+			CreateMarchingCubesBatchGPU(batch, batchOffsets, paddedWidth, paddedHeight, paddedDepth, CleanUp, amplitude, frequency, persistance, lacunarity, octaves, indexed);
+		}
+		return meshes;
 	}
 	glm::vec3 VertInterp(float iso, glm::vec3 p1, glm::vec3 p2, float v1, float v2)
 	{
@@ -1787,6 +1614,9 @@ namespace Core {
 	}
 
 	int VoxelCubesQuadCount(int width, int heigth, int depth, glm::vec3 offset, const BlockIds& blockIDs, bool CleanUp) {
+		ProfileScope scope(ProfileStage::VoxelQuadCount, _backend == Backend::GPU);
+		if (_backend == Backend::CPU)
+			return Cpu::VoxelCubesQuadCount(width, heigth, depth, blockIDs);
 		GLuint ssboCounter;
 		GLuint ssboNoise;
 
@@ -1801,20 +1631,15 @@ namespace Core {
 		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(int), &initial, GL_DYNAMIC_COPY);
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, ssboCounter);
 
-		GLint widthLoc = glGetUniformLocation(_voxelCubesTriangleCounterComputeShader, "gridWidth");
-		GLint heightLoc = glGetUniformLocation(_voxelCubesTriangleCounterComputeShader, "gridHeight");
-		GLint depthLoc = glGetUniformLocation(_voxelCubesTriangleCounterComputeShader, "gridDepth");
-
-		glUseProgram(_voxelCubesTriangleCounterComputeShader);
-		
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, heigth);
-		glUniform1i(depthLoc, depth);
+		ComputeParams params;
+		params.size = glm::ivec3(width, heigth, depth);
+		_voxelCubesTriangleCounterPipeline.Bind(params);
 
 		glDispatchCompute((GLuint)ceil((width) / 8.0f),
 			(GLuint)ceil((heigth) / 8.0f), (GLuint)ceil((depth) / 8.0f));
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
+		ProfileScope readbackScope(ProfileStage::Readback);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboCounter);
 		int* ptr = (int*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
 
@@ -1831,7 +1656,119 @@ namespace Core {
 		return vertexCount;
 	}
 
-	void VoxelCubesGeometryInit(PlaneMesh& planeData, int width, int heigth, int depth, glm::vec3 offset, const BlockIds& blockIDs, int quadCount, bool CleanUp) {
+	namespace {
+		const BlockIds& DecodeScratch(const PalettedBlockIds& blockIDs) {
+			thread_local BlockIds scratch;
+			blockIDs.Decode(scratch);
+			return scratch;
+		}
+	}
+
+	namespace {
+		//The geometry pass of VoxelCubesGeometryInit with its outputs bound straight to the mesh arena ranges that the VAO then draws from,
+		//so nothing comes back to the CPU but the greedy counters and, when asked for, the CPU copy
+		void VoxelCubesGeometryInitResident(PlaneMesh& planeData, int width, int heigth, int depth, glm::vec3 offset, const BlockIds& blockIDs, int quadCount, bool greedy, bool keepCpuCopy) {
+			if (planeData.gpuLoaded) ReleasePlaneMesh(planeData);
+			if (quadCount <= 0) return;
+			BufferArena& arena = GetMeshArena();
+			BufferArena& scratch = GetScratchArena();
+
+			planeData.vertexRange = arena.Allocate(quadCount * 4 * sizeof(glm::vec3));
+			planeData.normalRange = arena.Allocate(quadCount * 4 * sizeof(glm::vec3));
+			planeData.indexRange = arena.Allocate(quadCount * 6 * sizeof(int));
+			planeData.uvRange = arena.Allocate(quadCount * 4 * sizeof(glm::vec2));
+
+			BufferRange idRange = scratch.Allocate(blockIDs.IDs.size() * sizeof(int));
+			scratch.Write(idRange, blockIDs.IDs.data(), blockIDs.IDs.size() * sizeof(int));
+			int counters[2] = { 0, 0 };
+			BufferRange counterRanges[2];
+			scratch.Allocate(sizeof(int), counterRanges, 2);
+			scratch.Write(counterRanges[0], &counters[0], sizeof(int));
+			scratch.Write(counterRanges[1], &counters[1], sizeof(int));
+			BufferRange visitedRange;
+			if (greedy) {
+				visitedRange = scratch.Allocate(blockIDs.IDs.size() * sizeof(GLuint));
+				glBindBuffer(GL_SHADER_STORAGE_BUFFER, visitedRange.buffer);
+				glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, visitedRange.offset, visitedRange.size, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+				BindStorageRange(7, visitedRange);
+			}
+
+			BindStorageRange(0, idRange);
+			BindStorageRange(1, planeData.vertexRange);
+			BindStorageRange(2, planeData.normalRange);
+			BindStorageRange(3, planeData.indexRange);
+			BindStorageRange(4, counterRanges[0]);
+			BindStorageRange(5, counterRanges[1]);
+			BindStorageRange(6, planeData.uvRange);
+
+			ComputeParams params;
+			params.size = glm::ivec3(width, heigth, depth);
+			params.offset = offset;
+			params.columns = 3;
+			params.rows = 16;
+			ComputePipeline& pipeline = greedy ? _voxelCubesGreedyGeometryInitPipeline : _voxelCubesGeometryInitPipeline;
+			pipeline.Bind(params);
+
+			if (greedy) {
+				int maxSlices = std::max(width, std::max(heigth, depth));
+				glDispatchCompute((GLuint)ceil(maxSlices / 64.0f), 6, 1);
+			}
+			else {
+				glDispatchCompute((GLuint)ceil((width) / 8.0f),
+					(GLuint)ceil((heigth) / 8.0f), (GLuint)ceil((depth) / 8.0f));
+			}
+			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_ELEMENT_ARRAY_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+			//Without merging every counted quad is written. Merged quads only fill the front of the ranges, which keep the unmerged size.
+			int vertexCount = quadCount * 4;
+			int indexCount = quadCount * 6;
+			ProfileScope readbackScope(ProfileStage::Readback);
+			if (greedy) {
+				scratch.Read(counterRanges[0], &indexCount, sizeof(int));
+				scratch.Read(counterRanges[1], &vertexCount, sizeof(int));
+				vertexCount /= 3;
+			}
+			planeData.indexCount = indexCount;
+			CreatePlaneMeshVao(planeData);
+
+			if (keepCpuCopy) {
+				planeData.vertices.resize(vertexCount);
+				planeData.normals.resize(vertexCount);
+				planeData.UVs.resize(vertexCount);
+				planeData.indices.resize(indexCount);
+				arena.Read(planeData.vertexRange, planeData.vertices.data(), vertexCount * sizeof(glm::vec3));
+				arena.Read(planeData.normalRange, planeData.normals.data(), vertexCount * sizeof(glm::vec3));
+				arena.Read(planeData.uvRange, planeData.UVs.data(), vertexCount * sizeof(glm::vec2));
+				arena.Read(planeData.indexRange, planeData.indices.data(), indexCount * sizeof(int));
+			}
+
+			ReleaseRanges({ &idRange, &counterRanges[0], &counterRanges[1], &visitedRange });
+		}
+	}
+
+	int VoxelCubesQuadCount(int width, int heigth, int depth, glm::vec3 offset, const PalettedBlockIds& blockIDs, bool CleanUp) {
+		return VoxelCubesQuadCount(width, heigth, depth, offset, DecodeScratch(blockIDs), CleanUp);
+	}
+
+	void VoxelCubesGeometryInit(PlaneMesh& planeData, int width, int heigth, int depth, glm::vec3 offset, const PalettedBlockIds& blockIDs, int quadCount, bool CleanUp, bool greedy, MeshTarget target) {
+		VoxelCubesGeometryInit(planeData, width, heigth, depth, offset, DecodeScratch(blockIDs), quadCount, CleanUp, greedy, target);
+	}
+
+	void VoxelCubesGeometryInit(PlaneMesh& planeData, int width, int heigth, int depth, glm::vec3 offset, const BlockIds& blockIDs, int quadCount, bool CleanUp, bool greedy, MeshTarget target) {
+		ProfileScope scope(ProfileStage::VoxelMesh, _backend == Backend::GPU);
+		if (_backend == Backend::CPU) {
+			if (greedy)
+				Cpu::VoxelCubesGreedyGeometryInit(planeData, width, heigth, depth, offset, blockIDs, quadCount);
+			else
+				Cpu::VoxelCubesBinaryGeometryInit(planeData, width, heigth, depth, offset, blockIDs, 3, 16);
+			if (target != MeshTarget::Cpu)
+				UploadPlaneMesh(planeData, target == MeshTarget::GpuAndCpu);
+			return;
+		}
+		if (target != MeshTarget::Cpu) {
+			VoxelCubesGeometryInitResident(planeData, width, heigth, depth, offset, blockIDs, quadCount, greedy, target == MeshTarget::GpuAndCpu);
+			return;
+		}
 		std::vector<glm::vec3> vertices;
 		std::vector<glm::vec3> normals;
 		std::vector<int> indices;
@@ -1849,6 +1786,7 @@ namespace Core {
 		GLuint ssboIndexCounter;
 		GLuint ssboVertexCounter;
 		GLuint ssboUV;
+		GLuint ssboVisited = 0;
 
 		glGenBuffers(1, &ssboNoise);
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboNoise);
@@ -1887,26 +1825,48 @@ namespace Core {
 		glBufferData(GL_SHADER_STORAGE_BUFFER, UVs.size() * sizeof(glm::vec2), UVs.data(), GL_DYNAMIC_COPY);
 		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 6, ssboUV);
 
-		GLint widthLoc = glGetUniformLocation(_voxelCubesGeometryInitComputeShader, "gridWidth");
-		GLint heightLoc = glGetUniformLocation(_voxelCubesGeometryInitComputeShader, "gridHeight");
-		GLint depthLoc = glGetUniformLocation(_voxelCubesGeometryInitComputeShader, "gridDepth");
-		GLint offsetLoc = glGetUniformLocation(_voxelCubesGeometryInitComputeShader, "offset");
-		GLint columnSizeLoc = glGetUniformLocation(_voxelCubesGeometryInitComputeShader, "columns");
-		GLint rowSizeLoc = glGetUniformLocation(_voxelCubesGeometryInitComputeShader, "rows");
-
-		glUseProgram(_voxelCubesGeometryInitComputeShader);
-
-		glUniform1i(widthLoc, width);
-		glUniform1i(heightLoc, heigth);
-		glUniform1i(depthLoc, depth);
-		glUniform3fv(offsetLoc, 1, &offset[0]);
-		glUniform1f(columnSizeLoc, 3);
-		glUniform1f(rowSizeLoc, 16);
+		if (greedy) {
+			//One bit per face of every block, set once the face is merged into a quad
+			glGenBuffers(1, &ssboVisited);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboVisited);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, blockIDs.IDs.size() * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+			glClearBufferData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 7, ssboVisited);
+		}
 
-		glDispatchCompute((GLuint)ceil((width) / 8.0f),
-			(GLuint)ceil((heigth) / 8.0f), (GLuint)ceil((depth) / 8.0f));
+		ComputeParams params;
+		params.size = glm::ivec3(width, heigth, depth);
+		params.offset = offset;
+		params.columns = 3;
+		params.rows = 16;
+		ComputePipeline& pipeline = greedy ? _voxelCubesGreedyGeometryInitPipeline : _voxelCubesGeometryInitPipeline;
+		pipeline.Bind(params);
+
+		if (greedy) {
+			//One invocation per slice and face direction
+			int maxSlices = std::max(width, std::max(heigth, depth));
+			glDispatchCompute((GLuint)ceil(maxSlices / 64.0f), 6, 1);
+		}
+		else {
+			glDispatchCompute((GLuint)ceil((width) / 8.0f),
+				(GLuint)ceil((heigth) / 8.0f), (GLuint)ceil((depth) / 8.0f));
+		}
 		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
 
+		ProfileScope readbackScope(ProfileStage::Readback);
+		if (greedy) {
+			//Merged quads only fill the front of the buffers, quadCount was the unmerged upper bound
+			int written = 0;
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboVertexCounter);
+			glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(int), &written);
+			vertices.resize(written / 3);
+			normals.resize(written / 3);
+			UVs.resize(written / 3);
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboIndexCounter);
+			glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(int), &written);
+			indices.resize(written);
+		}
+
 		glBindBuffer(GL_SHADER_STORAGE_BUFFER, ssboVertex);
 		glm::vec3* vertexPtr = (glm::vec3*)glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_READ_ONLY);
 		if (vertexPtr) {
@@ -1935,20 +1895,11 @@ namespace Core {
 		glDeleteBuffers(1, &ssboUV);
 		glDeleteBuffers(1, &ssboIndexCounter);
 		glDeleteBuffers(1, &ssboVertexCounter);
+		if (ssboVisited)
+			glDeleteBuffers(1, &ssboVisited);
 	}
 
-	VoxelData CreateVoxelCubes3DMesh(int width, int height, int depth, glm::vec2 offset, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves, const bool useDropoff) {
-		PlaneMesh planeData;
-		int paddedWidth = width + 2;
-		int paddedHeight = height + 2;
-		int paddedDepth = depth + 2;
-
-		NoiseMapData noiseMapData;
-		BlockIds blockIDs;
-		BlockIds;
-
-		glm::vec3 offset3D = glm::vec3(offset.x, 0, offset.y);
-
+	Spline CreateVoxelCubesSpline() {
 		/*Spline spline;
 		spline.points.push_back(SplinePoint(0.0f,0.3f));
 		spline.points.push_back(SplinePoint(0.1f, 0.3f));
@@ -1974,13 +1925,29 @@ namespace Core {
 		spline.points.push_back(SplinePoint(0.96f, 0.45f));
 		spline.points.push_back(SplinePoint(0.98f, 1.4f));
 		spline.points.push_back(SplinePoint(1.0f, 1.45f));
+		return spline;
+	}
+
+	VoxelData CreateVoxelCubes3DMesh(int width, int height, int depth, glm::vec2 offset, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves, const bool useDropoff, const bool greedy) {
+		PlaneMesh planeData;
+		int paddedWidth = width + 2;
+		int paddedHeight = height + 2;
+		int paddedDepth = depth + 2;
+
+		NoiseMapData noiseMapData;
+		BlockIds blockIDs;
+
+		glm::vec3 offset3D = glm::vec3(offset.x, 0, offset.y);
+
+		Spline spline = CreateVoxelCubesSpline();
 
 		CreateFlat3DNoiseMapPipeLine(blockIDs, spline, paddedWidth, paddedHeight, paddedDepth, offset3D, true, frequency, true);
 		TerrainPaint(blockIDs, paddedWidth, paddedHeight, paddedDepth);
 
 
-		int quadCount = VoxelCubesQuadCount(paddedWidth, paddedHeight, paddedDepth, offset3D, blockIDs, CleanUp);
-		VoxelCubesGeometryInit(planeData, paddedWidth, paddedHeight, paddedDepth, offset3D, blockIDs, quadCount, CleanUp);
+		//The CPU per face mesher counts its own quads
+		int quadCount = (_backend == Backend::CPU && !greedy) ? 0 : VoxelCubesQuadCount(paddedWidth, paddedHeight, paddedDepth, offset3D, blockIDs, CleanUp);
+		VoxelCubesGeometryInit(planeData, paddedWidth, paddedHeight, paddedDepth, offset3D, blockIDs, quadCount, CleanUp, greedy);
 
 		return VoxelData(planeData,blockIDs);
 	}
@@ -1,18 +1,36 @@
 #pragma once
-#include <GLFW/glfw3.h>
 #include <glad/glad.h>
+#include <GLFW/glfw3.h>
 
 #include "vector"
 #include "glm.hpp"
 
+#include "BufferArena.h"
+#include "Profiler.h"
+
 
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <iomanip>
+#include <utility>
 
 namespace Core {
+	//Selects where the generation stages run. GPU needs a current GL 4.3 context and the .comp files, CPU runs every stage on the calling thread
+	//and needs neither, so it can be used on headless machines.
+	enum class Backend {
+		GPU,
+		CPU
+	};
+
+	//Vertex layout of an uploaded mesh. Packed meshes have one interleaved vertex range, see PackedVertices.h, and their positions are
+	//relative to the origin of the mesh, so they need a shader that decodes them.
+	enum class VertexFormat : uint8_t {
+		Float,
+		Packed
+	};
+
 	struct SplinePoint
 	{
 		SplinePoint(float x, float y) : position(x, y) {}
@@ -24,6 +42,14 @@ namespace Core {
 		std::vector<SplinePoint> points; //list of points in the spline
 		bool closed = false; //if the spline is closed or not
 	};
+	struct PlaneMesh;
+	struct VoxelMesh;
+	struct HeightMapTexture;
+	//Give the mesh ranges back to their arena and delete the VAO, the destructors call them for meshes that are still loaded
+	void ReleasePlaneMesh(PlaneMesh& mesh);
+	void ReleaseVoxelMesh(VoxelMesh& mesh);
+	void ReleaseHeightMapTexture(HeightMapTexture& chunk);
+
 	struct PlaneMesh
 	{
 		std::vector<glm::vec3> vertices; //coordinates (x, y, z)
@@ -31,67 +57,147 @@ namespace Core {
 		std::vector<glm::vec3> normals; //normals for each vertex
 		std::vector<glm::vec2> UVs;
 
+		//Ranges in the mesh arena, draw indexCount indices with mesh.indexRange.Pointer() as the glDrawElements offset
 		GLuint vao = 0;
-		GLuint vboVertices = 0;
-		GLuint vboNormals = 0;
-		GLuint vboUVs = 0;
-		GLuint ebo = 0;
+		int indexCount = 0; //set by the uploads, also for meshes that keep no CPU copy
+		VertexFormat format = VertexFormat::Float;
+		glm::vec3 origin = glm::vec3(0.0f); //what packed positions are relative to
+		BufferRange vertexRange;
+		BufferRange normalRange;
+		BufferRange uvRange;
+		BufferRange indexRange;
 
 		bool gpuLoaded = false;
 
+		PlaneMesh() = default;
+		//Copies only take the CPU data, the GL state stays with the original so no range is released twice
+		PlaneMesh(const PlaneMesh& other) : vertices(other.vertices), indices(other.indices), normals(other.normals), UVs(other.UVs) {}
+		PlaneMesh(PlaneMesh&& other) noexcept { *this = std::move(other); }
+		PlaneMesh& operator=(const PlaneMesh& other)
+		{
+			vertices = other.vertices;
+			indices = other.indices;
+			normals = other.normals;
+			UVs = other.UVs;
+			return *this;
+		}
+		PlaneMesh& operator=(PlaneMesh&& other) noexcept
+		{
+			if (this == &other) return *this;
+			if (gpuLoaded) ReleasePlaneMesh(*this);
+			vertices = std::move(other.vertices);
+			indices = std::move(other.indices);
+			normals = std::move(other.normals);
+			UVs = std::move(other.UVs);
+			vao = std::exchange(other.vao, 0);
+			vertexRange = std::exchange(other.vertexRange, BufferRange());
+			normalRange = std::exchange(other.normalRange, BufferRange());
+			uvRange = std::exchange(other.uvRange, BufferRange());
+			indexRange = std::exchange(other.indexRange, BufferRange());
+			indexCount = std::exchange(other.indexCount, 0);
+			format = std::exchange(other.format, VertexFormat::Float);
+			origin = other.origin;
+			gpuLoaded = std::exchange(other.gpuLoaded, false);
+			return *this;
+		}
 		~PlaneMesh()
 		{
-			if (gpuLoaded) {
-				if (ebo) glDeleteBuffers(1, &ebo);
-				if (vboNormals) glDeleteBuffers(1, &vboNormals);
-				if (vboVertices) glDeleteBuffers(1, &vboVertices);
-				if (vao) glDeleteVertexArrays(1, &vao);
-				
-				if (vboUVs) glDeleteBuffers(1, &vboUVs);
-			}
+			if (gpuLoaded) ReleasePlaneMesh(*this);
+		}
+	};
+
+	//A heightmap chunk that keeps only its heights. It is drawn with the grid of CreateHeightMapGridMesh (see HeightMapQuadtree.h), shared by
+	//every chunk of the same size, and its vertices read their height from the texture. The heights have an apron of one sample around the
+	//(width+1)x(height+1) vertices, so normals can be taken across the chunk border.
+	struct HeightMapTexture {
+		std::vector<float> heights; //(width + 3) x (height + 3) world heights row by row, the vertex (x, z) is at (x + 1, z + 1)
+		int width = 0;
+		int height = 0;
+
+		GLuint texture = 0; //R16F or R32F, sample it with texelFetch
+		bool halfFloat = false;
+		bool gpuLoaded = false;
+
+		HeightMapTexture() = default;
+		HeightMapTexture(const HeightMapTexture&) = delete;
+		HeightMapTexture& operator=(const HeightMapTexture&) = delete;
+		HeightMapTexture(HeightMapTexture&& other) noexcept { *this = std::move(other); }
+		HeightMapTexture& operator=(HeightMapTexture&& other) noexcept
+		{
+			if (this == &other) return *this;
+			if (gpuLoaded) ReleaseHeightMapTexture(*this);
+			heights = std::move(other.heights);
+			width = other.width;
+			height = other.height;
+			texture = std::exchange(other.texture, 0);
+			halfFloat = other.halfFloat;
+			gpuLoaded = std::exchange(other.gpuLoaded, false);
+			return *this;
+		}
+		~HeightMapTexture()
+		{
+			if (gpuLoaded) ReleaseHeightMapTexture(*this);
 		}
 	};
 
 	struct CpuVoxelMesh {
 		std::vector<glm::vec3> vertices;
 		std::vector<glm::vec3> normals;
+		std::vector<uint32_t> indices; //only filled for indexed meshes, three per triangle
 		bool isReady = false;
 	};
 
+	//Scratch arena ranges of the marching cubes passes for a batch of chunks, ReleaseAppendBuffer gives them back
 	struct AppendBuffer {
-		GLuint counterSSBO;
-		GLuint dataSSBO;
+		BufferRange counterRange; //glDispatchComputeIndirect arguments for one thread per item and a row of work groups per chunk, then the item count of every chunk
+		BufferRange dataRange; //maxCapacity items per chunk
+		BufferRange triangleRange; //triangle count, then offset, of every item
+		BufferRange chunkRange; //world offset and output bases of every chunk
 		int maxCapacity;
+		int chunkCount = 1;
+	};
+
+	//What the densities of a marching cubes chunk hold. Air has every density below the iso level and Solid every density at or above it,
+	//neither has a surface.
+	enum class ChunkOccupancy : uint8_t {
+		Mixed,
+		Air,
+		Solid
 	};
 
 	struct VoxelMesh
 	{
 		GLuint vao = 0;
-		GLuint densitySSBO = 0;
-		GLuint vboVertices = 0;
-		GLuint vboNormals = 0;
-		GLuint ssboIndices = 0;
-		GLuint indirectBuffer = 0;
+		//While the GPU generates the mesh the outputs are worst case ranges in the readback arena and the densities a scratch range.
+		//PollAsyncReadback and UploadVoxelMesh leave tight ranges in the mesh arena.
+		BufferRange densityRange;
+		BufferRange vertexRange;
+		BufferRange normalRange;
+		BufferRange indexRange; //element buffer of indexed meshes
+		BufferRange indirectRange; //bind indirectRange.buffer and draw with indirectRange.Pointer()
 		int maxVertexCount = 0;
+		int maxIndexCount = 0;
 		bool gpuLoaded = false;
-
-		GLuint stagingVertices = 0;
-		GLuint stagingNormals = 0;
-		GLuint stagingIndirect = 0;
+		//Indexed meshes share the vertex of each crossed lattice edge between its triangles and are drawn with glDrawElementsIndirect.
+		//Their indirect command is a DrawElementsIndirectCommand followed by the vertex count.
+		bool indexed = false;
+		GLenum indexType = GL_UNSIGNED_INT;
+		VertexFormat format = VertexFormat::Float;
+		//Packed positions are unorm16 from origin across extent
+		glm::vec3 origin = glm::vec3(0.0f);
+		glm::vec3 extent = glm::vec3(1.0f);
+		//Air and Solid meshes come back from generation with an empty, ready cpuMesh and no GL objects
+		ChunkOccupancy occupancy = ChunkOccupancy::Mixed;
 
 		GLsync syncObj = nullptr;
 		CpuVoxelMesh cpuMesh; //CPU-side copy of the mesh data for readback and other operations
 
+		VoxelMesh() = default;
+		VoxelMesh(const VoxelMesh&) = delete;
+		VoxelMesh& operator=(const VoxelMesh&) = delete;
 		~VoxelMesh()
 		{
-			if (gpuLoaded) {
-				glDeleteBuffers(1, &vboVertices);
-				glDeleteBuffers(1, &vboNormals);
-				glDeleteBuffers(1, &indirectBuffer);
-				if (ssboIndices) glDeleteBuffers(1, &ssboIndices);
-				glDeleteVertexArrays(1, &vao);
-				if (densitySSBO) glDeleteBuffers(1, &densitySSBO);
-			}
+			ReleaseVoxelMesh(*this);
 		}
 	};
 	struct NoiseMapData
@@ -101,6 +207,7 @@ namespace Core {
 	struct BlockIds {
 		std::vector<int> IDs;
 	};
+	class PalettedBlockIds;
 	struct VoxelData {
 		VoxelData(PlaneMesh meshdata, BlockIds blockids) { meshData = meshdata; blockIDs = blockids; }
 		PlaneMesh meshData;
@@ -111,47 +218,122 @@ namespace Core {
 	extern GLuint _indexInitComputeShaderProgram;
 	extern GLuint _vertexDisplacementComputeShaderProgram;
 	extern GLuint _normalInterpelationComputeShaderProgram;
+	extern GLuint _heightMapChunkComputeShader;
 	extern GLuint _3dNoiseMapComputeShader;
 	extern GLuint _3DNoiseMapPipelineComputeShader;
 	extern GLuint _marchingCubesTriCounterComputeShader;
 	extern GLuint _marchingCubesSurfaceCullingComputeShader;
+	extern GLuint _marchingCubesIndexedVertsComputeShader;
+	extern GLuint _marchingCubesIndexedTrisComputeShader;
+	extern GLuint _marchingCubesPrefixSumComputeShader;
 	extern GLuint _voxelCubesGeometryInitComputeShader;
+	extern GLuint _voxelCubesGreedyGeometryInitComputeShader;
 	extern GLuint _smoothMarchingCubesVertCreatorComputeShader;
 	extern GLuint _voxelCubesTriangleCounterComputeShader;
 	extern GLuint _voxelTerrainPainterComputeShader;
 
 
+	void SetBackend(Backend backend);
+	Backend GetBackend();
+	//Reference counted, the last Cleanup deletes the compute programs. They are compiled once per context on their first dispatch rather
+	//than in Init, so Init needs no context and only the programs in use are compiled. Call the last Cleanup before the context goes away.
 	void Init();
 	void Cleanup();
 	void VoxelMeshCleanUp(VoxelMesh& mesh);
 	void PrintNumTrisTable();
 	std::vector<float> CreateFlat2DNoiseMap(const int width, const int height, const int depth, const glm::vec2 offset, bool CleanUp);
 	std::vector<float> CreateFlat3DNoiseMap(const int width, const int height, const int depth, const glm::vec3 offset, bool CleanUp, const float amplitude = 1.0f, const float frequency = 1.0f, const float persistance = 0.5f, const float lacunarity = 2.0f, const int octaves = 5, const bool useDropoff = false);
-	void CreateFlat3DNoiseMap(VoxelMesh& mesh, const int width, const int height, const int depth, const glm::vec3 offset, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves, const bool useDropoff);
+	//Densities of every chunk of a batch in one dispatch, at the offsets WriteMarchingCubesChunks put in the chunk table of ab
+	void CreateFlat3DNoiseMap(const std::vector<VoxelMesh*>& meshes, const AppendBuffer& ab, const int width, const int height, const int depth, bool CleanUp, const float amplitude, const float frequency, const float persistance, const float lacunarity, const int octaves, const bool useDropoff);
+	//Classifies the padded density box CreateFlat3DNoiseMap would fill before any dense work, from a coarse grid of samples widened by the
+	//steepest slope of the noise. Air and Solid are certain, Mixed only means a surface couldn't be ruled out. Runs on the CPU with SIMD
+	//regardless of the backend and costs a few percent of the dense densities.
+	ChunkOccupancy ClassifyMarchingCubesChunk(int width, int height, int depth, glm::vec3 offset, float frequency, float isoLevel = 0.0f);
 	void CreateFlat3DNoiseMapPipeLine(BlockIds& blockIDs, const Spline& spline, const int width, const int height, const int depth, const glm::vec3 offset, bool CleanUp, const float frequency = 1.0f, const bool useDropoff = false);
 	void TerrainPaint(BlockIds& blockIDs, int width, int height, int depth);
 
+	//Where CreateHeightMapChunk and VoxelCubesGeometryInit leave the mesh
+	enum class MeshTarget {
+		Cpu, //the vectors of planeData, upload them with UploadPlaneMesh
+		Gpu, //uploaded and drawable with no CPU copy. The GPU backend writes straight into the mesh arena ranges that become the VBOs, the
+		     //CPU backend copies once into the mapped arena and frees its vectors.
+		GpuAndCpu //same, plus the vectors for collision or export, read back from the VBOs on the GPU backend
+	};
+
 	void CreateVertices(PlaneMesh& planeData, int width, int height, glm::ivec2 offset = glm::ivec2(0,0), bool CleanUp = true);
 	void CreateIndices(PlaneMesh& planeData, int width, int height, bool CleanUp);
 	void DisplaceVertices(PlaneMesh& planeData, int width, int height, float scale = 1.0f, float amplitude = 1.0f, float frequency = 1.0f, int octaves = 5, float persistance = 0.5f, float lacunarity = 2.0f, bool CleanUp = true);
 	void InterpolatedNormals(PlaneMesh& planeData, int width, int height, bool CleanUp);
+	//Writes the pNoise value of HeightMapVertexDisplacement.comp for every vertex of a (width+1)x(height+1) plane chunk into noise, row by row.
+	//Runs on the CPU with SIMD regardless of the backend, the caller owns the buffer. apron adds that many vertices of the neighbouring
+	//chunks on every side, the rows are then width + 1 + 2 * apron long.
+	void CreateHeightMapNoise(float* noise, int width, int height, glm::ivec2 offset = glm::ivec2(0,0), float scale = 0.1f, float amplitude = 1.0f, float frequency = 1.0f, int octaves = 5, float persistance = 0.5f, float lacunarity = 2.0f, int apron = 0);
+	//Fills the heights of a shared grid chunk, the same heights CreateHeightMapPlaneMeshGPU displaces its vertices to. CPU only like
+	//CreateHeightMapNoise, so it is safe on worker threads.
+	void CreateHeightMapTexture(HeightMapTexture& chunk, int width, int height, glm::ivec2 offset = glm::ivec2(0,0), float scale = 0.1f, float amplitude = 1.0f, float frequency = 1.0f, int octaves = 5, float persistance = 0.5f, float lacunarity = 2.0f);
+	//Creates the texture from the heights, half floats take 2 bytes per vertex and keep heights below 20 to about a hundredth. Without
+	//keepCpuCopy the heights are freed afterwards. Does nothing for a chunk that is already uploaded.
+	void UploadHeightMapTexture(HeightMapTexture& chunk, bool halfFloat = true, bool keepCpuCopy = false);
+	//The four stages above in one dispatch of HeightMapChunk.comp, with no uploads in between. The normals are central differences over an
+	//apron of one vertex, so they agree across chunk borders. MeshTarget::Cpu reads the mesh back once, MeshTarget::Gpu reads nothing back.
+	void CreateHeightMapChunk(PlaneMesh& planeData, int width, int height, glm::ivec2 offset = glm::ivec2(0,0), float scale = 0.1f, float amplitude = 1.0f, float frequency = 1.0f, int octaves = 5, float persistance = 0.5f, float lacunarity = 2.0f, MeshTarget target = MeshTarget::Cpu);
+	//CreateVertices, CreateIndices, DisplaceVertices and InterpolatedNormals one after the other, so the normals are those of
+	//HeightMapNormal.comp and CreateHeightMapChunk only matches its vertices and indices. CleanUp is kept for existing callers, the programs no
+	//longer go away with the call but stay compiled until the last Cleanup, so regenerating compiles nothing.
 	PlaneMesh CreateHeightMapPlaneMeshGPU(int width, int height, glm::vec2 offset = glm::vec2(0,0), float scale = 0.1f, float amplitude = 1.0f, float frequency = 1.0f, int octaves = 5, float persistance = 0.5f, float lacunarity = 2.0f, bool CleanUp = true);
 	
 	glm::vec3 VertInterp(float iso, glm::vec3 p1, glm::vec3 p2, float v1, float v2);
-	int GetActiveCountFromGPU(AppendBuffer& ab);
-	void SetupAppendBuffer(AppendBuffer& ab, int width, int height, int depth);
-	int CountMarchingCubesTriangleCount(VoxelMesh& mesh, AppendBuffer& ab, int width, int height, int depth, glm::vec3 offset, bool CleanUp, float iso);
-	void InitializeVoxelMesh(VoxelMesh& mesh, int width, int height, int depth);
-	void CreateMarchingCubesTriangles(VoxelMesh& mesh, AppendBuffer& ab, int width, int height, int depth, glm::vec3 offset, bool CleanUp, float iso, int count);
+	//Reads the counter of one chunk back and waits for the GPU, the marching cubes pipeline itself dispatches indirectly and never calls it
+	int GetActiveCountFromGPU(AppendBuffer& ab, int chunk = 0);
+	void SetupAppendBuffer(AppendBuffer& ab, int width, int height, int depth, int chunkCount = 1);
+	//Fills the chunk table of ab, once the meshes have their ranges from InitializeVoxelMeshSize
+	void WriteMarchingCubesChunks(AppendBuffer& ab, const std::vector<VoxelMesh*>& meshes, const std::vector<glm::vec3>& offsets);
+	void ReleaseAppendBuffer(AppendBuffer& ab);
+	//Counts the triangles of every active voxel and prefix sums them into output offsets and the draw counts, all on the GPU without a readback
+	void CountMarchingCubesTriangleCount(const std::vector<VoxelMesh*>& meshes, AppendBuffer& ab, int width, int height, int depth, bool CleanUp, float iso);
+	//Size for InitializeVoxelMeshSize that fits any marching cubes mesh of a padded grid
+	int MarchingCubesMaxSize(int width, int height, int depth);
+	//The marching cubes passes take a batch of meshes whose ranges were allocated together by these two, so each pass binds them as one range
+	void InitializeVoxelMesh(const std::vector<VoxelMesh*>& meshes, int width, int height, int depth);
+	void CreateMarchingCubesTriangles(const std::vector<VoxelMesh*>& meshes, AppendBuffer& ab, int width, int height, int depth, bool CleanUp, float iso, int count);
+	//Indexed output for meshes with indexed set, sized by InitializeVoxelMeshSize. Needs the active voxel lists of PerformSurfaceCulling.
+	void CreateMarchingCubesIndexed(const std::vector<VoxelMesh*>& meshes, AppendBuffer& ab, int width, int height, int depth, float iso);
 	PlaneMesh CreateVoxel2DMesh(int width, int height, int depth, glm::vec2 offset, bool CleanUp);
 	PlaneMesh CreateMarchingCubes3DMesh(int width, int height, int depth, glm::vec3 offset, bool CleanUp);
-	void InitializeVoxelMeshSize(VoxelMesh& mesh, int size);
-	VoxelMesh* CreateMarchingCubes3DMeshGPU(int width, int height, int depth, glm::vec3 offset, bool CleanUp, const float amplitude = 1.0f, const float frequency = 1.0f, const float persistance = 0.5f, const float lacunarity = 2.0f, const int octaves = 5);
+	//maxVertexCount optionally caps the vertices of an indexed mesh below the bound size gives
+	void InitializeVoxelMeshSize(const std::vector<VoxelMesh*>& meshes, int size, int maxVertexCount = -1);
+	//Creates the VAO and the mesh arena ranges of the vertices and indirect draw command from cpuMesh, for meshes generated on the CPU. Needs a GL context.
+	//Indexed meshes get 16-bit indices when they have few enough vertices.
+	void UploadVoxelMesh(VoxelMesh& mesh);
+	//Same with PackedMarchingCubesVertex vertices, the position as normalized ushort3 on attribute 0 and the octahedral normal as normalized
+	//short2 on attribute 1. extent is the chunk size, every vertex must lie within it from origin.
+	void UploadPackedVoxelMesh(VoxelMesh& mesh, glm::vec3 origin, glm::vec3 extent);
+	//Same for a PlaneMesh, with the UVs on attribute 2 when it has them. The arena pages are persistently mapped, so this is one copy into
+	//the VBOs. Without keepCpuCopy the vectors are freed afterwards. Does nothing for a mesh that is already uploaded.
+	void UploadPlaneMesh(PlaneMesh& mesh, bool keepCpuCopy = true);
+	//Same with PackedVoxelVertex vertices for a voxel cubes mesh, both words on attribute 0 as uvec2. origin is the offset the chunk was
+	//meshed at and atlasSize the columns and rows of the atlas its UVs address.
+	void UploadPackedVoxelCubesMesh(PlaneMesh& mesh, glm::vec3 origin, bool tiledUVs, glm::vec2 atlasSize, bool keepCpuCopy = true);
+	VoxelMesh* CreateMarchingCubes3DMeshGPU(int width, int height, int depth, glm::vec3 offset, bool CleanUp, const float amplitude = 1.0f, const float frequency = 1.0f, const float persistance = 0.5f, const float lacunarity = 2.0f, const int octaves = 5, const bool indexed = false);
+	//One mesh per offset, in the same order. The chunks are generated together: noise, surface culling, counting and meshing are one dispatch each
+	//for the whole batch, so warming up many chunks costs a handful of driver calls. Poll every mesh with PollAsyncReadback as for a single one.
+	//Chunks ClassifyMarchingCubesChunk finds to be Air or Solid are left out of the passes and come back ready.
+	std::vector<VoxelMesh*> CreateMarchingCubes3DMeshesGPU(int width, int height, int depth, const std::vector<glm::vec3>& offsets, bool CleanUp, const float amplitude = 1.0f, const float frequency = 1.0f, const float persistance = 0.5f, const float lacunarity = 2.0f, const int octaves = 5, const bool indexed = false);
 	void StartAsyncReadback(VoxelMesh& mesh);
 	bool PollAsyncReadback(VoxelMesh& mesh);
 	
 
-	int VoxelCubesQuadCount(PlaneMesh& planeData, int width, int heigth, int depth, glm::vec3 offset, const BlockIds& blockIDs, bool CleanUp);
-	void VoxelCubesGeometryInit(PlaneMesh& planeData, int width, int heigth, int depth, glm::vec3 offset, const BlockIds& blockIDs, bool CleanUp);
-	VoxelData CreateVoxelCubes3DMesh(int width, int heigth, int depth, glm::vec2 offset, bool CleanUp, const float amplitude = 1.0f, const float frequency = 1.0f, const float persistance = 0.5f, const float lacunarity = 2.0f, const int octaves = 5, const bool useDropoff = true);
+	int VoxelCubesQuadCount(int width, int heigth, int depth, glm::vec3 offset, const BlockIds& blockIDs, bool CleanUp);
+	//Packed chunks are decoded into a scratch BlockIds kept per thread, so meshing a stored chunk allocates nothing after the first call
+	int VoxelCubesQuadCount(int width, int heigth, int depth, glm::vec3 offset, const PalettedBlockIds& blockIDs, bool CleanUp);
+	//Greedy meshing merges coplanar faces with the same block ID into rectangles. A merged quad spans several blocks, so its UVs can't point straight
+	//into the atlas: they hold the atlas tile (column, row) times VoxelAtlasTileStride plus the position on the quad in blocks. Decode per vertex with
+	//tile = floor(uv / VoxelAtlasTileStride), local = uv - tile * VoxelAtlasTileStride and sample (tile + fract(local)) / (columns, rows).
+	//quadCount from VoxelCubesQuadCount is an upper bound for both modes. The CPU backend meshes unmerged faces with column bitmasks and ignores it.
+	constexpr float VoxelAtlasTileStride = 1024.0f;
+	void VoxelCubesGeometryInit(PlaneMesh& planeData, int width, int heigth, int depth, glm::vec3 offset, const BlockIds& blockIDs, int quadCount, bool CleanUp, bool greedy = false, MeshTarget target = MeshTarget::Cpu);
+	void VoxelCubesGeometryInit(PlaneMesh& planeData, int width, int heigth, int depth, glm::vec3 offset, const PalettedBlockIds& blockIDs, int quadCount, bool CleanUp, bool greedy = false, MeshTarget target = MeshTarget::Cpu);
+	//Height curve CreateVoxelCubes3DMesh feeds to CreateFlat3DNoiseMapPipeLine
+	Spline CreateVoxelCubesSpline();
+	VoxelData CreateVoxelCubes3DMesh(int width, int heigth, int depth, glm::vec2 offset, bool CleanUp, const float amplitude = 1.0f, const float frequency = 1.0f, const float persistance = 0.5f, const float lacunarity = 2.0f, const int octaves = 5, const bool useDropoff = true, const bool greedy = false);
 }
\ No newline at end of file
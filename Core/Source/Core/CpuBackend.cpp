@@ -0,0 +1,847 @@
+#include "CpuBackend.h"
+#include "MarchingCubesTables.h"
+#include "SimdNoise.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace Core {
+	namespace Cpu {
+		namespace {
+			const glm::vec3 cornerOffsets[8] = {
+				glm::vec3(0, 0, 0), glm::vec3(1, 0, 0), glm::vec3(1, 0, 1), glm::vec3(0, 0, 1),
+				glm::vec3(0, 1, 0), glm::vec3(1, 1, 0), glm::vec3(1, 1, 1), glm::vec3(0, 1, 1)
+			};
+			//The two cube corners each marching cubes edge connects, in the order the shader fills vertList
+			const int edgeCorners[12][2] = {
+				{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}
+			};
+
+			glm::vec4 Permute(glm::vec4 x) { return glm::mod(((x * 34.0f) + 1.0f) * x, 289.0f); }
+			glm::vec3 Permute(glm::vec3 x) { return glm::mod(((x * 34.0f) + 1.0f) * x, 289.0f); }
+			glm::vec4 TaylorInvSqrt(glm::vec4 r) { return 1.79284291400159f - 0.85373472095314f * r; }
+
+			float ValueNoise(glm::vec2 p, float freq) {
+				const float PI = 3.1415f;
+				float unit = 1.0f / freq;
+				glm::vec2 ij = glm::floor(p / unit);
+				glm::vec2 xy = glm::fract(p / unit);
+				xy = 0.5f * (1.0f - glm::cos(PI * xy));
+				float a = Rand(ij + glm::vec2(0.0f, 0.0f));
+				float b = Rand(ij + glm::vec2(1.0f, 0.0f));
+				float c = Rand(ij + glm::vec2(0.0f, 1.0f));
+				float d = Rand(ij + glm::vec2(1.0f, 1.0f));
+				float x1 = glm::mix(a, b, xy.x);
+				float x2 = glm::mix(c, d, xy.x);
+				return glm::mix(x1, x2, xy.y);
+			}
+
+			int FlatIndex(int x, int y, int z, int width, int height) {
+				return x + y * width + z * width * height;
+			}
+
+			//Central difference of the density at a lattice point, one sided on the border of the grid
+			glm::vec3 DensityGradient(const std::vector<float>& densities, glm::ivec3 p, int width, int height, int depth) {
+				glm::ivec3 size(width, height, depth);
+				glm::vec3 gradient;
+				for (int axis = 0; axis < 3; axis++) {
+					glm::ivec3 lo = p;
+					glm::ivec3 hi = p;
+					lo[axis] = std::max(p[axis] - 1, 0);
+					hi[axis] = std::min(p[axis] + 1, size[axis] - 1);
+					gradient[axis] = (densities[FlatIndex(hi.x, hi.y, hi.z, width, height)] - densities[FlatIndex(lo.x, lo.y, lo.z, width, height)]) / float(hi[axis] - lo[axis]);
+				}
+				return gradient;
+			}
+
+			//Interpolation factor from v1 to v2 with the same edge cases as VertInterp
+			float EdgeMu(float iso, float v1, float v2) {
+				if (std::abs(iso - v1) < 0.00001f)
+					return 0.0f;
+				if (std::abs(iso - v2) < 0.00001f)
+					return 1.0f;
+				if (std::abs(v1 - v2) < 0.00001f)
+					return 0.0f;
+				return (iso - v1) / (v2 - v1);
+			}
+
+			bool IsSolid(const BlockIds& blockIDs, int x, int y, int z, int width, int height) {
+				return blockIDs.IDs[FlatIndex(x, y, z, width, height)] >= 0;
+			}
+
+			//Face order, corners, normals and atlas column match VoxelCubesGeometryInit.comp: +x, -x, +y, -y, +z, -z
+			const glm::ivec3 faceDirections[6] = { glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0), glm::ivec3(0, 1, 0), glm::ivec3(0, -1, 0), glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1) };
+			const int faceCorners[6][4] = { {1, 5, 6, 2}, {3, 7, 4, 0}, {4, 7, 6, 5}, {1, 2, 3, 0}, {2, 6, 7, 3}, {0, 4, 5, 1} };
+			const float faceColumns[6] = { 1.0f, 1.0f, 0.0f, 2.0f, 1.0f, 1.0f };
+
+			//One block face with the atlas UVs of VoxelCubesGeometryInit.comp, written to quad slot quad of already sized buffers
+			void WriteFaceQuad(PlaneMesh& planeData, int quad, glm::vec3 base, int face, int id, float columns, float rows) {
+				int index = quad * 4;
+				glm::vec3 normal = glm::vec3(faceDirections[face]);
+				for (int c = 0; c < 4; c++) {
+					planeData.vertices[index + c] = base + cornerOffsets[faceCorners[face][c]];
+					planeData.normals[index + c] = normal;
+				}
+
+				float tileW = 1.0f / columns;
+				float tileH = 1.0f / rows;
+				int rowFromBottom = 16 - id;
+				float u_0 = faceColumns[face] * tileW;
+				float v_0 = rowFromBottom * tileH;
+				float u_1 = u_0 + tileW;
+				float v_1 = v_0 + tileH;
+				planeData.UVs[index + 0] = glm::vec2(u_0, v_0);
+				planeData.UVs[index + 1] = glm::vec2(u_0, v_1);
+				planeData.UVs[index + 2] = glm::vec2(u_1, v_1);
+				planeData.UVs[index + 3] = glm::vec2(u_1, v_0);
+
+				int* indices = &planeData.indices[quad * 6];
+				indices[0] = index;
+				indices[1] = index + 1;
+				indices[2] = index + 2;
+				indices[3] = index;
+				indices[4] = index + 2;
+				indices[5] = index + 3;
+			}
+
+			void ResizeQuads(PlaneMesh& planeData, int quadCount) {
+				planeData.vertices.resize(quadCount * 4);
+				planeData.normals.resize(quadCount * 4);
+				planeData.indices.resize(quadCount * 6);
+				planeData.UVs.resize(quadCount * 4);
+			}
+
+			//Solidity of a padded block grid as bitmasks. Every line of blocks along x (one per y and z) is packed into 64-bit words, so the
+			//exposed faces of a whole line are found against its neighbours with a few shifts, ANDs and NOTs instead of six lookups per block.
+			struct SolidLines {
+				int width = 0;
+				int height = 0;
+				int depth = 0;
+				int words = 0; //per line
+				std::vector<uint64_t> solid; //[z * height + y][word], in the memory order of the IDs
+				std::vector<uint64_t> interior; //bits 1 to width - 2, the blocks the meshers emit
+			};
+
+			//Bit x of the result is set when IDs[x] is air (negative), for up to 64 IDs
+			uint64_t PackAir(const int* ids, int count) {
+				uint64_t bits = 0;
+				int x = 0;
+#if defined(__SSE2__) || defined(_M_X64)
+				//The sign bits of four IDs at once
+				for (; x + 4 <= count; x += 4)
+					bits |= (uint64_t)_mm_movemask_ps(_mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(ids + x)))) << x;
+#endif
+				for (; x < count; x++)
+					bits |= (uint64_t)(ids[x] < 0) << x;
+				return bits;
+			}
+
+			void BuildSolidLines(SolidLines& grid, const BlockIds& blockIDs, int width, int height, int depth) {
+				int words = (width + 63) / 64;
+				int lines = height * depth;
+				grid.width = width;
+				grid.height = height;
+				grid.depth = depth;
+				grid.words = words;
+				grid.solid.resize((size_t)lines * words);
+				for (int line = 0; line < lines; line++) {
+					const int* row = &blockIDs.IDs[(size_t)line * width];
+					for (int word = 0; word < words; word++) {
+						int count = std::min(64, width - word * 64);
+						uint64_t valid = count == 64 ? ~0ull : (1ull << count) - 1;
+						grid.solid[(size_t)line * words + word] = ~PackAir(row + word * 64, count) & valid;
+					}
+				}
+
+				grid.interior.assign(words, 0);
+				for (int x = 1; x < width - 1; x++)
+					grid.interior[x / 64] |= 1ull << (x & 63);
+			}
+
+			//Exposed faces of one word of an interior line, in the face order of faceDirections. Returns false for a word without blocks.
+			bool LineFaces(const SolidLines& grid, int line, int w, uint64_t faces[6]) {
+				int words = grid.words;
+				const uint64_t* s = &grid.solid[(size_t)line * words];
+				uint64_t blocks = s[w] & grid.interior[w];
+				if (!blocks)
+					return false;
+				//Solidity of the block after and before every bit along x, carried over the word boundaries
+				uint64_t next = (s[w] >> 1) | (w + 1 < words ? s[w + 1] << 63 : 0);
+				uint64_t previous = (s[w] << 1) | (w > 0 ? s[w - 1] >> 63 : 0);
+				faces[0] = blocks & ~next;
+				faces[1] = blocks & ~previous;
+				faces[2] = blocks & ~s[w + words];
+				faces[3] = blocks & ~s[w - words];
+				faces[4] = blocks & ~s[w + (size_t)grid.height * words];
+				faces[5] = blocks & ~s[w - (size_t)grid.height * words];
+				return true;
+			}
+
+			int CountFaces(const SolidLines& grid) {
+				int count = 0;
+				uint64_t faces[6];
+				for (int z = 1; z < grid.depth - 1; ++z) {
+					for (int y = 1; y < grid.height - 1; ++y) {
+						for (int w = 0; w < grid.words; w++) {
+							if (!LineFaces(grid, z * grid.height + y, w, faces))
+								continue;
+							for (int face = 0; face < 6; face++)
+								count += std::popcount(faces[face]);
+						}
+					}
+				}
+				return count;
+			}
+		}
+
+		float Rand(glm::vec2 n) {
+			return glm::fract(std::sin(glm::dot(n, glm::vec2(127.1f, 311.7f))) * 43758.5453123f);
+		}
+
+		float SimplexNoise(glm::vec2 v) {
+			const glm::vec4 C(0.211324865405187f, 0.366025403784439f, -0.577350269189626f, 0.024390243902439f);
+			glm::vec2 i = glm::floor(v + glm::dot(v, glm::vec2(C.y)));
+			glm::vec2 x0 = v - i + glm::dot(i, glm::vec2(C.x));
+			glm::vec2 i1 = (x0.x > x0.y) ? glm::vec2(1.0f, 0.0f) : glm::vec2(0.0f, 1.0f);
+			glm::vec4 x12 = glm::vec4(x0.x, x0.y, x0.x, x0.y) + glm::vec4(C.x, C.x, C.z, C.z);
+			x12.x -= i1.x;
+			x12.y -= i1.y;
+			i = glm::mod(i, 289.0f);
+			glm::vec3 p = Permute(Permute(i.y + glm::vec3(0.0f, i1.y, 1.0f))
+				+ i.x + glm::vec3(0.0f, i1.x, 1.0f));
+			glm::vec3 m = glm::max(0.5f - glm::vec3(glm::dot(x0, x0), x12.x * x12.x + x12.y * x12.y,
+				x12.z * x12.z + x12.w * x12.w), 0.0f);
+			m = m * m;
+			m = m * m;
+			glm::vec3 x = 2.0f * glm::fract(p * C.w) - 1.0f;
+			glm::vec3 h = glm::abs(x) - 0.5f;
+			glm::vec3 ox = glm::floor(x + 0.5f);
+			glm::vec3 a0 = x - ox;
+			m *= 1.79284291400159f - 0.85373472095314f * (a0 * a0 + h * h);
+			glm::vec3 g;
+			g.x = a0.x * x0.x + h.x * x0.y;
+			g.y = a0.y * x12.x + h.y * x12.y;
+			g.z = a0.z * x12.z + h.z * x12.w;
+			return 130.0f * glm::dot(m, g);
+		}
+
+		float SimplexNoise(glm::vec3 v) {
+			const glm::vec2 C(1.0f / 6.0f, 1.0f / 3.0f);
+			const glm::vec4 D(0.0f, 0.5f, 1.0f, 2.0f);
+
+			// First corner
+			glm::vec3 i = glm::floor(v + glm::dot(v, glm::vec3(C.y)));
+			glm::vec3 x0 = v - i + glm::dot(i, glm::vec3(C.x));
+
+			// Other corners
+			glm::vec3 g = glm::step(glm::vec3(x0.y, x0.z, x0.x), x0);
+			glm::vec3 l = 1.0f - g;
+			glm::vec3 i1 = glm::min(g, glm::vec3(l.z, l.x, l.y));
+			glm::vec3 i2 = glm::max(g, glm::vec3(l.z, l.x, l.y));
+
+			glm::vec3 x1 = x0 - i1 + 1.0f * C.x;
+			glm::vec3 x2 = x0 - i2 + 2.0f * C.x;
+			glm::vec3 x3 = x0 - 1.0f + 3.0f * C.x;
+
+			// Permutations
+			i = glm::mod(i, 289.0f);
+			glm::vec4 p = Permute(Permute(Permute(
+				i.z + glm::vec4(0.0f, i1.z, i2.z, 1.0f))
+				+ i.y + glm::vec4(0.0f, i1.y, i2.y, 1.0f))
+				+ i.x + glm::vec4(0.0f, i1.x, i2.x, 1.0f));
+
+			// Gradients
+			float n_ = 1.0f / 7.0f;
+			glm::vec3 ns = n_ * glm::vec3(D.w, D.y, D.z) - glm::vec3(D.x, D.z, D.x);
+
+			glm::vec4 j = p - 49.0f * glm::floor(p * ns.z * ns.z);
+
+			glm::vec4 x_ = glm::floor(j * ns.z);
+			glm::vec4 y_ = glm::floor(j - 7.0f * x_);
+
+			glm::vec4 x = x_ * ns.x + ns.y;
+			glm::vec4 y = y_ * ns.x + ns.y;
+			glm::vec4 h = 1.0f - glm::abs(x) - glm::abs(y);
+
+			glm::vec4 b0(x.x, x.y, y.x, y.y);
+			glm::vec4 b1(x.z, x.w, y.z, y.w);
+
+			glm::vec4 s0 = glm::floor(b0) * 2.0f + 1.0f;
+			glm::vec4 s1 = glm::floor(b1) * 2.0f + 1.0f;
+			glm::vec4 sh = -glm::step(h, glm::vec4(0.0f));
+
+			glm::vec4 a0 = glm::vec4(b0.x, b0.z, b0.y, b0.w) + glm::vec4(s0.x, s0.z, s0.y, s0.w) * glm::vec4(sh.x, sh.x, sh.y, sh.y);
+			glm::vec4 a1 = glm::vec4(b1.x, b1.z, b1.y, b1.w) + glm::vec4(s1.x, s1.z, s1.y, s1.w) * glm::vec4(sh.z, sh.z, sh.w, sh.w);
+
+			glm::vec3 p0(a0.x, a0.y, h.x);
+			glm::vec3 p1(a0.z, a0.w, h.y);
+			glm::vec3 p2(a1.x, a1.y, h.z);
+			glm::vec3 p3(a1.z, a1.w, h.w);
+
+			// Normalise gradients
+			glm::vec4 norm = TaylorInvSqrt(glm::vec4(glm::dot(p0, p0), glm::dot(p1, p1), glm::dot(p2, p2), glm::dot(p3, p3)));
+			p0 *= norm.x;
+			p1 *= norm.y;
+			p2 *= norm.z;
+			p3 *= norm.w;
+
+			// Mix final noise value
+			glm::vec4 m = glm::max(0.6f - glm::vec4(glm::dot(x0, x0), glm::dot(x1, x1), glm::dot(x2, x2), glm::dot(x3, x3)), 0.0f);
+			m = m * m;
+			return 42.0f * glm::dot(m * m, glm::vec4(glm::dot(p0, x0), glm::dot(p1, x1), glm::dot(p2, x2), glm::dot(p3, x3)));
+		}
+
+		float PNoise(glm::vec2 p, float amplitude, float frequency, int octaves, float persistance, float lacunarity) {
+			float n = 0.0f;
+			float normK = 0.0f;
+			float f = frequency;
+			float amp = 1.0f;
+			for (int i = 0; i < octaves; i++) {
+				n += amp * ValueNoise(p, f);
+				f *= lacunarity;
+				normK += amp / amplitude;
+				amp *= persistance;
+			}
+			float nf = n / normK;
+			return nf * nf * nf * nf;
+		}
+
+		float SampleCurve(const Spline& spline, float noiseValue) {
+			const std::vector<SplinePoint>& points = spline.points;
+			if (noiseValue <= points[0].position.x)
+				return points[0].position.y;
+
+			size_t last = points.size() - 1;
+			if (noiseValue >= points[last].position.x)
+				return points[last].position.y;
+
+			for (size_t i = 0; i < last; i++) {
+				if (noiseValue >= points[i].position.x && noiseValue < points[i + 1].position.x) {
+					float t = (noiseValue - points[i].position.x) / (points[i + 1].position.x - points[i].position.x);
+					return glm::mix(points[i].position.y, points[i + 1].position.y, t);
+				}
+			}
+			return points[last].position.y;
+		}
+
+		void CreateVertices(PlaneMesh& planeData, int width, int height, glm::ivec2 offset) {
+			planeData.vertices.resize((width + 1) * (height + 1));
+			float xScale = 100.0f / width;
+			float zScale = 100.0f / height;
+			for (int z = 0; z <= height; ++z) {
+				for (int x = 0; x <= width; ++x) {
+					float xPos = x * xScale + (offset.x * width) * xScale;
+					float zPos = z * zScale + (offset.y * height) * zScale;
+					planeData.vertices[z * (width + 1) + x] = glm::vec3(xPos, 0.0f, zPos);
+				}
+			}
+		}
+
+		void CreateIndices(PlaneMesh& planeData, int width, int height) {
+			planeData.indices.resize(width * height * 6);
+			for (int z = 0; z < height; ++z) {
+				for (int x = 0; x < width; ++x) {
+					int v0 = x + z * (width + 1);
+					int v1 = (x + 1) + z * (width + 1);
+					int v2 = x + (z + 1) * (width + 1);
+					int v3 = (x + 1) + (z + 1) * (width + 1);
+
+					int base = (z * width + x) * 6;
+					planeData.indices[base + 0] = v0;
+					planeData.indices[base + 1] = v2;
+					planeData.indices[base + 2] = v1;
+
+					planeData.indices[base + 3] = v1;
+					planeData.indices[base + 4] = v2;
+					planeData.indices[base + 5] = v3;
+				}
+			}
+		}
+
+		void DisplaceVertices(PlaneMesh& planeData, int width, int height, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity) {
+			//The plane from CreateVertices is a regular grid, so x only depends on the column and z on the row
+			int row = width + 1;
+			std::vector<float> xs(row), zs(height + 1), noise(size_t(row) * (height + 1));
+			for (int x = 0; x <= width; ++x)
+				xs[x] = planeData.vertices[x].x * scale;
+			for (int z = 0; z <= height; ++z)
+				zs[z] = planeData.vertices[z * row].z * scale;
+			PNoiseGrid(noise.data(), xs.data(), row, zs.data(), height + 1, amplitude, frequency, octaves, persistance, lacunarity);
+
+			for (size_t i = 0; i < noise.size(); i++)
+				planeData.vertices[i].y = 20 * noise[i];
+		}
+
+		void InterpolatedNormals(PlaneMesh& planeData, int width, int height) {
+			planeData.normals.resize(planeData.vertices.size());
+			const std::vector<glm::vec3>& p = planeData.vertices;
+			int row = width + 1;
+			for (int z = 0; z <= height; ++z) {
+				for (int x = 0; x <= width; ++x) {
+					int i = z * row + x;
+					glm::vec3 v0 = p[i];
+					glm::vec3 normal;
+					//Same corner/edge cases as HeightMapNormal.comp
+					if (x == 0 && z == 0) {
+						normal = glm::normalize(glm::cross(p[i + row] - p[i + 1], p[i + 1] - v0));
+					}
+					else if (x == width && z == 0) {
+						glm::vec3 v1 = p[i + row], v2 = p[i - 1], v3 = p[i - 1 + row];
+						normal = glm::normalize(glm::normalize(glm::cross(v3 - v1, v1 - v0)) + glm::normalize(glm::cross(v2 - v3, v3 - v0)));
+					}
+					else if (x == 0 && z == height) {
+						glm::vec3 v1 = p[i - row], v2 = p[i + 1], v3 = p[i + 1 - row];
+						normal = glm::normalize(glm::normalize(glm::cross(v3 - v1, v1 - v0)) + glm::normalize(glm::cross(v2 - v3, v3 - v0)));
+					}
+					else if (x == width && z == height) {
+						normal = glm::normalize(glm::cross(p[i - row] - p[i - 1], p[i - 1] - v0));
+					}
+					else if (x == 0 || x == width || z == 0 || z == height) {
+						glm::vec3 v1, v2, v3, v4;
+						if (x == 0) { v1 = p[i - row]; v2 = p[i + 1 - row]; v3 = p[i + 1]; v4 = p[i + row]; }
+						else if (x == width) { v1 = p[i + row]; v2 = p[i - 1 + row]; v3 = p[i - 1]; v4 = p[i - row]; }
+						else if (z == 0) { v1 = p[i + 1]; v2 = p[i + row]; v3 = p[i - 1 + row]; v4 = p[i - 1]; }
+						else { v1 = p[i - 1]; v2 = p[i - row]; v3 = p[i + 1 - row]; v4 = p[i + 1]; }
+						glm::vec3 normal1 = glm::normalize(glm::cross(v2 - v1, v1 - v0));
+						glm::vec3 normal2 = glm::normalize(glm::cross(v3 - v2, v2 - v0));
+						glm::vec3 normal3 = glm::normalize(glm::cross(v4 - v3, v3 - v0));
+						normal = glm::normalize(normal1 + normal2 + normal3);
+					}
+					else {
+						glm::vec3 v1 = p[i + row], v2 = p[i + 1], v3 = p[i + 1 - row];
+						glm::vec3 v4 = p[i - row], v5 = p[i - 1], v6 = p[i - 1 + row];
+						glm::vec3 normal1 = glm::normalize(glm::cross(v1 - v0, v2 - v0));
+						glm::vec3 normal2 = glm::normalize(glm::cross(v2 - v3, v3 - v0));
+						glm::vec3 normal3 = glm::normalize(glm::cross(v3 - v4, v4 - v0));
+						glm::vec3 normal4 = glm::normalize(glm::cross(v4 - v5, v5 - v0));
+						glm::vec3 normal5 = glm::normalize(glm::cross(v5 - v6, v6 - v0));
+						glm::vec3 normal6 = glm::normalize(glm::cross(v6 - v1, v1 - v0));
+						normal = glm::normalize(normal1 + normal2 + normal3 + normal4 + normal5 + normal6);
+					}
+					planeData.normals[i] = normal;
+				}
+			}
+		}
+
+		void CreateHeightMapChunk(PlaneMesh& planeData, int width, int height, glm::ivec2 offset, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity) {
+			Cpu::CreateVertices(planeData, width, height, offset);
+			Cpu::CreateIndices(planeData, width, height);
+			//Heights with an apron of one vertex, rows of width + 3
+			int row = width + 3;
+			std::vector<float> heights(size_t(row) * (height + 3));
+			CreateHeightMapNoise(heights.data(), width, height, offset, scale, amplitude, frequency, octaves, persistance, lacunarity, 1);
+			planeData.normals.resize(planeData.vertices.size());
+			for (int z = 0; z <= height; ++z) {
+				for (int x = 0; x <= width; ++x) {
+					const float* h = &heights[(z + 1) * row + x + 1];
+					float dx = 20 * (h[1] - h[-1]);
+					float dz = 20 * (h[row] - h[-row]);
+					int i = z * (width + 1) + x;
+					planeData.vertices[i].y = 20 * h[0];
+					planeData.normals[i] = glm::normalize(glm::vec3(-dx * width / 200.0f, 1.0f, -dz * height / 200.0f));
+				}
+			}
+		}
+
+		void CreateFlat3DNoiseMap(std::vector<float>& densities, int width, int height, int depth, glm::vec3 offset, float frequency) {
+			densities.resize(width * height * depth);
+			for (int z = 0; z < depth; ++z) {
+				for (int y = 0; y < height; ++y) {
+					SimplexNoiseRow(&densities[FlatIndex(0, y, z, width, height)], width, glm::ivec3(0, y, z), offset, frequency);
+				}
+			}
+		}
+
+		void CreateFlat3DNoiseMapPipeLine(BlockIds& blockIDs, const Spline& spline, int width, int height, int depth, glm::vec3 offset, float frequency, bool useDropoff) {
+			blockIDs.IDs.resize(width * height * depth);
+			const glm::vec3 cheeseSeed = glm::vec3(-723.0f, 409.0f, 122.0f);
+			const glm::vec3 seed1 = glm::vec3(100.0f, 200.0f, 300.0f);
+			const glm::vec3 seed2 = glm::vec3(-300.0f, 500.0f, 700.0f);
+			const glm::vec3 seed3 = glm::vec3(270.0f, -139.0f, -568.0f);
+			const float threshHold = 0.09f;
+
+			//One column of y values is evaluated per batch, so the 3D noise runs through the vectorized kernel
+			std::vector<float> xs(height), ys(height), zs(height);
+			std::vector<float> terrainNoise(height), cheeseNoise(height), caveNoise1(height), caveNoise2(height), caveNoise3(height);
+			auto noiseColumn = [&](std::vector<float>& out, glm::vec3 position, float yScale, glm::vec3 seed, float scale) {
+				for (int y = 0; y < height; ++y) {
+					float py = ((y + offset.y) / float(height)) * yScale;
+					xs[y] = (position.x + seed.x) * frequency * scale;
+					ys[y] = (py + seed.y) * frequency * scale;
+					zs[y] = (position.z + seed.z) * frequency * scale;
+				}
+				SimplexNoiseBatch(xs.data(), ys.data(), zs.data(), out.data(), height);
+			};
+
+			for (int z = 0; z < depth; ++z) {
+				for (int x = 0; x < width; ++x) {
+					//The height map and spline only depend on x and z, so they are evaluated once per column
+					glm::vec2 planePosition = glm::vec2((x + offset.x) / float(width), (z + offset.z) / float(depth));
+					float heightMap = SimplexNoise(planePosition * frequency * 0.1f);
+					heightMap = (heightMap + 0.9f) / (2.0f * 0.9f);
+					float splineSample = SampleCurve(spline, heightMap);
+
+					glm::vec3 position = glm::vec3(planePosition.x, 0.0f, planePosition.y);
+					//The terrain noise uses the plain position, the cave noises the y-stretched uniform position
+					noiseColumn(terrainNoise, position, 1.0f, glm::vec3(0.0f), 1.0f);
+					noiseColumn(cheeseNoise, position, float(width), cheeseSeed, 3.5f);
+					noiseColumn(caveNoise1, position, float(width), seed1, 1.4f);
+					noiseColumn(caveNoise2, position, float(width), seed2, 1.4f);
+					noiseColumn(caveNoise3, position, float(width), seed3, 1.4f);
+
+					for (int y = 0; y < height; ++y) {
+						float t = float(y) / float(height);
+						float terrainValue = (terrainNoise[y] + 0.9f) / (2.0f * 0.9f) * (splineSample);
+						if (useDropoff) {
+							float falloffBase = (1.0f / (1.0f + std::exp((t - 0.5f) * 7.0f))) * 2.0f - 1.0f;
+							terrainValue += falloffBase;
+						}
+
+						float q = glm::clamp(1.0f - t, 0.0f, 1.0f);
+						float cheeseCaveNoiseNormalized = (cheeseNoise[y] + 0.9f) / (2.0f * 0.9f);
+						float cheeseCaves = cheeseCaveNoiseNormalized + std::pow(t, 0.5f);
+
+						float caveStringValue1 = caveNoise1[y] * std::pow(q, 0.5f);
+						float caveStringValue2 = caveNoise2[y] * std::pow(q, 0.5f);
+						float caveStringValue3 = caveNoise3[y] * std::pow(q, 0.5f);
+
+						float combinedCaveString = ((std::abs(caveStringValue1) < threshHold && std::abs(caveStringValue2) < threshHold)
+							|| (std::abs(caveStringValue1) < threshHold && std::abs(caveStringValue3) < threshHold)) ? -5.0f : 0.0f;
+						float combinedCheeseCave = (cheeseCaves < 0.5f) ? -5.0f : 0.0f;
+						blockIDs.IDs[FlatIndex(x, y, z, width, height)] = terrainValue + combinedCaveString + combinedCheeseCave > 0.5f ? 1 : -1;
+					}
+				}
+			}
+		}
+
+		void TerrainPaint(BlockIds& blockIDs, int width, int height, int depth) {
+			int size = (int)blockIDs.IDs.size();
+			//The shader reads past the top of a column into the next z slice, and past the end of the buffer where robust access returns 0 (solid)
+			auto isSolid = [&](int index) { return index >= size || blockIDs.IDs[index] >= 0; };
+			for (int z = 0; z < depth; ++z) {
+				for (int y = 0; y < height; ++y) {
+					for (int x = 0; x < width; ++x) {
+						int index = FlatIndex(x, y, z, width, height);
+						if (!isSolid(index) || !isSolid(index + width))
+							continue;
+						int id = 3;
+						for (int i = 1; i < 5; i++) {
+							if (!isSolid(index + i * width)) { id = 2; break; }
+						}
+						blockIDs.IDs[index] = id;
+					}
+				}
+			}
+		}
+
+		void PerformSurfaceCulling(const std::vector<float>& densities, std::vector<uint32_t>& activeVoxels, int width, int height, int depth, float isoLevel) {
+			activeVoxels.clear();
+			for (int z = 0; z < depth - 1; ++z) {
+				for (int y = 0; y < height - 1; ++y) {
+					for (int x = 0; x < width - 1; ++x) {
+						int cubeIndex = 0;
+						for (int i = 0; i < 8; i++) {
+							glm::ivec3 corner = glm::ivec3(x, y, z) + glm::ivec3(cornerOffsets[i]);
+							if (densities[FlatIndex(corner.x, corner.y, corner.z, width, height)] < isoLevel)
+								cubeIndex |= (1 << i);
+						}
+						if (edgeTable[cubeIndex] != 0)
+							activeVoxels.push_back(uint32_t(x) | (uint32_t(y) << 10) | (uint32_t(z) << 20));
+					}
+				}
+			}
+		}
+
+		int CountMarchingCubesTriangleCount(const std::vector<float>& densities, const std::vector<uint32_t>& activeVoxels, int width, int height, float isoLevel) {
+			int count = 0;
+			for (uint32_t packedID : activeVoxels) {
+				glm::ivec3 pos(packedID & 0x3FF, (packedID >> 10) & 0x3FF, (packedID >> 20) & 0x3FF);
+				int cubeIndex = 0;
+				for (int i = 0; i < 8; i++) {
+					glm::ivec3 corner = pos + glm::ivec3(cornerOffsets[i]);
+					if (densities[FlatIndex(corner.x, corner.y, corner.z, width, height)] < isoLevel)
+						cubeIndex |= (1 << i);
+				}
+				if (edgeTable[cubeIndex] == 0)
+					continue;
+				//Same unit as the GPU counter: 9 floats (3 vertices) per triangle
+				for (int q = 0; FlatTriTable[cubeIndex * 16 + q] != -1; q += 3)
+					count += 9;
+			}
+			return count;
+		}
+
+		void CreateMarchingCubesTriangles(CpuVoxelMesh& mesh, const std::vector<float>& densities, const std::vector<uint32_t>& activeVoxels, int width, int height, glm::vec3 offset, float isoLevel) {
+			mesh.vertices.clear();
+			mesh.normals.clear();
+			for (uint32_t packedID : activeVoxels) {
+				glm::ivec3 pos(packedID & 0x3FF, (packedID >> 10) & 0x3FF, (packedID >> 20) & 0x3FF);
+				glm::vec3 cubeCorners[8];
+				float cubeValues[8];
+				int cubeIndex = 0;
+				for (int i = 0; i < 8; i++) {
+					glm::vec3 cornerPos = glm::vec3(pos) + cornerOffsets[i];
+					cubeCorners[i] = cornerPos + offset;
+					cubeValues[i] = densities[FlatIndex((int)cornerPos.x, (int)cornerPos.y, (int)cornerPos.z, width, height)];
+					if (cubeValues[i] < isoLevel)
+						cubeIndex |= (1 << i);
+				}
+				if (edgeTable[cubeIndex] == 0)
+					continue;
+
+				glm::vec3 vertList[12];
+				for (int e = 0; e < 12; e++) {
+					if ((edgeTable[cubeIndex] & (1 << e)) != 0) {
+						int a = edgeCorners[e][0];
+						int b = edgeCorners[e][1];
+						vertList[e] = VertInterp(isoLevel, cubeCorners[a], cubeCorners[b], cubeValues[a], cubeValues[b]);
+					}
+				}
+
+				for (int q = 0; FlatTriTable[cubeIndex * 16 + q] != -1; q += 3) {
+					glm::vec3 v0 = vertList[FlatTriTable[cubeIndex * 16 + q]];
+					glm::vec3 v1 = vertList[FlatTriTable[cubeIndex * 16 + q + 1]];
+					glm::vec3 v2 = vertList[FlatTriTable[cubeIndex * 16 + q + 2]];
+					glm::vec3 normal = glm::normalize(glm::cross(v1 - v0, v2 - v0));
+
+					mesh.vertices.push_back(v0);
+					mesh.vertices.push_back(v1);
+					mesh.vertices.push_back(v2);
+					mesh.normals.push_back(normal);
+					mesh.normals.push_back(normal);
+					mesh.normals.push_back(normal);
+				}
+			}
+		}
+
+		void CreateMarchingCubesIndexed(CpuVoxelMesh& mesh, const std::vector<float>& densities, const std::vector<uint32_t>& activeVoxels, int width, int height, int depth, glm::vec3 offset, float isoLevel) {
+			mesh.vertices.clear();
+			mesh.normals.clear();
+			mesh.indices.clear();
+			//Vertex of every lattice edge, keyed by the lower corner of the edge and its axis, so the up to four cubes around an edge share it
+			std::vector<int> edgeVertices((size_t)width * height * depth * 3, -1);
+			for (uint32_t packedID : activeVoxels) {
+				glm::ivec3 pos(packedID & 0x3FF, (packedID >> 10) & 0x3FF, (packedID >> 20) & 0x3FF);
+				int cubeIndex = 0;
+				for (int i = 0; i < 8; i++) {
+					glm::ivec3 corner = pos + glm::ivec3(cornerOffsets[i]);
+					if (densities[FlatIndex(corner.x, corner.y, corner.z, width, height)] < isoLevel)
+						cubeIndex |= (1 << i);
+				}
+				if (edgeTable[cubeIndex] == 0)
+					continue;
+
+				int vertList[12];
+				for (int e = 0; e < 12; e++) {
+					if ((edgeTable[cubeIndex] & (1 << e)) == 0)
+						continue;
+					glm::ivec3 a = pos + glm::ivec3(cornerOffsets[edgeCorners[e][0]]);
+					glm::ivec3 b = pos + glm::ivec3(cornerOffsets[edgeCorners[e][1]]);
+					glm::ivec3 lo = glm::min(a, b);
+					glm::ivec3 hi = glm::max(a, b);
+					int axis = hi.x != lo.x ? 0 : (hi.y != lo.y ? 1 : 2);
+					int& vertex = edgeVertices[(size_t)FlatIndex(lo.x, lo.y, lo.z, width, height) * 3 + axis];
+					if (vertex < 0) {
+						float mu = EdgeMu(isoLevel, densities[FlatIndex(lo.x, lo.y, lo.z, width, height)], densities[FlatIndex(hi.x, hi.y, hi.z, width, height)]);
+						glm::vec3 gradient = glm::mix(DensityGradient(densities, lo, width, height, depth), DensityGradient(densities, hi, width, height, depth), mu);
+						//Points up the gradient, the same side the triangle winding faces
+						float length = glm::length(gradient);
+						vertex = (int)mesh.vertices.size();
+						mesh.vertices.push_back(glm::mix(glm::vec3(lo), glm::vec3(hi), mu) + offset);
+						mesh.normals.push_back(length > 0.0f ? gradient / length : glm::vec3(0.0f, 1.0f, 0.0f));
+					}
+					vertList[e] = vertex;
+				}
+
+				for (int q = 0; FlatTriTable[cubeIndex * 16 + q] != -1; q++)
+					mesh.indices.push_back((uint32_t)vertList[FlatTriTable[cubeIndex * 16 + q]]);
+			}
+		}
+
+		int VoxelCubesQuadCount(int width, int height, int depth, const BlockIds& blockIDs) {
+			SolidLines grid;
+			BuildSolidLines(grid, blockIDs, width, height, depth);
+			return CountFaces(grid);
+		}
+
+		void VoxelCubesGeometryInit(PlaneMesh& planeData, int width, int height, int depth, glm::vec3 offset, const BlockIds& blockIDs, int quadCount, float columns, float rows) {
+			ResizeQuads(planeData, quadCount);
+
+			int quad = 0;
+			for (int z = 1; z < depth - 1; ++z) {
+				for (int y = 1; y < height - 1; ++y) {
+					for (int x = 1; x < width - 1; ++x) {
+						if (!IsSolid(blockIDs, x, y, z, width, height))
+							continue;
+						glm::vec3 base = glm::vec3(x, y, z) + offset;
+						int id = blockIDs.IDs[FlatIndex(x, y, z, width, height)];
+						for (int face = 0; face < 6; face++) {
+							glm::ivec3 n = glm::ivec3(x, y, z) + faceDirections[face];
+							if (IsSolid(blockIDs, n.x, n.y, n.z, width, height))
+								continue;
+							if (quad == (int)planeData.vertices.size() / 4)
+								ResizeQuads(planeData, std::max(quad * 2, 64));
+							WriteFaceQuad(planeData, quad++, base, face, id, columns, rows);
+						}
+					}
+				}
+			}
+			ResizeQuads(planeData, quad);
+		}
+
+		void VoxelCubesBinaryGeometryInit(PlaneMesh& planeData, int width, int height, int depth, glm::vec3 offset, const BlockIds& blockIDs, float columns, float rows) {
+			SolidLines grid;
+			BuildSolidLines(grid, blockIDs, width, height, depth);
+			//A single pass, the buffers grow as needed and are trimmed at the end
+			ResizeQuads(planeData, std::max((int)planeData.vertices.size() / 4, 256));
+
+			int quad = 0;
+			uint64_t faces[6];
+			for (int z = 1; z < depth - 1; ++z) {
+				for (int y = 1; y < height - 1; ++y) {
+					for (int w = 0; w < grid.words; w++) {
+						if (!LineFaces(grid, z * height + y, w, faces))
+							continue;
+						for (int face = 0; face < 6; face++) {
+							//Walk the set bits, each one is an exposed face at x
+							for (uint64_t remaining = faces[face]; remaining; remaining &= remaining - 1) {
+								int x = w * 64 + std::countr_zero(remaining);
+								int id = blockIDs.IDs[FlatIndex(x, y, z, width, height)];
+								if (quad == (int)planeData.vertices.size() / 4)
+									ResizeQuads(planeData, quad * 2);
+								WriteFaceQuad(planeData, quad++, glm::vec3(x, y, z) + offset, face, id, columns, rows);
+							}
+						}
+					}
+				}
+			}
+			ResizeQuads(planeData, quad);
+		}
+
+		void VoxelCubesGreedyGeometryInit(PlaneMesh& planeData, int width, int height, int depth, glm::vec3 offset, const BlockIds& blockIDs, int quadCount) {
+			//Same sweep as VoxelCubesGreedyGeometryInit.comp: every face direction is cut into slices along its axis, and each slice is merged into
+			//rectangles row by row. The mask holds the block ID of every visible face in the slice, or -1.
+			const int strides[3] = { 1, width, width * height };
+
+			//Visible faces of every block as bits, found in one pass in memory order so the slices don't each test the neighbours again.
+			//The sweep below only covers the box around blocks with visible faces, which skips the air above the terrain.
+			std::vector<uint8_t> visibleFaces(blockIDs.IDs.size(), 0);
+			glm::ivec3 lo = glm::ivec3(width, height, depth);
+			glm::ivec3 hi = glm::ivec3(-1);
+			for (int z = 1; z < depth - 1; ++z) {
+				for (int y = 1; y < height - 1; ++y) {
+					for (int x = 1; x < width - 1; ++x) {
+						int index = FlatIndex(x, y, z, width, height);
+						if (blockIDs.IDs[index] < 0)
+							continue;
+						uint8_t bits = 0;
+						for (int face = 0; face < 6; face++) {
+							int neighbour = index + (face & 1 ? -strides[face / 2] : strides[face / 2]);
+							if (blockIDs.IDs[neighbour] < 0)
+								bits |= 1 << face;
+						}
+						visibleFaces[index] = bits;
+						if (bits) {
+							lo = glm::min(lo, glm::ivec3(x, y, z));
+							hi = glm::max(hi, glm::ivec3(x, y, z));
+						}
+					}
+				}
+			}
+
+			planeData.vertices.clear();
+			planeData.normals.clear();
+			planeData.indices.clear();
+			planeData.UVs.clear();
+			planeData.vertices.reserve(quadCount * 4);
+			planeData.normals.reserve(quadCount * 4);
+			planeData.indices.reserve(quadCount * 6);
+			planeData.UVs.reserve(quadCount * 4);
+			if (hi.x < 0)
+				return;
+
+			std::vector<int> mask;
+			for (int face = 0; face < 6; face++) {
+				int axis = face / 2;
+				int pAxis = (axis + 1) % 3;
+				int qAxis = (axis + 2) % 3;
+				int pCount = hi[pAxis] - lo[pAxis] + 1;
+				int qCount = hi[qAxis] - lo[qAxis] + 1;
+				mask.resize((size_t)pCount * qCount);
+
+				//Atlas UVs run along the corner edges 0->3 (u) and 0->1 (v) of the face
+				glm::vec3 uEdge = glm::abs(cornerOffsets[faceCorners[face][3]] - cornerOffsets[faceCorners[face][0]]);
+				glm::vec3 vEdge = glm::abs(cornerOffsets[faceCorners[face][1]] - cornerOffsets[faceCorners[face][0]]);
+
+				for (int slice = lo[axis]; slice <= hi[axis]; slice++) {
+					for (int q = 0; q < qCount; q++) {
+						int index = slice * strides[axis] + (q + lo[qAxis]) * strides[qAxis] + lo[pAxis] * strides[pAxis];
+						for (int p = 0; p < pCount; p++, index += strides[pAxis])
+							mask[q * pCount + p] = (visibleFaces[index] >> face) & 1 ? blockIDs.IDs[index] : -1;
+					}
+
+					for (int q = 0; q < qCount; q++) {
+						for (int p = 0; p < pCount; ) {
+							int id = mask[q * pCount + p];
+							if (id < 0) {
+								p++;
+								continue;
+							}
+							int w = 1;
+							while (p + w < pCount && mask[q * pCount + p + w] == id)
+								w++;
+							int h = 1;
+							for (; q + h < qCount; h++) {
+								bool fullRow = true;
+								for (int k = 0; k < w && fullRow; k++)
+									fullRow = mask[(q + h) * pCount + p + k] == id;
+								if (!fullRow)
+									break;
+							}
+							for (int l = 0; l < h; l++)
+								for (int k = 0; k < w; k++)
+									mask[(q + l) * pCount + p + k] = -1;
+
+							glm::vec3 base;
+							base[axis] = (float)slice;
+							base[pAxis] = (float)(p + lo[pAxis]);
+							base[qAxis] = (float)(q + lo[qAxis]);
+							base += offset;
+							glm::vec3 size(1.0f);
+							size[pAxis] = (float)w;
+							size[qAxis] = (float)h;
+
+							int index = (int)planeData.vertices.size();
+							for (int c = 0; c < 4; c++) {
+								planeData.vertices.push_back(base + cornerOffsets[faceCorners[face][c]] * size);
+								planeData.normals.push_back(glm::vec3(faceDirections[face]));
+							}
+
+							glm::vec2 tile = glm::vec2(faceColumns[face], (float)(16 - id)) * VoxelAtlasTileStride;
+							float lengthU = glm::dot(uEdge, size);
+							float lengthV = glm::dot(vEdge, size);
+							planeData.UVs.push_back(tile);
+							planeData.UVs.push_back(tile + glm::vec2(0.0f, lengthV));
+							planeData.UVs.push_back(tile + glm::vec2(lengthU, lengthV));
+							planeData.UVs.push_back(tile + glm::vec2(lengthU, 0.0f));
+
+							planeData.indices.push_back(index);
+							planeData.indices.push_back(index + 1);
+							planeData.indices.push_back(index + 2);
+							planeData.indices.push_back(index);
+							planeData.indices.push_back(index + 2);
+							planeData.indices.push_back(index + 3);
+
+							p += w;
+						}
+					}
+				}
+			}
+		}
+	}
+}
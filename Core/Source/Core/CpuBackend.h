@@ -0,0 +1,46 @@
+#pragma once
+#include "Core.h"
+
+namespace Core {
+	//CPU implementations of every compute shader in Core. They are used when the backend is set to Backend::CPU and need no GL context or .comp files,
+	//which makes it possible to generate terrain on headless machines. Each function mirrors one shader and keeps its memory layout and
+	//quirks so that the output can be compared against the GPU path. Results match the GPU within float tolerance, not bit for bit, since
+	//GLSL sin/exp/pow precision is implementation defined.
+	namespace Cpu {
+		//Noise primitives, ported 1:1 from the GLSL (Ashima/Gustavson simplex noise, value noise from HeightMapVertexDisplacement.comp)
+		float Rand(glm::vec2 n);
+		float SimplexNoise(glm::vec2 v);
+		float SimplexNoise(glm::vec3 v);
+		float PNoise(glm::vec2 p, float amplitude, float frequency, int octaves, float persistance, float lacunarity);
+		float SampleCurve(const Spline& spline, float noiseValue);
+
+		//HeightMapVertexInit.comp, HeightMapIndexInit.comp, HeightMapVertexDisplacement.comp and HeightMapNormal.comp
+		void CreateVertices(PlaneMesh& planeData, int width, int height, glm::ivec2 offset);
+		void CreateIndices(PlaneMesh& planeData, int width, int height);
+		void DisplaceVertices(PlaneMesh& planeData, int width, int height, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity);
+		void InterpolatedNormals(PlaneMesh& planeData, int width, int height);
+		//HeightMapChunk.comp
+		void CreateHeightMapChunk(PlaneMesh& planeData, int width, int height, glm::ivec2 offset, float scale, float amplitude, float frequency, int octaves, float persistance, float lacunarity);
+
+		//Create3DNoise.comp, 3DVoxelCubeNoise.comp and VoxelTerrainPainter.comp
+		void CreateFlat3DNoiseMap(std::vector<float>& densities, int width, int height, int depth, glm::vec3 offset, float frequency);
+		void CreateFlat3DNoiseMapPipeLine(BlockIds& blockIDs, const Spline& spline, int width, int height, int depth, glm::vec3 offset, float frequency, bool useDropoff);
+		void TerrainPaint(BlockIds& blockIDs, int width, int height, int depth);
+
+		//MarchingCubesSurfaceCulling.comp, MarchingCubesCountTris.comp and MarchingCubesCreateTris.comp
+		void PerformSurfaceCulling(const std::vector<float>& densities, std::vector<uint32_t>& activeVoxels, int width, int height, int depth, float isoLevel);
+		int CountMarchingCubesTriangleCount(const std::vector<float>& densities, const std::vector<uint32_t>& activeVoxels, int width, int height, float isoLevel);
+		void CreateMarchingCubesTriangles(CpuVoxelMesh& mesh, const std::vector<float>& densities, const std::vector<uint32_t>& activeVoxels, int width, int height, glm::vec3 offset, float isoLevel);
+		//Indexed variant, MarchingCubesIndexedVerts.comp and MarchingCubesIndexedTris.comp: one vertex per crossed lattice edge shared by every
+		//triangle that uses it, with a normal from the density gradient instead of the face normal
+		void CreateMarchingCubesIndexed(CpuVoxelMesh& mesh, const std::vector<float>& densities, const std::vector<uint32_t>& activeVoxels, int width, int height, int depth, glm::vec3 offset, float isoLevel);
+
+		//VoxelCubesCountTriangles.comp, VoxelCubesGeometryInit.comp and VoxelCubesGreedyGeometryInit.comp
+		int VoxelCubesQuadCount(int width, int height, int depth, const BlockIds& blockIDs);
+		void VoxelCubesGeometryInit(PlaneMesh& planeData, int width, int height, int depth, glm::vec3 offset, const BlockIds& blockIDs, int quadCount, float columns, float rows);
+		//Same quads as VoxelCubesGeometryInit, found with 64-bit masks over whole lines of blocks in a single pass, so it needs no
+		//VoxelCubesQuadCount first
+		void VoxelCubesBinaryGeometryInit(PlaneMesh& planeData, int width, int height, int depth, glm::vec3 offset, const BlockIds& blockIDs, float columns, float rows);
+		void VoxelCubesGreedyGeometryInit(PlaneMesh& planeData, int width, int height, int depth, glm::vec3 offset, const BlockIds& blockIDs, int quadCount);
+	}
+}
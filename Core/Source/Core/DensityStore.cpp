@@ -0,0 +1,217 @@
+#include "DensityStore.h"
+#include "CpuBackend.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace Core {
+	namespace {
+		int FloorDiv(int a, int b) {
+			return a >= 0 ? a / b : -((-a + b - 1) / b);
+		}
+
+		template<typename T>
+		void Quantize(const float* densities, size_t count, T* samples, float isoLevel, float range) {
+			const float steps = (float)std::numeric_limits<T>::max();
+			const float scale = steps / range;
+			for (size_t i = 0; i < count; i++) {
+				float q = std::round((densities[i] - isoLevel) * scale);
+				q = std::clamp(q, -steps, steps);
+				//Rounding must not lift a sample onto the iso level, or its corner would flip sides
+				if (densities[i] < isoLevel && q > -1.0f) q = -1.0f;
+				samples[i] = (T)q;
+			}
+		}
+
+		template<typename T>
+		void Dequantize(const T* samples, int count, float* densities, float isoLevel, float range) {
+			const float step = range / (float)std::numeric_limits<T>::max();
+			for (int i = 0; i < count; i++) {
+				densities[i] = isoLevel + samples[i] * step;
+			}
+		}
+	}
+
+	void QuantizeDensities(const float* densities, int count, int16_t* samples, float isoLevel, float range) {
+		Quantize(densities, (size_t)count, samples, isoLevel, range);
+	}
+
+	void DequantizeDensities(const int16_t* samples, int count, float* densities, float isoLevel, float range) {
+		Dequantize(samples, count, densities, isoLevel, range);
+	}
+
+	DensityStore::DensityStore(glm::ivec3 brickSize, float frequency, DensityFormat format, float isoLevel, float range) {
+		Configure(brickSize, frequency, format, isoLevel, range);
+	}
+
+	void DensityStore::Configure(glm::ivec3 brickSize, float frequency, DensityFormat format, float isoLevel, float range) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_bricks.clear();
+		_evaluatedSamples = 0;
+		_residentBytes = 0;
+		_brickSize = glm::max(brickSize, glm::ivec3(1));
+		_frequency = frequency;
+		_format = format;
+		_isoLevel = isoLevel;
+		_range = range;
+	}
+
+	void DensityStore::Acquire(glm::ivec3 origin, glm::ivec3 size, float* densities) {
+		glm::ivec3 first = FirstBrick(origin);
+		glm::ivec3 last = LastBrick(origin, size);
+
+		for (int bz = first.z; bz <= last.z; bz++) {
+			for (int by = first.y; by <= last.y; by++) {
+				for (int bx = first.x; bx <= last.x; bx++) {
+					glm::ivec3 key(bx, by, bz);
+					Brick* brick;
+					{
+						std::lock_guard<std::mutex> lock(_mutex);
+						std::unique_ptr<Brick>& slot = _bricks[key];
+						if (!slot) slot = CreateBrick(key);
+						brick = slot.get();
+						brick->references++;
+					}
+
+					for (Part& part : brick->parts) {
+						//Part of the box inside this part, in lattice coordinates
+						glm::ivec3 lo = glm::max(origin, part.origin);
+						glm::ivec3 hi = glm::min(origin + size, part.origin + part.size);
+						if (glm::any(glm::greaterThanEqual(lo, hi))) continue;
+
+						//Outside the lock so parts generate in parallel, a second box that needs the same part waits for the first
+						std::call_once(part.generated, [&] { Generate(part); });
+						for (int z = lo.z; z < hi.z; z++) {
+							for (int y = lo.y; y < hi.y; y++) {
+								int source = (lo.x - part.origin.x) + (y - part.origin.y) * part.size.x + (z - part.origin.z) * part.size.x * part.size.y;
+								int target = (lo.x - origin.x) + (y - origin.y) * size.x + (z - origin.z) * size.x * size.y;
+								Decode(part, source, hi.x - lo.x, densities + target);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void DensityStore::Release(glm::ivec3 origin, glm::ivec3 size) {
+		glm::ivec3 first = FirstBrick(origin);
+		glm::ivec3 last = LastBrick(origin, size);
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		for (int bz = first.z; bz <= last.z; bz++) {
+			for (int by = first.y; by <= last.y; by++) {
+				for (int bx = first.x; bx <= last.x; bx++) {
+					auto it = _bricks.find(glm::ivec3(bx, by, bz));
+					if (it == _bricks.end()) continue;
+					if (--it->second->references <= 0) {
+						_residentBytes -= BrickBytes(*it->second);
+						_bricks.erase(it);
+					}
+				}
+			}
+		}
+	}
+
+	void DensityStore::Clear() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_bricks.clear();
+		_evaluatedSamples = 0;
+		_residentBytes = 0;
+	}
+
+	size_t DensityStore::GetBrickCount() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _bricks.size();
+	}
+
+	size_t DensityStore::GetResidentBytes() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _residentBytes;
+	}
+
+	size_t DensityStore::GetEvaluatedSamples() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _evaluatedSamples;
+	}
+
+	std::unique_ptr<DensityStore::Brick> DensityStore::CreateBrick(glm::ivec3 key) const {
+		//The x = 0 face, the y = 0 face without it, the z = 0 face without both and the rest. A chunk box only reaches into the bricks after
+		//its own through their low faces.
+		glm::ivec3 o = key * _brickSize;
+		glm::ivec3 s = _brickSize;
+		std::unique_ptr<Brick> brick = std::make_unique<Brick>();
+		brick->parts[0].origin = o;
+		brick->parts[0].size = glm::ivec3(1, s.y, s.z);
+		brick->parts[1].origin = o + glm::ivec3(1, 0, 0);
+		brick->parts[1].size = glm::ivec3(s.x - 1, 1, s.z);
+		brick->parts[2].origin = o + glm::ivec3(1, 1, 0);
+		brick->parts[2].size = glm::ivec3(s.x - 1, s.y - 1, 1);
+		brick->parts[3].origin = o + glm::ivec3(1, 1, 1);
+		brick->parts[3].size = s - 1;
+		return brick;
+	}
+
+	void DensityStore::Generate(Part& part) {
+		if (glm::any(glm::lessThanEqual(part.size, glm::ivec3(0)))) return;
+		std::vector<float> densities;
+		Cpu::CreateFlat3DNoiseMap(densities, part.size.x, part.size.y, part.size.z, glm::vec3(part.origin), _frequency);
+
+		part.samples.resize(densities.size() * SampleBytes());
+		switch (_format) {
+		case DensityFormat::Float32:
+			std::memcpy(part.samples.data(), densities.data(), part.samples.size());
+			break;
+		case DensityFormat::Int16:
+			Quantize(densities.data(), densities.size(), (int16_t*)part.samples.data(), _isoLevel, _range);
+			break;
+		case DensityFormat::Int8:
+			Quantize(densities.data(), densities.size(), (int8_t*)part.samples.data(), _isoLevel, _range);
+			break;
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		_evaluatedSamples += densities.size();
+		_residentBytes += part.samples.size();
+	}
+
+	void DensityStore::Decode(const Part& part, int first, int count, float* densities) const {
+		switch (_format) {
+		case DensityFormat::Float32:
+			std::memcpy(densities, (const float*)part.samples.data() + first, count * sizeof(float));
+			break;
+		case DensityFormat::Int16:
+			Dequantize((const int16_t*)part.samples.data() + first, count, densities, _isoLevel, _range);
+			break;
+		case DensityFormat::Int8:
+			Dequantize((const int8_t*)part.samples.data() + first, count, densities, _isoLevel, _range);
+			break;
+		}
+	}
+
+	size_t DensityStore::BrickBytes(const Brick& brick) const {
+		size_t bytes = 0;
+		for (const Part& part : brick.parts) {
+			bytes += part.samples.size();
+		}
+		return bytes;
+	}
+
+	size_t DensityStore::SampleBytes() const {
+		switch (_format) {
+		case DensityFormat::Int16: return sizeof(int16_t);
+		case DensityFormat::Int8: return sizeof(int8_t);
+		default: return sizeof(float);
+		}
+	}
+
+	glm::ivec3 DensityStore::FirstBrick(glm::ivec3 origin) const {
+		return glm::ivec3(FloorDiv(origin.x, _brickSize.x), FloorDiv(origin.y, _brickSize.y), FloorDiv(origin.z, _brickSize.z));
+	}
+
+	glm::ivec3 DensityStore::LastBrick(glm::ivec3 origin, glm::ivec3 size) const {
+		return FirstBrick(origin + glm::max(size, glm::ivec3(1)) - 1);
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include "glm.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Core {
+	//How a DensityStore keeps its samples. The quantized formats store the distance to the iso level in steps of range / 127 or range / 32767,
+	//clamped to range. A sample below the iso level always stays below it, so the marching cubes cases and the surface topology don't change,
+	//only the vertex positions move by up to half a step.
+	enum class DensityFormat {
+		Float32,
+		Int16,
+		Int8
+	};
+
+	//The Int16 encoding of a DensityStore for densities kept outside of one, e.g. in a region file
+	void QuantizeDensities(const float* densities, int count, int16_t* samples, float isoLevel = 0.0f, float range = 1.0f);
+	void DequantizeDensities(const int16_t* samples, int count, float* densities, float isoLevel = 0.0f, float range = 1.0f);
+
+	//The 3D noise densities of the marching cubes chunks, keyed by world lattice coordinate instead of by chunk. The lattice is split into
+	//bricks of brickSize samples that don't overlap, so the border samples a chunk shares with its neighbours are evaluated and stored once:
+	//a padded chunk box reads its own brick plus the border slabs of the bricks after it. Each brick is generated in four parts, its x, y and
+	//z = 0 faces and the rest, and only the parts a box reads, so the bricks past the last loaded chunks only cost their faces. A brick lives
+	//as long as a box that touches it is acquired. Safe to use from the worker threads of a JobSystem.
+	class DensityStore {
+	public:
+		DensityStore(glm::ivec3 brickSize, float frequency, DensityFormat format = DensityFormat::Int8, float isoLevel = 0.0f, float range = 1.0f);
+		DensityStore(const DensityStore&) = delete;
+		DensityStore& operator=(const DensityStore&) = delete;
+
+		//Drops every brick and changes the settings, nothing may be acquired
+		void Configure(glm::ivec3 brickSize, float frequency, DensityFormat format = DensityFormat::Int8, float isoLevel = 0.0f, float range = 1.0f);
+		//Writes the size box of samples starting at origin to densities, x first then y then z, like CreateFlat3DNoiseMap. Missing bricks are
+		//generated, and every brick the box touches stays until the box is released.
+		void Acquire(glm::ivec3 origin, glm::ivec3 size, float* densities);
+		void Release(glm::ivec3 origin, glm::ivec3 size);
+		void Clear();
+
+		float GetFrequency() const { return _frequency; }
+		size_t GetBrickCount() const;
+		//Bytes of all stored samples
+		size_t GetResidentBytes() const;
+		//Noise samples evaluated since the last Configure or Clear
+		size_t GetEvaluatedSamples() const;
+
+	private:
+		//Box of a brick in lattice coordinates with its samples, x first then y then z
+		struct Part {
+			std::once_flag generated;
+			glm::ivec3 origin = glm::ivec3(0);
+			glm::ivec3 size = glm::ivec3(0);
+			std::vector<uint8_t> samples;
+		};
+		struct Brick {
+			Part parts[4];
+			int references = 0;
+		};
+		struct BrickHash {
+			size_t operator()(const glm::ivec3& c) const {
+				return ((size_t)(uint32_t)c.x * 73856093u) ^ ((size_t)(uint32_t)c.y * 19349663u) ^ ((size_t)(uint32_t)c.z * 83492791u);
+			}
+		};
+
+		glm::ivec3 _brickSize;
+		float _frequency;
+		DensityFormat _format;
+		float _isoLevel;
+		float _range;
+
+		mutable std::mutex _mutex;
+		std::unordered_map<glm::ivec3, std::unique_ptr<Brick>, BrickHash> _bricks;
+		size_t _evaluatedSamples = 0;
+		size_t _residentBytes = 0;
+
+		std::unique_ptr<Brick> CreateBrick(glm::ivec3 key) const;
+		void Generate(Part& part);
+		//Decodes count samples of a part, starting at first, into densities
+		void Decode(const Part& part, int first, int count, float* densities) const;
+		size_t BrickBytes(const Brick& brick) const;
+		size_t SampleBytes() const;
+		glm::ivec3 FirstBrick(glm::ivec3 origin) const;
+		glm::ivec3 LastBrick(glm::ivec3 origin, glm::ivec3 size) const;
+	};
+}
@@ -0,0 +1,179 @@
+#include "HeightMapQuadtree.h"
+#include "ChunkStreamer.h"
+#include "CpuBackend.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace Core {
+	namespace {
+		//Octaves whose lattice has more points over a node than this count as the full [0, 1] range
+		constexpr int MaxLatticePoints = 17 * 17;
+		//The bounds cache is cleared when it grows past this, a camera flying in one direction keeps adding nodes
+		constexpr size_t MaxCachedBounds = 1 << 16;
+
+		bool BoxInSphere(glm::vec3 boxMin, glm::vec3 boxMax, glm::vec3 center, float radius) {
+			glm::vec3 closest = glm::clamp(center, boxMin, boxMax);
+			glm::vec3 d = closest - center;
+			return glm::dot(d, d) <= radius * radius;
+		}
+
+		float Pow4(float x) { return x * x * x * x; }
+	}
+
+	HeightMapQuadtree::HeightMapQuadtree(const HeightMapQuadtreeSettings& settings) {
+		Configure(settings);
+	}
+
+	void HeightMapQuadtree::Configure(const HeightMapQuadtreeSettings& settings) {
+		_settings = settings;
+		_settings.levels = std::clamp(_settings.levels, 1, 20);
+		_settings.gridResolution = std::max(2, (int)std::bit_floor((unsigned)std::max(_settings.gridResolution, 2)));
+		_settings.morphStart = std::clamp(_settings.morphStart, 0.1f, 0.9f);
+		//A node reaches at most its 3D diagonal past the range it was selected in. Its vertices there have to be fully morphed while the coarser
+		//neighbour's have not started yet, which holds when the diagonal fits in the part of the next level's range before its morph. The
+		//height is capped at the 20 units of amplitude 1, steeper terrain needs a larger leafRange to stay free of seams.
+		float relief = std::min(20.0f * Pow4(std::max(_settings.amplitude, 0.0f)), 20.0f);
+		float diagonal = glm::length(glm::vec3(_settings.leafSize, relief, _settings.leafSize));
+		_settings.leafRange = std::max(_settings.leafRange, diagonal / _settings.morphStart);
+
+		_ranges.resize(_settings.levels);
+		for (int level = 0; level < _settings.levels; level++)
+			_ranges[level] = _settings.leafRange * (float)(1 << level);
+		_bounds.clear();
+		_selection.clear();
+	}
+
+	glm::vec2 HeightMapQuadtree::GetMorphRange(int level) const {
+		float previous = level > 0 ? _ranges[level - 1] : 0.0f;
+		return glm::vec2(glm::mix(previous, _ranges[level], _settings.morphStart), _ranges[level]);
+	}
+
+	glm::vec2 HeightMapQuadtree::GetHeightBounds(int level, glm::ivec2 node) {
+		uint64_t key = ((uint64_t)level << 48) | ((uint64_t)(node.x & 0xFFFFFF) << 24) | (uint64_t)(node.y & 0xFFFFFF);
+		auto it = _bounds.find(key);
+		if (it != _bounds.end())
+			return it->second;
+
+		//Every octave of pNoise blends the four lattice values around a point with weights in [0, 1], so it stays between the lowest and
+		//highest lattice value the node touches
+		float size = NodeSize(level);
+		glm::vec2 low = glm::vec2(node) * size * _settings.scale;
+		glm::vec2 high = glm::vec2(node + 1) * size * _settings.scale;
+		float n0 = 0.0f, n1 = 0.0f, normK = 0.0f;
+		float f = _settings.frequency;
+		float amp = 1.0f;
+		for (int octave = 0; octave < _settings.octaves; octave++) {
+			float unit = 1.0f / f;
+			glm::ivec2 first = glm::ivec2(glm::floor(low / unit));
+			glm::ivec2 last = glm::ivec2(glm::floor(high / unit)) + 1;
+			float lowest = 0.0f, highest = 1.0f;
+			if ((last.x - first.x + 1) * (last.y - first.y + 1) <= MaxLatticePoints) {
+				lowest = 1.0f;
+				highest = 0.0f;
+				for (int z = first.y; z <= last.y; z++) {
+					for (int x = first.x; x <= last.x; x++) {
+						float r = Cpu::Rand(glm::vec2(x, z));
+						lowest = std::min(lowest, r);
+						highest = std::max(highest, r);
+					}
+				}
+			}
+			n0 += amp * (amp >= 0.0f ? lowest : highest);
+			n1 += amp * (amp >= 0.0f ? highest : lowest);
+			f *= _settings.lacunarity;
+			normK += amp / _settings.amplitude;
+			amp *= _settings.persistance;
+		}
+
+		glm::vec2 bounds(0.0f);
+		if (normK != 0.0f) {
+			float nf0 = std::min(n0 / normK, n1 / normK);
+			float nf1 = std::max(n0 / normK, n1 / normK);
+			float lowest = nf0 <= 0.0f && nf1 >= 0.0f ? 0.0f : std::min(Pow4(nf0), Pow4(nf1));
+			bounds = glm::vec2(20.0f * lowest, 20.0f * std::max(Pow4(nf0), Pow4(nf1)));
+		}
+		if (_bounds.size() >= MaxCachedBounds)
+			_bounds.clear();
+		_bounds.emplace(key, bounds);
+		return bounds;
+	}
+
+	const std::vector<HeightMapNode>& HeightMapQuadtree::Select(const glm::vec3& cameraPosition, const glm::mat4& viewProjection) {
+		_selection.clear();
+		ExtractFrustum(viewProjection, _frustum);
+		_camera = cameraPosition;
+
+		//Root nodes are tiled around the camera as far as the coarsest level reaches
+		int top = _settings.levels - 1;
+		float rootSize = NodeSize(top);
+		glm::vec2 camera(cameraPosition.x, cameraPosition.z);
+		glm::ivec2 first = glm::ivec2(glm::floor((camera - _ranges[top]) / rootSize));
+		glm::ivec2 last = glm::ivec2(glm::floor((camera + _ranges[top]) / rootSize));
+		for (int z = first.y; z <= last.y; z++) {
+			for (int x = first.x; x <= last.x; x++)
+				SelectNode(top, glm::ivec2(x, z));
+		}
+		return _selection;
+	}
+
+	bool HeightMapQuadtree::SelectNode(int level, glm::ivec2 node) {
+		float size = NodeSize(level);
+		glm::vec2 bounds = GetHeightBounds(level, node);
+		glm::vec3 boxMin(node.x * size, bounds.x, node.y * size);
+		glm::vec3 boxMax(boxMin.x + size, bounds.y, boxMin.z + size);
+		if (!BoxInSphere(boxMin, boxMax, _camera, _ranges[level]))
+			return false;
+		//Culled nodes count as handled, so the parent does not draw them either
+		if (!BoxInFrustum(_frustum, boxMin, boxMax))
+			return true;
+
+		HeightMapNode selected = { glm::vec2(boxMin.x, boxMin.z), size, level, 0xF, bounds.x, bounds.y };
+		if (level == 0 || !BoxInSphere(boxMin, boxMax, _camera, _ranges[level - 1])) {
+			_selection.push_back(selected);
+			return true;
+		}
+
+		//Children out of the finer range are drawn as quarters of this node
+		selected.quadrants = 0;
+		for (int quadrant = 0; quadrant < 4; quadrant++) {
+			glm::ivec2 child = node * 2 + glm::ivec2(quadrant & 1, quadrant >> 1);
+			if (!SelectNode(level - 1, child))
+				selected.quadrants |= 1 << quadrant;
+		}
+		if (selected.quadrants)
+			_selection.push_back(selected);
+		return true;
+	}
+
+	PlaneMesh CreateHeightMapGridMesh(int width, int height) {
+		PlaneMesh mesh;
+		mesh.vertices.resize((width + 1) * (height + 1));
+		mesh.normals.assign(mesh.vertices.size(), glm::vec3(0.0f, 1.0f, 0.0f));
+		for (int z = 0; z <= height; ++z) {
+			for (int x = 0; x <= width; ++x)
+				mesh.vertices[z * (width + 1) + x] = glm::vec3((float)x, 0.0f, (float)z);
+		}
+
+		mesh.indices.reserve(width * height * 6);
+		int halfWidth = width / 2;
+		int halfHeight = height / 2;
+		for (int quadrant = 0; quadrant < 4; quadrant++) {
+			int x0 = (quadrant & 1) ? halfWidth : 0;
+			int x1 = (quadrant & 1) ? width : halfWidth;
+			int z0 = (quadrant & 2) ? halfHeight : 0;
+			int z1 = (quadrant & 2) ? height : halfHeight;
+			for (int z = z0; z < z1; ++z) {
+				for (int x = x0; x < x1; ++x) {
+					int v0 = x + z * (width + 1);
+					int v1 = (x + 1) + z * (width + 1);
+					int v2 = x + (z + 1) * (width + 1);
+					int v3 = (x + 1) + (z + 1) * (width + 1);
+					mesh.indices.insert(mesh.indices.end(), { v0, v2, v1, v1, v2, v3 });
+				}
+			}
+		}
+		return mesh;
+	}
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include "Core.h"
+
+#include <unordered_map>
+
+namespace Core {
+	//Terrain of the heightmap path as a continuous distance based LOD quadtree (CDLOD). The world is tiled with root nodes; every node covers
+	//a square and is drawn with the same grid mesh of gridResolution cells per side, so a node one level up has cells twice as wide. Level 0
+	//is the finest. Vertices morph towards the grid of the next coarser level as they approach the end of their level's range, which makes
+	//the transitions smooth and closes the seams between levels without stitching. The cost is bounded by the number of levels, not the
+	//view distance: past the last range nothing is drawn.
+	struct HeightMapQuadtreeSettings {
+		float leafSize = 25.0f; //world size of a level 0 node
+		int levels = 8;
+		int gridResolution = 32; //cells per node side, a power of two
+		float leafRange = 60.0f; //distance up to which level 0 is used, every further level doubles it. Raised by Configure when too short to morph.
+		float morphStart = 0.7f; //fraction of a level's range after which its vertices start to morph
+		//pNoise parameters of HeightMapVertexDisplacement.comp, the heights are 20 * pNoise(xz * scale) like there
+		float scale = 0.1f;
+		float amplitude = 1.0f;
+		float frequency = 1.0f;
+		int octaves = 5;
+		float persistance = 0.5f;
+		float lacunarity = 2.0f;
+	};
+
+	//One node to draw. quadrants has a bit per quarter (x + 2 * z) that this node covers; the others are drawn by its children.
+	struct HeightMapNode {
+		glm::vec2 origin; //world x and z of the low corner
+		float size;
+		int level;
+		uint8_t quadrants;
+		float minHeight;
+		float maxHeight;
+	};
+
+	class HeightMapQuadtree {
+	public:
+		explicit HeightMapQuadtree(const HeightMapQuadtreeSettings& settings = HeightMapQuadtreeSettings());
+
+		//Drops the cached node bounds, call it after changing the noise
+		void Configure(const HeightMapQuadtreeSettings& settings);
+		const HeightMapQuadtreeSettings& GetSettings() const { return _settings; }
+
+		//Nodes around the camera inside the frustum. The result stays valid until the next Select or Configure.
+		const std::vector<HeightMapNode>& Select(const glm::vec3& cameraPosition, const glm::mat4& viewProjection);
+		//Distance where the vertices of level start and finish morphing, the uniforms of the vertex shader
+		glm::vec2 GetMorphRange(int level) const;
+		//Distance from the camera covered by level and the finer ones
+		float GetRange(int level) const { return _ranges[level]; }
+		//Indices of one quarter of the grid, the mesh of CreateHeightMapGridMesh stores the quarters one after the other
+		int GetQuadrantIndexCount() const { return (_settings.gridResolution / 2) * (_settings.gridResolution / 2) * 6; }
+
+		//Lowest and highest height of the node, bounds of the lattice values of every octave of the value noise, so they hold for every
+		//level of detail of the node. Cached per node.
+		glm::vec2 GetHeightBounds(int level, glm::ivec2 node);
+
+	private:
+		HeightMapQuadtreeSettings _settings;
+		std::vector<float> _ranges;
+		std::vector<HeightMapNode> _selection;
+		std::unordered_map<uint64_t, glm::vec2> _bounds;
+		glm::vec4 _frustum[6];
+		glm::vec3 _camera;
+
+		float NodeSize(int level) const { return _settings.leafSize * (float)(1 << level); }
+		//False when the node is out of the range of its level, its parent covers it then
+		bool SelectNode(int level, glm::ivec2 node);
+	};
+
+	//A flat grid of width x height cells in grid units, vertices (x, 0, z) with up normals, for drawing every node of a HeightMapQuadtree
+	//with one mesh. The indices go quarter by quarter, split at width / 2 and height / 2, each with the winding of CreateIndices.
+	PlaneMesh CreateHeightMapGridMesh(int width, int height);
+}
@@ -0,0 +1,285 @@
+#include "JobSystem.h"
+
+namespace Core {
+	struct Job {
+		std::function<void()> work;
+		std::atomic<int> refs{ 1 };
+		std::atomic<int> pendingDependencies{ 1 }; //starts with a guard that Schedule releases once all dependencies are registered
+		std::atomic<bool> done{ false };
+
+		std::mutex continuationMutex;
+		std::vector<Job*> continuations; //jobs waiting on this one, each holds a reference
+		bool finished = false; //guarded by continuationMutex
+
+		void* completionData = nullptr;
+		Job* nextCompleted = nullptr;
+	};
+
+	namespace {
+		void Retain(Job* job) {
+			job->refs.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Release(Job* job) {
+			if (job->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				delete job;
+		}
+
+		thread_local JobSystem* t_jobSystem = nullptr;
+		thread_local int t_workerIndex = -1;
+	}
+
+	//Chase-Lev work stealing deque with a fixed capacity. The owning worker pushes and pops at the bottom, thieves take from the top.
+	class WorkDeque {
+	public:
+		static constexpr long long Capacity = 1024;
+
+		bool Push(Job* job) {
+			long long b = _bottom.load(std::memory_order_relaxed);
+			long long t = _top.load(std::memory_order_acquire);
+			if (b - t >= Capacity)
+				return false;
+			_buffer[b & (Capacity - 1)].store(job, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			_bottom.store(b + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		Job* Pop() {
+			long long b = _bottom.load(std::memory_order_relaxed) - 1;
+			_bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			long long t = _top.load(std::memory_order_relaxed);
+			if (t > b) {
+				_bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			Job* job = _buffer[b & (Capacity - 1)].load(std::memory_order_relaxed);
+			if (t == b) {
+				//Last item, race the thieves for it
+				if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					job = nullptr;
+				_bottom.store(b + 1, std::memory_order_relaxed);
+			}
+			return job;
+		}
+
+		Job* Steal() {
+			long long t = _top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			long long b = _bottom.load(std::memory_order_acquire);
+			if (t >= b)
+				return nullptr;
+			Job* job = _buffer[t & (Capacity - 1)].load(std::memory_order_relaxed);
+			if (!_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+			return job;
+		}
+
+	private:
+		alignas(64) std::atomic<long long> _top{ 0 };
+		alignas(64) std::atomic<long long> _bottom{ 0 };
+		std::atomic<Job*> _buffer[Capacity];
+	};
+
+	JobHandle::JobHandle(const JobHandle& other) : _job(other._job) {
+		if (_job)
+			Retain(_job);
+	}
+
+	JobHandle::JobHandle(JobHandle&& other) noexcept : _job(other._job) {
+		other._job = nullptr;
+	}
+
+	JobHandle& JobHandle::operator=(JobHandle other) noexcept {
+		std::swap(_job, other._job);
+		return *this;
+	}
+
+	JobHandle::~JobHandle() {
+		if (_job)
+			Release(_job);
+	}
+
+	bool JobHandle::IsDone() const {
+		return !_job || _job->done.load(std::memory_order_acquire);
+	}
+
+	JobSystem::JobSystem(int threadCount) {
+		if (threadCount <= 0) {
+			int hardwareThreads = (int)std::thread::hardware_concurrency();
+			threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+		for (int i = 0; i < threadCount; i++)
+			_deques.push_back(std::make_unique<WorkDeque>());
+		for (int i = 0; i < threadCount; i++)
+			_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+	}
+
+	JobSystem::~JobSystem() {
+		WaitAll();
+		{
+			std::lock_guard<std::mutex> lock(_sleepMutex);
+			_quit.store(true);
+		}
+		_sleepCv.notify_all();
+		for (std::thread& worker : _workers)
+			worker.join();
+
+		void* data;
+		while (PopCompleted(data)) {}
+	}
+
+	JobHandle JobSystem::Schedule(std::function<void()> work, const std::vector<JobHandle>& dependencies, void* completionData) {
+		Job* job = new Job;
+		job->work = std::move(work);
+		job->completionData = completionData;
+		_unfinished.fetch_add(1);
+
+		for (const JobHandle& dependency : dependencies) {
+			Job* parent = dependency._job;
+			if (!parent)
+				continue;
+			std::lock_guard<std::mutex> lock(parent->continuationMutex);
+			if (!parent->finished) {
+				Retain(job);
+				job->pendingDependencies.fetch_add(1, std::memory_order_relaxed);
+				parent->continuations.push_back(job);
+			}
+		}
+
+		JobHandle handle;
+		handle._job = job;
+		if (job->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			Enqueue(job);
+		return handle;
+	}
+
+	bool JobSystem::PopCompleted(void*& completionData) {
+		if (!_completedLocal) {
+			//Take everything pushed so far and reverse it, the stack hands it over newest first
+			Job* list = _completedHead.exchange(nullptr, std::memory_order_acquire);
+			while (list) {
+				Job* next = list->nextCompleted;
+				list->nextCompleted = _completedLocal;
+				_completedLocal = list;
+				list = next;
+			}
+		}
+		if (!_completedLocal)
+			return false;
+
+		Job* job = _completedLocal;
+		_completedLocal = job->nextCompleted;
+		completionData = job->completionData;
+		Release(job);
+		return true;
+	}
+
+	void JobSystem::Wait(const JobHandle& handle) {
+		int index = t_jobSystem == this ? t_workerIndex : -1;
+		while (!handle.IsDone()) {
+			if (!RunOne(index))
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::WaitAll() {
+		int index = t_jobSystem == this ? t_workerIndex : -1;
+		while (_unfinished.load() > 0) {
+			if (!RunOne(index))
+				std::this_thread::yield();
+		}
+	}
+
+	void JobSystem::WorkerLoop(int index) {
+		t_jobSystem = this;
+		t_workerIndex = index;
+		while (true) {
+			if (RunOne(index))
+				continue;
+
+			std::unique_lock<std::mutex> lock(_sleepMutex);
+			_sleeping.fetch_add(1);
+			_sleepCv.wait(lock, [this] { return _queued.load() > 0 || _quit.load(); });
+			_sleeping.fetch_sub(1);
+			if (_quit.load() && _queued.load() <= 0)
+				return;
+		}
+	}
+
+	Job* JobSystem::FindJob(int index) {
+		Job* job = nullptr;
+		if (index >= 0)
+			job = _deques[index]->Pop();
+
+		if (!job) {
+			std::lock_guard<std::mutex> lock(_injectMutex);
+			if (!_injectQueue.empty()) {
+				job = _injectQueue.front();
+				_injectQueue.pop_front();
+			}
+		}
+
+		//Steal from the other workers, starting next to ourselves so thieves spread out
+		int count = (int)_deques.size();
+		for (int i = 1; !job && i <= count; i++) {
+			int victim = (index + i) % count;
+			if (victim != index)
+				job = _deques[victim]->Steal();
+		}
+
+		if (job)
+			_queued.fetch_sub(1);
+		return job;
+	}
+
+	bool JobSystem::RunOne(int index) {
+		Job* job = FindJob(index);
+		if (!job)
+			return false;
+		Run(job);
+		return true;
+	}
+
+	void JobSystem::Run(Job* job) {
+		job->work();
+		job->work = nullptr;
+
+		std::vector<Job*> continuations;
+		{
+			std::lock_guard<std::mutex> lock(job->continuationMutex);
+			job->finished = true;
+			continuations.swap(job->continuations);
+		}
+		job->done.store(true, std::memory_order_release);
+
+		for (Job* continuation : continuations) {
+			if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				Enqueue(continuation);
+			Release(continuation);
+		}
+
+		if (job->completionData) {
+			Retain(job);
+			job->nextCompleted = _completedHead.load(std::memory_order_relaxed);
+			while (!_completedHead.compare_exchange_weak(job->nextCompleted, job, std::memory_order_release, std::memory_order_relaxed)) {}
+		}
+
+		_unfinished.fetch_sub(1);
+		Release(job); //the queue's reference
+	}
+
+	void JobSystem::Enqueue(Job* job) {
+		Retain(job);
+		_queued.fetch_add(1);
+		if (t_jobSystem != this || t_workerIndex < 0 || !_deques[t_workerIndex]->Push(job)) {
+			std::lock_guard<std::mutex> lock(_injectMutex);
+			_injectQueue.push_back(job);
+		}
+		if (_sleeping.load() > 0) {
+			std::lock_guard<std::mutex> lock(_sleepMutex);
+			_sleepCv.notify_one();
+		}
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Core {
+	struct Job;
+	class WorkDeque;
+
+	//Reference to a scheduled job. Jobs are reference counted, so a handle can be kept around to wait on the job or to use it as a dependency
+	//after it has finished.
+	class JobHandle {
+	public:
+		JobHandle() = default;
+		JobHandle(const JobHandle& other);
+		JobHandle(JobHandle&& other) noexcept;
+		JobHandle& operator=(JobHandle other) noexcept;
+		~JobHandle();
+
+		bool IsValid() const { return _job != nullptr; }
+		bool IsDone() const;
+
+	private:
+		friend class JobSystem;
+		Job* _job = nullptr;
+	};
+
+	//Fixed pool of worker threads. Every worker owns a deque it pushes and pops at the bottom, idle workers steal from the top of the others.
+	//Jobs scheduled from outside the pool go through a shared injection queue. A job runs once all of its dependencies have finished, and jobs
+	//scheduled with completion data push it to a lock-free completion queue that the owning thread drains with PopCompleted.
+	class JobSystem {
+	public:
+		//threadCount 0 starts one worker per hardware thread, minus one for the thread that owns the system
+		explicit JobSystem(int threadCount = 0);
+		~JobSystem();
+		JobSystem(const JobSystem&) = delete;
+		JobSystem& operator=(const JobSystem&) = delete;
+
+		JobHandle Schedule(std::function<void()> work, const std::vector<JobHandle>& dependencies = {}, void* completionData = nullptr);
+		//Returns the completion data of one finished job, in the order they finished. Only one thread may poll.
+		bool PopCompleted(void*& completionData);
+		//Block until the job (or every job) has finished. The calling thread runs queued jobs while it waits.
+		void Wait(const JobHandle& handle);
+		void WaitAll();
+
+		int GetWorkerCount() const { return (int)_workers.size(); }
+
+	private:
+		void WorkerLoop(int index);
+		Job* FindJob(int index);
+		bool RunOne(int index);
+		void Run(Job* job);
+		void Enqueue(Job* job);
+
+		std::vector<std::thread> _workers;
+		std::vector<std::unique_ptr<WorkDeque>> _deques;
+
+		std::mutex _injectMutex;
+		std::deque<Job*> _injectQueue;
+
+		std::atomic<int> _queued{ 0 }; //jobs sitting in any queue
+		std::atomic<int> _unfinished{ 0 }; //scheduled jobs that have not finished yet
+		std::atomic<int> _sleeping{ 0 };
+		std::atomic<bool> _quit{ false };
+		std::mutex _sleepMutex;
+		std::condition_variable _sleepCv;
+
+		std::atomic<Job*> _completedHead{ nullptr }; //pushed by workers
+		Job* _completedLocal = nullptr; //drained by PopCompleted
+	};
+}
@@ -0,0 +1,319 @@
+#include "MarchingCubesLod.h"
+#include "CpuBackend.h"
+#include "MarchingCubesTables.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Core {
+	namespace {
+		constexpr float SnapEpsilon = 0.0001f;
+
+		float& Sample(std::vector<float>& densities, glm::ivec3 size, glm::ivec3 p) {
+			return densities[p.x + p.y * size.x + p.z * size.x * size.y];
+		}
+
+		float Sample(const std::vector<float>& densities, glm::ivec3 size, glm::ivec3 p) {
+			return densities[p.x + p.y * size.x + p.z * size.x * size.y];
+		}
+
+		//Same corner and edge order as the marching cubes tables
+		const glm::ivec3 CornerOffsets[8] = {
+			glm::ivec3(0, 0, 0), glm::ivec3(1, 0, 0), glm::ivec3(1, 0, 1), glm::ivec3(0, 0, 1),
+			glm::ivec3(0, 1, 0), glm::ivec3(1, 1, 0), glm::ivec3(1, 1, 1), glm::ivec3(0, 1, 1)
+		};
+		const int EdgeCorners[12][2] = {
+			{0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {1, 5}, {2, 6}, {3, 7}
+		};
+
+		//value if it is already on the wanted side of the iso level, mirrored across it otherwise
+		float Toward(float value, bool inside, float isoLevel) {
+			if ((value < isoLevel) == inside)
+				return value;
+			float mirrored = 2.0f * isoLevel - value;
+			if ((mirrored < isoLevel) == inside)
+				return mirrored;
+			return inside ? std::nextafter(isoLevel, -INFINITY) : isoLevel;
+		}
+
+		//How the triangle table resolves an ambiguous face of the cube, given as a mask of its corners: a segment on the face cuts off
+		//the corner its two edges share, and the inside corners are connected when that corner is outside
+		bool InsideCornersConnected(int cubeIndex, int faceCorners) {
+			auto onFace = [&](int edge) { return (faceCorners >> EdgeCorners[edge][0] & 1) && (faceCorners >> EdgeCorners[edge][1] & 1); };
+			for (int q = 0; FlatTriTable[cubeIndex * 16 + q] != -1; q += 3) {
+				for (int e = 0; e < 3; e++) {
+					int e0 = FlatTriTable[cubeIndex * 16 + q + e];
+					int e1 = FlatTriTable[cubeIndex * 16 + q + (e + 1) % 3];
+					if (!onFace(e0) || !onFace(e1))
+						continue;
+					for (int c : EdgeCorners[e0]) {
+						if (c == EdgeCorners[e1][0] || c == EdgeCorners[e1][1])
+							return (cubeIndex & (1 << c)) == 0;
+					}
+				}
+			}
+			return false;
+		}
+
+		//Lattice index when the coordinate is on a lattice line, -1 otherwise
+		int LatticeIndex(float coordinate) {
+			float rounded = std::round(coordinate);
+			return std::abs(coordinate - rounded) < SnapEpsilon ? (int)rounded : -1;
+		}
+	}
+
+	int MarchingCubesLodLevel(glm::ivec3 coord, glm::ivec3 center, int lodDistance, int maxLevel) {
+		glm::ivec3 d = glm::abs(coord - center);
+		int distance = std::max(d.x, std::max(d.y, d.z));
+		//Rings are at least one chunk wide, so neighbours never differ by more than one level
+		int width = std::max(lodDistance, 1);
+		int bound = width;
+		int level = 0;
+		while (distance > bound && level < maxLevel) {
+			width *= 2;
+			bound += width;
+			level++;
+		}
+		return level;
+	}
+
+	MarchingCubesLod SelectMarchingCubesLod(glm::ivec3 coord, glm::ivec3 center, glm::ivec3 chunkSize, int lodDistance, int maxLevel) {
+		int smallest = std::min(chunkSize.x, std::min(chunkSize.y, chunkSize.z));
+		while (maxLevel > 0 && (chunkSize.x % (1 << maxLevel) || chunkSize.y % (1 << maxLevel) || chunkSize.z % (1 << maxLevel) || smallest < 2 << maxLevel))
+			maxLevel--;
+
+		MarchingCubesLod lod;
+		lod.level = MarchingCubesLodLevel(coord, center, lodDistance, maxLevel);
+		auto coarser = [&](glm::ivec3 neighbour) {
+			return MarchingCubesLodLevel(neighbour, center, lodDistance, maxLevel) > lod.level;
+		};
+		for (int face = 0; face < 6; face++) {
+			glm::ivec3 neighbour = coord;
+			neighbour[face / 2] += (face & 1) ? 1 : -1;
+			if (coarser(neighbour))
+				lod.coarserFaces |= 1 << face;
+		}
+		//The other three chunks around the edge, the face neighbours count as well
+		for (int edge = 0; edge < 12; edge++) {
+			int a = edge / 4;
+			glm::ivec3 db(0), dc(0);
+			db[(a + 1) % 3] = (edge & 1) ? 1 : -1;
+			dc[(a + 2) % 3] = (edge & 2) ? 1 : -1;
+			if (coarser(coord + db) || coarser(coord + dc) || coarser(coord + db + dc))
+				lod.coarserEdges |= 1 << edge;
+		}
+		return lod;
+	}
+
+	void StitchMarchingCubesDensities(std::vector<float>& densities, glm::ivec3 size, glm::vec3 latticeOffset, float latticeFrequency, const MarchingCubesLod& lod, float isoLevel) {
+		//The coarse lattice is every other sample, which the chunk size being divisible by the coarse stride keeps aligned with the world.
+		//Only samples off the coarse lattice change, so the order of the edges and faces does not matter.
+		for (int edge = 0; edge < 12; edge++) {
+			if ((lod.coarserEdges & (1 << edge)) == 0)
+				continue;
+			int a = edge / 4;
+			glm::ivec3 p(0);
+			p[(a + 1) % 3] = (edge & 1) ? size[(a + 1) % 3] - 1 : 0;
+			p[(a + 2) % 3] = (edge & 2) ? size[(a + 2) % 3] - 1 : 0;
+			for (int i = 1; i < size[a] - 1; i += 2) {
+				glm::ivec3 lo = p, hi = p;
+				lo[a] = i - 1;
+				hi[a] = i + 1;
+				p[a] = i;
+				Sample(densities, size, p) = 0.5f * (Sample(densities, size, lo) + Sample(densities, size, hi));
+			}
+		}
+
+		//Inside a face only the topology of the fine contour has to match the coarse one, SnapMarchingCubesBorder fixes the positions. The
+		//samples are picked so that no fine square is ambiguous, otherwise the fine table could connect them differently than the coarse one.
+		std::vector<float> outside;
+		for (int face = 0; face < 6; face++) {
+			if ((lod.coarserFaces & (1 << face)) == 0)
+				continue;
+			int a = face / 2;
+			int u = (a + 1) % 3;
+			int v = (a + 2) % 3;
+			int lastU = size[u] - 1;
+			int lastV = size[v] - 1;
+			glm::ivec3 p(0);
+			p[a] = (face & 1) ? size[a] - 1 : 0;
+			auto at = [&](int i, int j) -> float& {
+				glm::ivec3 q = p;
+				q[u] = i;
+				q[v] = j;
+				return Sample(densities, size, q);
+			};
+			auto onBorder = [&](int i, int j) { return i == 0 || j == 0 || i == lastU || j == lastV; };
+
+			//Samples halfway along a coarse edge, the border lines of the face are chunk edges and handled above. Crossed edges get an
+			//outside sample, so the crossing lands on the half next to the inside corner.
+			for (int j = 1; j < lastV; j++) {
+				for (int i = 1; i < lastU; i++) {
+					if ((i & 1) == (j & 1))
+						continue;
+					float d0 = (i & 1) ? at(i - 1, j) : at(i, j - 1);
+					float d1 = (i & 1) ? at(i + 1, j) : at(i, j + 1);
+					float linear = 0.5f * (d0 + d1);
+					at(i, j) = (d0 < isoLevel) == (d1 < isoLevel) ? linear : Toward(linear, false, isoLevel);
+				}
+			}
+
+			//Centers of the coarse squares, corners walked around the square
+			for (int j0 = 0; j0 < lastV; j0 += 2) {
+				for (int i0 = 0; i0 < lastU; i0 += 2) {
+					glm::ivec2 corners[4] = { { i0, j0 }, { i0 + 2, j0 }, { i0 + 2, j0 + 2 }, { i0, j0 + 2 } };
+					bool inside[4];
+					int insideCount = 0;
+					float bilinear = 0.0f;
+					for (int k = 0; k < 4; k++) {
+						float d = at(corners[k].x, corners[k].y);
+						inside[k] = d < isoLevel;
+						insideCount += inside[k];
+						bilinear += 0.25f * d;
+					}
+
+					bool ambiguous = insideCount == 2 && inside[0] == inside[2];
+					bool centerInside = insideCount >= 3;
+					if (ambiguous) {
+						//The coarse chunk decides with its own table, which looks at the whole cube, so the far corners of that cube are
+						//sampled here the way the coarse chunk samples them
+						glm::ivec3 base = p;
+						base[a] = (face & 1) ? size[a] - 1 : -2;
+						base[u] = i0;
+						base[v] = j0;
+						int cubeIndex = 0;
+						int faceCorners = 0;
+						for (int c = 0; c < 8; c++) {
+							glm::ivec3 corner = base + 2 * CornerOffsets[c];
+							float d;
+							if (corner[a] == p[a]) {
+								faceCorners |= 1 << c;
+								d = Sample(densities, size, corner);
+							}
+							else {
+								Cpu::CreateFlat3DNoiseMap(outside, 1, 1, 1, (latticeOffset + glm::vec3(corner)) * 0.5f, latticeFrequency * 2.0f);
+								d = outside[0];
+							}
+							if (d < isoLevel)
+								cubeIndex |= 1 << c;
+						}
+						centerInside = InsideCornersConnected(cubeIndex, faceCorners);
+
+						//Every corner on the side of the center needs a neighbouring sample on that side too, or its fine square is ambiguous
+						for (int k = 0; k < 4; k++) {
+							if (inside[k] != centerInside)
+								continue;
+							glm::ivec2 mids[2] = { (corners[k] + corners[(k + 1) % 4]) / 2, (corners[k] + corners[(k + 3) % 4]) / 2 };
+							if ((at(mids[0].x, mids[0].y) < isoLevel) == centerInside || (at(mids[1].x, mids[1].y) < isoLevel) == centerInside)
+								continue;
+							for (glm::ivec2 mid : mids) {
+								if (onBorder(mid.x, mid.y))
+									continue;
+								at(mid.x, mid.y) = Toward(at(mid.x, mid.y), centerInside, isoLevel);
+								break;
+							}
+						}
+					}
+					at(i0 + 1, j0 + 1) = Toward(bilinear, centerInside, isoLevel);
+				}
+			}
+		}
+	}
+
+	void SnapMarchingCubesBorder(CpuVoxelMesh& mesh, const std::vector<float>& densities, glm::ivec3 size, const MarchingCubesLod& lod, float isoLevel) {
+		if (lod.coarserFaces == 0)
+			return;
+		for (glm::vec3& position : mesh.vertices) {
+			for (int face = 0; face < 6; face++) {
+				if ((lod.coarserFaces & (1 << face)) == 0)
+					continue;
+				int a = face / 2;
+				int u = (a + 1) % 3;
+				int v = (a + 2) % 3;
+				float plane = (face & 1) ? (float)(size[a] - 1) : 0.0f;
+				if (std::abs(position[a] - plane) > SnapEpsilon)
+					continue;
+
+				glm::ivec3 p(0);
+				p[a] = (int)plane;
+				auto at = [&](glm::ivec2 q) {
+					glm::ivec3 r = p;
+					r[u] = q.x;
+					r[v] = q.y;
+					return Sample(densities, size, r);
+				};
+				auto crossing = [&](glm::ivec2 q0, glm::ivec2 q1) {
+					float d0 = at(q0);
+					float d1 = at(q1);
+					return glm::mix(glm::vec2(q0), glm::vec2(q1), (isoLevel - d0) / (d1 - d0));
+				};
+
+				glm::vec2 point(position[u], position[v]);
+				int iu = LatticeIndex(point.x);
+				int iv = LatticeIndex(point.y);
+				int i0 = std::min((int)point.x & ~1, size[u] - 3);
+				int j0 = std::min((int)point.y & ~1, size[v] - 3);
+
+				//On a coarse edge the vertex goes where the coarse chunk has it
+				if (iu >= 0 && (iu & 1) == 0) {
+					if (iv < 0)
+						point = crossing({ iu, j0 }, { iu, j0 + 2 });
+				}
+				else if (iv >= 0 && (iv & 1) == 0) {
+					point = crossing({ i0, iv }, { i0 + 2, iv });
+				}
+				else {
+					//Inside a coarse square the vertex goes onto the coarse segment, for ambiguous squares the one cutting off the corner on its side
+					glm::ivec2 corners[4] = { { i0, j0 }, { i0 + 2, j0 }, { i0 + 2, j0 + 2 }, { i0, j0 + 2 } };
+					glm::vec2 crossings[4];
+					int count = 0;
+					for (int k = 0; k < 4; k++) {
+						if ((at(corners[k]) < isoLevel) != (at(corners[(k + 1) % 4]) < isoLevel))
+							crossings[count++] = crossing(corners[k], corners[(k + 1) % 4]);
+					}
+					glm::vec2 start, end;
+					if (count == 2) {
+						start = crossings[0];
+						end = crossings[1];
+					}
+					else if (count == 4) {
+						glm::ivec2 q0, q1;
+						if (iu >= 0) {
+							q0 = { iu, (int)point.y };
+							q1 = { iu, (int)point.y + 1 };
+						}
+						else if (iv >= 0) {
+							q0 = { (int)point.x, iv };
+							q1 = { (int)point.x + 1, iv };
+						}
+						else {
+							continue;
+						}
+						//The end of the fine edge on the other side than the center is a corner or a sample halfway along an edge next to it
+						bool centerInside = at({ i0 + 1, j0 + 1 }) < isoLevel;
+						glm::ivec2 q = (at(q0) < isoLevel) != centerInside ? q0 : q1;
+						int corner = -1;
+						for (int k = 0; k < 4 && corner < 0; k++) {
+							glm::ivec2 d = glm::abs(q - corners[k]);
+							if ((at(corners[k]) < isoLevel) != centerInside && d.x + d.y <= 1)
+								corner = k;
+						}
+						if (corner < 0)
+							continue;
+						start = crossing(corners[corner], corners[(corner + 3) % 4]);
+						end = crossing(corners[corner], corners[(corner + 1) % 4]);
+					}
+					else {
+						continue;
+					}
+					glm::vec2 line = end - start;
+					float lengthSquared = glm::dot(line, line);
+					float t = lengthSquared > 0.0f ? glm::clamp(glm::dot(point - start, line) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+					point = start + t * line;
+				}
+				position[u] = point.x;
+				position[v] = point.y;
+			}
+		}
+	}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include "Core.h"
+
+namespace Core {
+	//Level of detail of a marching cubes chunk. A chunk at level n keeps its world size but samples the density on a lattice with a stride of
+	//2^n, so it has 8^n times fewer samples and about 4^n times fewer triangles. Neighbouring chunks differ by at most one level. Where a chunk
+	//borders a coarser one, the samples on the shared faces and edges follow the coarse lattice and the face vertices are moved onto the coarse
+	//surface, so both meshes end on the same boundary and the seam has no cracks.
+	struct MarchingCubesLod {
+		int level = 0;
+		uint8_t coarserFaces = 0; //bit per face -x, +x, -y, +y, -z, +z whose neighbour is one level coarser
+		uint16_t coarserEdges = 0; //bit per chunk edge touching a coarser chunk, edge a * 4 + b + 2 * c runs along axis a at the low (0) or high (1) side of the next two axes
+
+		int Stride() const { return 1 << level; }
+		//Changes whenever the mesh of the chunk would, usable as the variant of a ChunkStreamer
+		uint32_t Key() const { return (uint32_t)level | ((uint32_t)coarserFaces << 4) | ((uint32_t)coarserEdges << 10); }
+	};
+
+	//Full resolution up to lodDistance chunks from center along every axis, then rings twice as wide as the one before at half the resolution
+	int MarchingCubesLodLevel(glm::ivec3 coord, glm::ivec3 center, int lodDistance, int maxLevel);
+	//Level and coarser neighbours of a chunk. maxLevel is lowered until its stride divides the chunk size and leaves two cells along every axis.
+	MarchingCubesLod SelectMarchingCubesLod(glm::ivec3 coord, glm::ivec3 center, glm::ivec3 chunkSize, int lodDistance, int maxLevel);
+
+	//Overwrites the samples on the coarser faces and edges that are not on the coarse lattice. On chunk edges they become the linear
+	//interpolation, so the surface crosses the edge where the coarse chunk has its vertex. Inside a face they are chosen so the fine contour
+	//has the same shape as the coarse one, ambiguous squares resolved the way the coarse chunk's table does. size is the padded sample count,
+	//latticeOffset and latticeFrequency are what the chunk was sampled with.
+	void StitchMarchingCubesDensities(std::vector<float>& densities, glm::ivec3 size, glm::vec3 latticeOffset, float latticeFrequency, const MarchingCubesLod& lod, float isoLevel = 0.0f);
+	//Moves the vertices on the coarser faces onto the contour of the coarse chunk: crossings of coarse edges to where the coarse chunk has
+	//them, the rest onto the line between the two crossings of their coarse square. Positions are relative to the chunk, in lattice units.
+	void SnapMarchingCubesBorder(CpuVoxelMesh& mesh, const std::vector<float>& densities, glm::ivec3 size, const MarchingCubesLod& lod, float isoLevel = 0.0f);
+}
@@ -0,0 +1,81 @@
+#include "PackedVertices.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Core {
+	namespace {
+		uint32_t Field(float value, uint32_t max) {
+			return (uint32_t)std::clamp(std::lround(value), 0l, (long)max);
+		}
+
+		uint32_t FaceOf(glm::vec3 normal) {
+			glm::vec3 a = glm::abs(normal);
+			int axis = a.x >= a.y && a.x >= a.z ? 0 : (a.y >= a.z ? 1 : 2);
+			return (uint32_t)(axis * 2 + (normal[axis] < 0.0f ? 1 : 0));
+		}
+
+		int16_t Snorm16(float value) {
+			return (int16_t)std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f);
+		}
+
+		//Projects the unit sphere onto the octahedron and folds its lower half over the upper one
+		glm::vec2 OctahedralEncode(glm::vec3 n) {
+			n /= std::abs(n.x) + std::abs(n.y) + std::abs(n.z) + 1e-20f;
+			glm::vec2 e(n.x, n.y);
+			if (n.z < 0.0f) {
+				e = (1.0f - glm::abs(glm::vec2(e.y, e.x))) * glm::vec2(e.x >= 0.0f ? 1.0f : -1.0f, e.y >= 0.0f ? 1.0f : -1.0f);
+			}
+			return e;
+		}
+	}
+
+	void PackVoxelCubesVertices(const PlaneMesh& mesh, glm::vec3 origin, bool tiledUVs, glm::vec2 atlasSize, std::vector<PackedVoxelVertex>& vertices) {
+		vertices.resize(mesh.vertices.size());
+		bool hasUVs = mesh.UVs.size() == mesh.vertices.size();
+		for (size_t quad = 0; quad < mesh.vertices.size(); quad += 4) {
+			size_t corners = std::min<size_t>(4, mesh.vertices.size() - quad);
+
+			//One tile per quad. Atlas corner UVs only name it at their centre, the tiled encoding at every corner.
+			glm::vec2 tile(0.0f);
+			if (hasUVs) {
+				if (tiledUVs) {
+					tile = glm::floor(mesh.UVs[quad] / VoxelAtlasTileStride);
+				}
+				else {
+					glm::vec2 centre(0.0f);
+					for (size_t c = 0; c < corners; c++) centre += mesh.UVs[quad + c];
+					tile = glm::floor(centre / (float)corners * atlasSize);
+				}
+			}
+
+			for (size_t c = 0; c < corners; c++) {
+				size_t i = quad + c;
+				glm::vec3 p = mesh.vertices[i] - origin;
+				glm::vec2 local(0.0f);
+				if (hasUVs) local = tiledUVs ? mesh.UVs[i] - tile * VoxelAtlasTileStride : mesh.UVs[i] * atlasSize - tile;
+
+				PackedVoxelVertex& v = vertices[i];
+				v.position = Field(p.x, 1023) | Field(p.y, 1023) << 10 | Field(p.z, 1023) << 20;
+				v.attributes = FaceOf(mesh.normals[i]) | Field(tile.x, 15) << 3 | Field(tile.y, 31) << 7 | Field(local.x, 1023) << 12 | Field(local.y, 1023) << 22;
+			}
+		}
+	}
+
+	void PackMarchingCubesVertices(const CpuVoxelMesh& mesh, glm::vec3 origin, glm::vec3 extent, std::vector<PackedMarchingCubesVertex>& vertices) {
+		vertices.resize(mesh.vertices.size());
+		glm::vec3 scale = 65535.0f / glm::max(extent, glm::vec3(1e-6f));
+		for (size_t i = 0; i < mesh.vertices.size(); i++) {
+			glm::vec3 p = (mesh.vertices[i] - origin) * scale;
+			glm::vec2 n = OctahedralEncode(mesh.normals[i]);
+
+			PackedMarchingCubesVertex& v = vertices[i];
+			for (int axis = 0; axis < 3; axis++) {
+				v.position[axis] = (uint16_t)Field(p[axis], 65535);
+			}
+			v.normal[0] = Snorm16(n.x);
+			v.normal[1] = Snorm16(n.y);
+			v.padding = 0;
+		}
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "Core.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Core {
+	//Interleaved 8 byte vertex of a voxel cubes mesh, 4 times smaller than the float vertex, normal and UV of a PlaneMesh. Voxel cube corners
+	//are lattice points of the chunk and their normal is one of six axes, so everything fits in two words:
+	//	position: x | y << 10 | z << 20, the corner relative to the chunk origin, each axis below 1024
+	//	attributes: face | tile.x << 3 | tile.y << 7 | local.x << 12 | local.y << 22
+	//face indexes +x, -x, +y, -y, +z, -z, tile is the atlas (column, row) below (16, 32) and local the corner on the quad in blocks, 0 or 1 per
+	//axis unless the quad is greedy merged. The demo shader.vert decodes it.
+	struct PackedVoxelVertex {
+		uint32_t position;
+		uint32_t attributes;
+	};
+
+	//Interleaved 12 byte vertex of a marching cubes mesh instead of 24 bytes of float position and normal. The position is unorm16 across the
+	//chunk extent from its origin, so neighbouring chunks quantize their shared border vertices alike, and the normal is snorm16 octahedral.
+	struct PackedMarchingCubesVertex {
+		uint16_t position[3];
+		int16_t normal[2];
+		uint16_t padding;
+	};
+
+	//Packs the vertices of a mesh from the voxel cubes meshers, which write every quad as four consecutive vertices. tiledUVs are greedy
+	//quads with their UVs in the VoxelAtlasTileStride encoding, otherwise the UVs are the atlas corners of a columns x rows atlas.
+	void PackVoxelCubesVertices(const PlaneMesh& mesh, glm::vec3 origin, bool tiledUVs, glm::vec2 atlasSize, std::vector<PackedVoxelVertex>& vertices);
+	void PackMarchingCubesVertices(const CpuVoxelMesh& mesh, glm::vec3 origin, glm::vec3 extent, std::vector<PackedMarchingCubesVertex>& vertices);
+}
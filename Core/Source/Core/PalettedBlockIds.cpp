@@ -0,0 +1,158 @@
+#include "PalettedBlockIds.h"
+
+#include <algorithm>
+
+namespace Core {
+	namespace {
+		size_t WordCount(int count, int bits) {
+			int perWord = 64 / bits;
+			return (size_t)((count + perWord - 1) / perWord);
+		}
+
+		//The width is a template argument so the shifts and masks of the inner loops are constants
+		template<int Bits>
+		void Pack(const int* indices, int count, uint64_t* words) {
+			constexpr int perWord = 64 / Bits;
+			for (int first = 0; first < count; first += perWord) {
+				int n = std::min(perWord, count - first);
+				uint64_t word = 0;
+				for (int i = 0; i < n; i++) {
+					word |= (uint64_t)(uint32_t)indices[first + i] << (i * Bits);
+				}
+				*words++ = word;
+			}
+		}
+
+		template<int Bits>
+		void Unpack(const uint64_t* words, int count, const int* palette, int* ids) {
+			constexpr int perWord = 64 / Bits;
+			constexpr uint64_t mask = (1ull << Bits) - 1;
+			int full = count / perWord;
+			for (int w = 0; w < full; w++) {
+				uint64_t word = words[w];
+				for (int i = 0; i < perWord; i++) {
+					ids[i] = palette[word & mask];
+					word >>= Bits;
+				}
+				ids += perWord;
+			}
+			int rest = count - full * perWord;
+			if (rest > 0) {
+				uint64_t word = words[full];
+				for (int i = 0; i < rest; i++) {
+					ids[i] = palette[word & mask];
+					word >>= Bits;
+				}
+			}
+		}
+
+		void PackIndices(const int* indices, int count, int bits, uint64_t* words) {
+			switch (bits) {
+			case 1: Pack<1>(indices, count, words); break;
+			case 2: Pack<2>(indices, count, words); break;
+			case 4: Pack<4>(indices, count, words); break;
+			case 8: Pack<8>(indices, count, words); break;
+			case 16: Pack<16>(indices, count, words); break;
+			default: Pack<32>(indices, count, words); break;
+			}
+		}
+	}
+
+	void PalettedBlockIds::Encode(const BlockIds& blockIDs) {
+		_count = (int)blockIDs.IDs.size();
+		_palette.clear();
+
+		//Palette indices first, the ids of neighbouring blocks mostly repeat so the last lookup is checked before the palette
+		std::vector<int> indices(_count);
+		int lastId = 0;
+		int lastIndex = -1;
+		for (int i = 0; i < _count; i++) {
+			int id = blockIDs.IDs[i];
+			if (lastIndex < 0 || id != lastId) {
+				auto it = std::find(_palette.begin(), _palette.end(), id);
+				lastIndex = (int)(it - _palette.begin());
+				if (it == _palette.end()) _palette.push_back(id);
+				lastId = id;
+			}
+			indices[i] = lastIndex;
+		}
+
+		_bits = BitsFor(_palette.size());
+		_words.assign(WordCount(_count, _bits), 0);
+		PackIndices(indices.data(), _count, _bits, _words.data());
+	}
+
+	void PalettedBlockIds::Decode(BlockIds& blockIDs) const {
+		blockIDs.IDs.resize(_count);
+		Decode(blockIDs.IDs.data());
+	}
+
+	void PalettedBlockIds::Decode(int* ids) const {
+		if (_count == 0) return;
+		switch (_bits) {
+		case 1: Unpack<1>(_words.data(), _count, _palette.data(), ids); break;
+		case 2: Unpack<2>(_words.data(), _count, _palette.data(), ids); break;
+		case 4: Unpack<4>(_words.data(), _count, _palette.data(), ids); break;
+		case 8: Unpack<8>(_words.data(), _count, _palette.data(), ids); break;
+		case 16: Unpack<16>(_words.data(), _count, _palette.data(), ids); break;
+		default: Unpack<32>(_words.data(), _count, _palette.data(), ids); break;
+		}
+	}
+
+	int PalettedBlockIds::Get(int index) const {
+		int perWord = 64 / _bits;
+		uint64_t mask = (1ull << _bits) - 1;
+		uint64_t word = _words[index / perWord];
+		return _palette[(word >> ((index % perWord) * _bits)) & mask];
+	}
+
+	void PalettedBlockIds::Set(int index, int id) {
+		auto it = std::find(_palette.begin(), _palette.end(), id);
+		int paletteIndex = (int)(it - _palette.begin());
+		if (it == _palette.end()) {
+			_palette.push_back(id);
+			int bits = BitsFor(_palette.size());
+			if (bits != _bits) Grow(bits);
+		}
+
+		int perWord = 64 / _bits;
+		int shift = (index % perWord) * _bits;
+		uint64_t mask = ((1ull << _bits) - 1) << shift;
+		uint64_t& word = _words[index / perWord];
+		word = (word & ~mask) | ((uint64_t)paletteIndex << shift);
+	}
+
+	void PalettedBlockIds::Clear() {
+		_palette.clear();
+		_words.clear();
+		_count = 0;
+		_bits = 1;
+	}
+
+	void PalettedBlockIds::Assign(const int* palette, int paletteSize, const uint64_t* words, int count, int bits) {
+		_palette.assign(palette, palette + paletteSize);
+		_count = count;
+		_bits = bits;
+		_words.assign(words, words + WordCount(count, bits));
+	}
+
+	void PalettedBlockIds::Grow(int bits) {
+		//Unpacks to palette indices through an identity palette, then packs them at the new width
+		std::vector<int> identity(_palette.size());
+		for (int i = 0; i < (int)identity.size(); i++) identity[i] = i;
+		std::vector<int> indices(_count);
+		std::swap(identity, _palette);
+		Decode(indices.data());
+		std::swap(identity, _palette);
+
+		_bits = bits;
+		_words.assign(WordCount(_count, _bits), 0);
+		PackIndices(indices.data(), _count, _bits, _words.data());
+	}
+
+	int PalettedBlockIds::BitsFor(size_t paletteSize) {
+		int bits = 1;
+		while (bits < 32 && ((size_t)1 << bits) < paletteSize) bits *= 2;
+		return bits;
+	}
+}
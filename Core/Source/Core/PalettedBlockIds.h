@@ -0,0 +1,45 @@
+#pragma once
+#include "Core.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Core {
+	//BlockIds of one chunk stored as a palette of the ids it uses and an index into the palette per block, bit-packed into 64 bit words. The
+	//index width is 1, 2, 4, 8, 16 or 32 bits, the smallest the palette fits in, and grows when Set adds an id that doesn't fit. A voxel cubes
+	//chunk only uses a handful of ids, so it packs at 2 bits per block instead of 32. Decode the chunk into a scratch BlockIds before handing
+	//it to the meshers or the shaders.
+	class PalettedBlockIds {
+	public:
+		PalettedBlockIds() = default;
+		explicit PalettedBlockIds(const BlockIds& blockIDs) { Encode(blockIDs); }
+
+		//Replaces the contents with blockIDs and shrinks the palette to the ids it uses
+		void Encode(const BlockIds& blockIDs);
+		//Resizes blockIDs to GetCount() and writes every id
+		void Decode(BlockIds& blockIDs) const;
+		void Decode(int* ids) const;
+		int Get(int index) const;
+		void Set(int index, int id);
+		void Clear();
+		//Takes packed contents as GetPalette, GetWords and GetBitsPerIndex hand them out, e.g. read back from a region file
+		void Assign(const int* palette, int paletteSize, const uint64_t* words, int count, int bits);
+
+		int GetCount() const { return _count; }
+		int GetBitsPerIndex() const { return _bits; }
+		const std::vector<int>& GetPalette() const { return _palette; }
+		const std::vector<uint64_t>& GetWords() const { return _words; }
+		//Bytes of the palette and the packed indices
+		size_t GetBytes() const { return _palette.size() * sizeof(int) + _words.size() * sizeof(uint64_t); }
+
+	private:
+		std::vector<int> _palette;
+		std::vector<uint64_t> _words;
+		int _count = 0;
+		int _bits = 1;
+
+		//Repacks the indices with the given width
+		void Grow(int bits);
+		static int BitsFor(size_t paletteSize);
+	};
+}
@@ -0,0 +1,151 @@
+#include "Profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace Core {
+	namespace {
+		struct PendingQuery {
+			ProfileStage stage;
+			GLuint begin;
+			GLuint end;
+		};
+
+		std::atomic<bool> _profilingEnabled{ false };
+		std::mutex _profileMutex;
+		ProfileStageStats _stageStats[ProfileStageCount];
+		std::chrono::steady_clock::time_point _resetTime = std::chrono::steady_clock::now();
+		//Only touched on the GL thread, the mutex covers them anyway since GetProfileStats reads both
+		std::deque<PendingQuery> _pendingQueries;
+		std::vector<GLuint> _freeQueries;
+		std::vector<GLuint> _allQueries;
+
+		GLuint TakeQuery() {
+			if (_freeQueries.empty()) {
+				//Grown in blocks, a frame of streamed chunks issues a few dozen
+				GLuint queries[32];
+				glGenQueries(32, queries);
+				_freeQueries.insert(_freeQueries.end(), queries, queries + 32);
+				_allQueries.insert(_allQueries.end(), queries, queries + 32);
+			}
+			GLuint query = _freeQueries.back();
+			_freeQueries.pop_back();
+			return query;
+		}
+
+		//Timestamps finish in the order they were issued, so stop at the first one that has not arrived. Never waits.
+		void ResolveQueries() {
+			while (!_pendingQueries.empty()) {
+				PendingQuery& pending = _pendingQueries.front();
+				GLint available = 0;
+				glGetQueryObjectiv(pending.end, GL_QUERY_RESULT_AVAILABLE, &available);
+				if (!available) break;
+
+				GLuint64 begin = 0, end = 0;
+				glGetQueryObjectui64v(pending.begin, GL_QUERY_RESULT, &begin);
+				glGetQueryObjectui64v(pending.end, GL_QUERY_RESULT, &end);
+				double ms = end > begin ? (end - begin) / 1e6 : 0.0;
+				ProfileStageStats& stats = _stageStats[(int)pending.stage];
+				stats.gpuSamples++;
+				stats.gpuMs += ms;
+				stats.gpuMaxMs = std::max(stats.gpuMaxMs, ms);
+
+				_freeQueries.push_back(pending.begin);
+				_freeQueries.push_back(pending.end);
+				_pendingQueries.pop_front();
+			}
+		}
+	}
+
+	const char* GetProfileStageName(ProfileStage stage) {
+		switch (stage) {
+		case ProfileStage::HeightMapVertices: return "HeightMap vertices";
+		case ProfileStage::HeightMapIndices: return "HeightMap indices";
+		case ProfileStage::HeightMapDisplace: return "HeightMap displace";
+		case ProfileStage::HeightMapNormals: return "HeightMap normals";
+		case ProfileStage::HeightMapChunk: return "HeightMap fused chunk";
+		case ProfileStage::Noise: return "Noise";
+		case ProfileStage::Classify: return "Classify";
+		case ProfileStage::SurfaceCulling: return "Surface culling";
+		case ProfileStage::TriangleCount: return "Triangle count";
+		case ProfileStage::MarchingCubesMesh: return "Marching cubes mesh";
+		case ProfileStage::Readback: return "Readback";
+		case ProfileStage::VoxelSpline: return "Voxel spline";
+		case ProfileStage::VoxelPaint: return "Voxel paint";
+		case ProfileStage::VoxelQuadCount: return "Voxel quad count";
+		case ProfileStage::VoxelMesh: return "Voxel mesh";
+		case ProfileStage::Upload: return "Upload";
+		}
+		return "Unknown";
+	}
+
+	void SetProfilingEnabled(bool enabled) {
+		_profilingEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool IsProfilingEnabled() {
+		return _profilingEnabled.load(std::memory_order_relaxed);
+	}
+
+	ProfileStats GetProfileStats() {
+		std::lock_guard<std::mutex> lock(_profileMutex);
+		ResolveQueries();
+		ProfileStats stats;
+		std::copy(std::begin(_stageStats), std::end(_stageStats), std::begin(stats.stages));
+		stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _resetTime).count();
+		stats.pendingQueries = (int)_pendingQueries.size();
+		return stats;
+	}
+
+	void ResetProfileStats() {
+		std::lock_guard<std::mutex> lock(_profileMutex);
+		//Samples still in flight belong to the old totals
+		for (const PendingQuery& pending : _pendingQueries) {
+			_freeQueries.push_back(pending.begin);
+			_freeQueries.push_back(pending.end);
+		}
+		_pendingQueries.clear();
+		std::fill(std::begin(_stageStats), std::end(_stageStats), ProfileStageStats());
+		_resetTime = std::chrono::steady_clock::now();
+	}
+
+	void ReleaseProfileQueries() {
+		std::lock_guard<std::mutex> lock(_profileMutex);
+		if (!_allQueries.empty()) glDeleteQueries((GLsizei)_allQueries.size(), _allQueries.data());
+		_allQueries.clear();
+		_freeQueries.clear();
+		_pendingQueries.clear();
+	}
+
+	ProfileScope::ProfileScope(ProfileStage stage, bool gpu) : _stage(stage) {
+		if (!IsProfilingEnabled()) return;
+		_active = true;
+		if (gpu) {
+			std::lock_guard<std::mutex> lock(_profileMutex);
+			//Resolving here too keeps the pending list short when nobody reads the stats
+			ResolveQueries();
+			_beginQuery = TakeQuery();
+			_endQuery = TakeQuery();
+			glQueryCounter(_beginQuery, GL_TIMESTAMP);
+		}
+		_start = Clock::now();
+	}
+
+	ProfileScope::~ProfileScope() {
+		if (!_active) return;
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - _start).count();
+
+		std::lock_guard<std::mutex> lock(_profileMutex);
+		ProfileStageStats& stats = _stageStats[(int)_stage];
+		stats.calls++;
+		stats.cpuMs += ms;
+		stats.cpuMaxMs = std::max(stats.cpuMaxMs, ms);
+		if (_endQuery) {
+			glQueryCounter(_endQuery, GL_TIMESTAMP);
+			_pendingQueries.push_back({ _stage, _beginQuery, _endQuery });
+		}
+	}
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <glad/glad.h>
+
+#include <chrono>
+#include <cstdint>
+
+namespace Core {
+	//The stages Core times, shared by the GPU passes, the CPU backend and the chunk jobs
+	enum class ProfileStage : uint8_t {
+		HeightMapVertices,
+		HeightMapIndices,
+		HeightMapDisplace,
+		HeightMapNormals,
+		HeightMapChunk,
+		Noise,
+		Classify,
+		SurfaceCulling,
+		TriangleCount,
+		MarchingCubesMesh,
+		Readback,
+		VoxelSpline,
+		VoxelPaint,
+		VoxelQuadCount,
+		VoxelMesh,
+		Upload,
+	};
+	constexpr int ProfileStageCount = (int)ProfileStage::Upload + 1;
+
+	const char* GetProfileStageName(ProfileStage stage);
+
+	//Totals since the last reset, in milliseconds. CPU time is wall time on whichever thread ran the stage, so stages running on several
+	//job threads at once can add up to more than the time that passed. GPU time only covers stages issued on the GPU backend.
+	struct ProfileStageStats {
+		uint64_t calls = 0;
+		double cpuMs = 0.0;
+		double cpuMaxMs = 0.0;
+		uint64_t gpuSamples = 0;
+		double gpuMs = 0.0;
+		double gpuMaxMs = 0.0;
+
+		double CpuAverageMs() const { return calls ? cpuMs / calls : 0.0; }
+		double GpuAverageMs() const { return gpuSamples ? gpuMs / gpuSamples : 0.0; }
+	};
+
+	struct ProfileStats {
+		ProfileStageStats stages[ProfileStageCount];
+		double seconds = 0.0; //since the last reset
+		int pendingQueries = 0; //GPU samples issued but not resolved yet
+
+		const ProfileStageStats& operator[](ProfileStage stage) const { return stages[(int)stage]; }
+	};
+
+	//Off by default, a disabled scope only reads one atomic flag
+	void SetProfilingEnabled(bool enabled);
+	bool IsProfilingEnabled();
+	//Resolves the timer queries whose results have arrived without waiting for the rest, so GPU times lag a frame or two behind the
+	//CPU ones. Call it on the thread that owns the GL context.
+	ProfileStats GetProfileStats();
+	void ResetProfileStats();
+	//Deletes the query pool, pending samples are dropped
+	void ReleaseProfileQueries();
+
+	//Times the enclosing block as one call of stage. With gpu set it also brackets the commands issued inside it with a pair of
+	//GL_TIMESTAMP queries, which must happen on the GL thread; CPU only scopes are safe on any thread.
+	class ProfileScope {
+	public:
+		explicit ProfileScope(ProfileStage stage, bool gpu = false);
+		~ProfileScope();
+		ProfileScope(const ProfileScope&) = delete;
+		ProfileScope& operator=(const ProfileScope&) = delete;
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		ProfileStage _stage;
+		bool _active = false;
+		GLuint _beginQuery = 0;
+		GLuint _endQuery = 0;
+		Clock::time_point _start;
+	};
+}
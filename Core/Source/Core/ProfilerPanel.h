@@ -0,0 +1,56 @@
+#pragma once
+#include "Profiler.h"
+
+#include "imgui.h"
+
+namespace Core {
+	//ImGui window with the profiling switch and a row per stage that has run since the last reset. Header only, so Core itself does not
+	//depend on ImGui; call it between ImGui::NewFrame and ImGui::Render on the GL thread.
+	inline void ShowProfilerPanel() {
+		ImGui::SetNextWindowSize(ImVec2(520, 360), ImGuiCond_FirstUseEver);
+		ImGui::Begin("Core Profiler");
+
+		bool enabled = IsProfilingEnabled();
+		if (ImGui::Checkbox("Enabled", &enabled))
+			SetProfilingEnabled(enabled);
+		ImGui::SameLine();
+		if (ImGui::Button("Reset"))
+			ResetProfileStats();
+
+		ProfileStats stats = GetProfileStats();
+		ImGui::Text("%.1f s since reset  |  %d GPU samples pending", stats.seconds, stats.pendingQueries);
+
+		ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingStretchProp;
+		if (ImGui::BeginTable("Stages", 6, flags)) {
+			ImGui::TableSetupColumn("Stage");
+			ImGui::TableSetupColumn("Calls");
+			ImGui::TableSetupColumn("CPU avg ms");
+			ImGui::TableSetupColumn("CPU max ms");
+			ImGui::TableSetupColumn("GPU avg ms");
+			ImGui::TableSetupColumn("GPU max ms");
+			ImGui::TableHeadersRow();
+			for (int i = 0; i < ProfileStageCount; i++) {
+				const ProfileStageStats& stage = stats.stages[i];
+				if (stage.calls == 0) continue;
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ImGui::TextUnformatted(GetProfileStageName((ProfileStage)i));
+				ImGui::TableNextColumn();
+				ImGui::Text("%llu", (unsigned long long)stage.calls);
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", stage.CpuAverageMs());
+				ImGui::TableNextColumn();
+				ImGui::Text("%.3f", stage.cpuMaxMs);
+				ImGui::TableNextColumn();
+				if (stage.gpuSamples) ImGui::Text("%.3f", stage.GpuAverageMs());
+				else ImGui::TextDisabled("-");
+				ImGui::TableNextColumn();
+				if (stage.gpuSamples) ImGui::Text("%.3f", stage.gpuMaxMs);
+				else ImGui::TextDisabled("-");
+			}
+			ImGui::EndTable();
+		}
+
+		ImGui::End();
+	}
+}
@@ -0,0 +1,466 @@
+#include "RegionFile.h"
+#include "DensityStore.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Core {
+	namespace {
+		constexpr uint32_t RegionMagic = 0x47524C54; //"TLRG"
+		constexpr uint32_t RecordMagic = 0x4B434C54; //"TLCK"
+		constexpr uint32_t RegionVersion = 1;
+		constexpr int RegionSlots = RegionStore::RegionSize * RegionStore::RegionSize;
+
+		struct RegionHeader {
+			uint32_t magic;
+			uint32_t version;
+			uint32_t slotCount;
+			uint32_t reserved;
+		};
+		struct RegionEntry {
+			uint64_t offset; //0 when the chunk was never saved
+			uint64_t size;
+		};
+		constexpr size_t TableOffset = sizeof(RegionHeader);
+		constexpr size_t DataOffset = TableOffset + RegionSlots * sizeof(RegionEntry);
+
+		//Every count of a record, the arrays follow in this order
+		struct RecordHeader {
+			uint32_t magic;
+			int32_t coord[3];
+			uint32_t occupancy;
+			uint32_t blockCount;
+			uint32_t blockBits;
+			uint32_t paletteCount;
+			uint32_t wordCount;
+			uint32_t densityCount;
+			float densityIsoLevel;
+			float densityRange;
+			uint32_t vertexCount;
+			uint32_t normalCount;
+			uint32_t indexCount;
+			uint32_t uvCount;
+		};
+
+		size_t Align(size_t size) {
+			return (size + 7) & ~(size_t)7;
+		}
+
+		//Byte sizes of the arrays of a record, in file order
+		void ArraySizes(const RecordHeader& header, size_t sizes[7]) {
+			sizes[0] = header.paletteCount * sizeof(int);
+			sizes[1] = header.wordCount * sizeof(uint64_t);
+			sizes[2] = header.densityCount * sizeof(int16_t);
+			sizes[3] = header.vertexCount * sizeof(glm::vec3);
+			sizes[4] = header.normalCount * sizeof(glm::vec3);
+			sizes[5] = header.indexCount * sizeof(int);
+			sizes[6] = header.uvCount * sizeof(glm::vec2);
+		}
+
+		std::vector<uint8_t> Serialize(glm::ivec3 coord, const RegionChunk& chunk) {
+			RecordHeader header = {};
+			header.magic = RecordMagic;
+			header.coord[0] = coord.x;
+			header.coord[1] = coord.y;
+			header.coord[2] = coord.z;
+			header.occupancy = (uint32_t)chunk.occupancy;
+			header.blockCount = (uint32_t)chunk.blockIDs.GetCount();
+			header.blockBits = (uint32_t)chunk.blockIDs.GetBitsPerIndex();
+			header.paletteCount = (uint32_t)chunk.blockIDs.GetPalette().size();
+			header.wordCount = (uint32_t)chunk.blockIDs.GetWords().size();
+			header.densityCount = (uint32_t)chunk.densities.size();
+			header.densityIsoLevel = chunk.densityIsoLevel;
+			header.densityRange = chunk.densityRange;
+			header.vertexCount = (uint32_t)chunk.mesh.vertices.size();
+			header.normalCount = (uint32_t)chunk.mesh.normals.size();
+			header.indexCount = (uint32_t)chunk.mesh.indices.size();
+			header.uvCount = (uint32_t)chunk.mesh.UVs.size();
+
+			size_t sizes[7];
+			ArraySizes(header, sizes);
+			size_t total = Align(sizeof(RecordHeader));
+			for (size_t size : sizes) total += Align(size);
+
+			std::vector<uint8_t> record(total, 0);
+			std::memcpy(record.data(), &header, sizeof(header));
+			const void* arrays[7] = {
+				chunk.blockIDs.GetPalette().data(), chunk.blockIDs.GetWords().data(), nullptr,
+				chunk.mesh.vertices.data(), chunk.mesh.normals.data(), chunk.mesh.indices.data(), chunk.mesh.UVs.data()
+			};
+			size_t offset = Align(sizeof(RecordHeader));
+			for (int i = 0; i < 7; i++) {
+				if (i == 2)
+					QuantizeDensities(chunk.densities.data(), (int)chunk.densities.size(), (int16_t*)(record.data() + offset), chunk.densityIsoLevel, chunk.densityRange);
+				else if (sizes[i] > 0)
+					std::memcpy(record.data() + offset, arrays[i], sizes[i]);
+				offset += Align(sizes[i]);
+			}
+			return record;
+		}
+
+		//Every packed index has to point into the palette, Decode and Get look them up without a check
+		bool IndicesInPalette(const uint64_t* words, uint32_t blockCount, uint32_t bits, uint32_t paletteCount) {
+			uint32_t perWord = 64 / bits;
+			uint64_t mask = (1ull << bits) - 1;
+			for (uint32_t first = 0; first < blockCount; first += perWord) {
+				uint64_t word = *words++;
+				uint32_t n = std::min(perWord, blockCount - first);
+				for (uint32_t i = 0; i < n; i++) {
+					if ((word & mask) >= paletteCount) return false;
+					word >>= bits;
+				}
+			}
+			return true;
+		}
+
+		bool Deserialize(const uint8_t* data, size_t size, glm::ivec3 coord, RegionChunk& chunk) {
+			RecordHeader header;
+			if (size < sizeof(header)) return false;
+			std::memcpy(&header, data, sizeof(header));
+			if (header.magic != RecordMagic || glm::ivec3(header.coord[0], header.coord[1], header.coord[2]) != coord)
+				return false;
+
+			size_t sizes[7];
+			ArraySizes(header, sizes);
+			size_t total = Align(sizeof(RecordHeader));
+			for (size_t arraySize : sizes) total += Align(arraySize);
+			if (total > size) return false;
+
+			//Assign trusts the packed contents, so a header that doesn't describe a valid packing is damaged, and so are indices past the palette
+			if (header.blockCount > 0) {
+				uint32_t bits = header.blockBits;
+				if (bits != 1 && bits != 2 && bits != 4 && bits != 8 && bits != 16 && bits != 32) return false;
+				if (header.blockCount > (uint32_t)INT32_MAX || header.paletteCount == 0) return false;
+				if (bits < 32 && header.paletteCount > (1u << bits)) return false;
+				uint32_t perWord = 64 / bits;
+				if (header.wordCount != (header.blockCount + perWord - 1) / perWord) return false;
+			}
+
+			const uint8_t* arrays[7];
+			size_t offset = Align(sizeof(RecordHeader));
+			for (int i = 0; i < 7; i++) {
+				arrays[i] = data + offset;
+				offset += Align(sizes[i]);
+			}
+			if (header.blockCount > 0 && !IndicesInPalette((const uint64_t*)arrays[1], header.blockCount, header.blockBits, header.paletteCount))
+				return false;
+
+			chunk.occupancy = (ChunkOccupancy)header.occupancy;
+			if (header.blockCount > 0)
+				chunk.blockIDs.Assign((const int*)arrays[0], header.paletteCount, (const uint64_t*)arrays[1], header.blockCount, header.blockBits);
+			else
+				chunk.blockIDs.Clear();
+			chunk.densityIsoLevel = header.densityIsoLevel;
+			chunk.densityRange = header.densityRange;
+			chunk.densities.resize(header.densityCount);
+			DequantizeDensities((const int16_t*)arrays[2], header.densityCount, chunk.densities.data(), header.densityIsoLevel, header.densityRange);
+			chunk.mesh.vertices.assign((const glm::vec3*)arrays[3], (const glm::vec3*)arrays[3] + header.vertexCount);
+			chunk.mesh.normals.assign((const glm::vec3*)arrays[4], (const glm::vec3*)arrays[4] + header.normalCount);
+			chunk.mesh.indices.assign((const int*)arrays[5], (const int*)arrays[5] + header.indexCount);
+			chunk.mesh.UVs.assign((const glm::vec2*)arrays[6], (const glm::vec2*)arrays[6] + header.uvCount);
+			return true;
+		}
+
+		int FloorDiv(int a, int b) {
+			return a >= 0 ? a / b : -((-a + b - 1) / b);
+		}
+	}
+
+	//A read only view of a whole file, unmapped when the last load that uses it is done
+	struct RegionStore::MappedFile {
+		const uint8_t* data = nullptr;
+		size_t size = 0;
+#ifdef _WIN32
+		HANDLE file = INVALID_HANDLE_VALUE;
+		HANDLE mapping = nullptr;
+#endif
+
+		bool Open(const std::string& path) {
+#ifdef _WIN32
+			//The writer keeps the file open for writing while it is mapped
+			file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if (file == INVALID_HANDLE_VALUE) return false;
+			LARGE_INTEGER fileSize;
+			if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) return false;
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (!mapping) return false;
+			data = (const uint8_t*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			size = (size_t)fileSize.QuadPart;
+#else
+			int fd = open(path.c_str(), O_RDONLY);
+			if (fd < 0) return false;
+			struct stat info;
+			if (fstat(fd, &info) != 0 || info.st_size == 0) {
+				close(fd);
+				return false;
+			}
+			void* view = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			close(fd);
+			if (view == MAP_FAILED) return false;
+			data = (const uint8_t*)view;
+			size = (size_t)info.st_size;
+#endif
+			return data != nullptr;
+		}
+
+		~MappedFile() {
+#ifdef _WIN32
+			if (data) UnmapViewOfFile(data);
+			if (mapping) CloseHandle(mapping);
+			if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+			if (data) munmap((void*)data, size);
+#endif
+		}
+	};
+
+	RegionStore::RegionStore() : _writer(&RegionStore::WriterLoop, this) {}
+
+	RegionStore::RegionStore(const std::string& directory) : RegionStore() {
+		Open(directory);
+	}
+
+	RegionStore::~RegionStore() {
+		Flush();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			CompactFiles();
+			_files.clear();
+			_stop = true;
+		}
+		_wake.notify_all();
+		_writer.join();
+	}
+
+	void RegionStore::Open(const std::string& directory) {
+		Flush();
+		std::lock_guard<std::mutex> lock(_mutex);
+		CompactFiles();
+		_files.clear();
+		_regions.clear();
+		_directory = directory;
+		if (!_directory.empty()) {
+			std::error_code error;
+			std::filesystem::create_directories(_directory, error);
+			if (error) std::cerr << "Failed to create region directory " << _directory << ": " << error.message() << "\n";
+		}
+	}
+
+	bool RegionStore::Contains(glm::ivec3 coord) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_directory.empty()) return false;
+		if (_pending.count(coord)) return true;
+
+		std::shared_ptr<MappedFile> mapping = GetMapping(RegionOf(coord));
+		if (!mapping) return false;
+		RegionEntry entry;
+		std::memcpy(&entry, mapping->data + TableOffset + SlotOf(coord) * sizeof(RegionEntry), sizeof(entry));
+		return entry.offset != 0;
+	}
+
+	bool RegionStore::Load(glm::ivec3 coord, RegionChunk& chunk) {
+		std::shared_ptr<const std::vector<uint8_t>> pending;
+		std::shared_ptr<MappedFile> mapping;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_directory.empty()) return false;
+			auto it = _pending.find(coord);
+			if (it != _pending.end())
+				pending = it->second;
+			else
+				mapping = GetMapping(RegionOf(coord));
+		}
+
+		//The copy runs outside the lock, the shared pointers keep the record and the mapping alive
+		if (pending)
+			return Deserialize(pending->data(), pending->size(), coord, chunk);
+		if (!mapping) return false;
+
+		RegionEntry entry;
+		std::memcpy(&entry, mapping->data + TableOffset + SlotOf(coord) * sizeof(RegionEntry), sizeof(entry));
+		//A slot the writer is filling in right now points past the mapped size, the chunk isn't saved yet as far as this load goes
+		if (entry.offset == 0 || entry.offset + entry.size > mapping->size) return false;
+		//A damaged record reads as a chunk that was never saved, so the caller generates it again
+		return Deserialize(mapping->data + entry.offset, (size_t)entry.size, coord, chunk);
+	}
+
+	void RegionStore::Save(glm::ivec3 coord, const RegionChunk& chunk) {
+		std::shared_ptr<const std::vector<uint8_t>> record = std::make_shared<const std::vector<uint8_t>>(Serialize(coord, chunk));
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			if (_directory.empty()) return;
+			_pending[coord] = record;
+			_queue.push_back({ coord, record });
+		}
+		_wake.notify_one();
+	}
+
+	void RegionStore::Flush() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_idle.wait(lock, [this] { return _queue.empty() && !_writing; });
+	}
+
+	void RegionStore::WriterLoop() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		while (true) {
+			_wake.wait(lock, [this] { return _stop || !_queue.empty(); });
+			if (_queue.empty()) break;
+
+			PendingWrite write = std::move(_queue.front());
+			_queue.pop_front();
+			_writing = true;
+			lock.unlock();
+			WriteRecord(write);
+			lock.lock();
+
+			//Loads read the file from now on, unless the chunk was saved again in the meantime
+			_regions[RegionOf(write.coord)].stale = true;
+			auto it = _pending.find(write.coord);
+			if (it != _pending.end() && it->second == write.record)
+				_pending.erase(it);
+			_writing = false;
+			if (_queue.empty()) _idle.notify_all();
+		}
+	}
+
+	void RegionStore::WriteRecord(const PendingWrite& write) {
+		std::fstream* file = OpenRegionFile(RegionOf(write.coord));
+		if (!file) return;
+
+		//The record goes to the end, then the slot points at it. An interrupted write leaves the old record in the table.
+		file->seekp(0, std::ios::end);
+		RegionEntry entry;
+		entry.offset = (uint64_t)file->tellp();
+		entry.size = write.record->size();
+		file->write((const char*)write.record->data(), (std::streamsize)write.record->size());
+		file->flush();
+		file->seekp((std::streamoff)(TableOffset + SlotOf(write.coord) * sizeof(RegionEntry)));
+		file->write((const char*)&entry, sizeof(entry));
+		file->flush();
+		if (!*file) std::cerr << "Failed to write region file " << RegionPath(RegionOf(write.coord)) << "\n";
+	}
+
+	std::fstream* RegionStore::OpenRegionFile(glm::ivec3 region) {
+		auto it = _files.find(region);
+		if (it != _files.end()) return it->second.get();
+
+		std::string path = RegionPath(region);
+		if (!std::filesystem::exists(path)) {
+			//A new file starts with the header and an empty table
+			std::ofstream create(path, std::ios::binary);
+			RegionHeader header = { RegionMagic, RegionVersion, (uint32_t)RegionSlots, 0 };
+			std::vector<RegionEntry> table(RegionSlots, RegionEntry{ 0, 0 });
+			create.write((const char*)&header, sizeof(header));
+			create.write((const char*)table.data(), (std::streamsize)(table.size() * sizeof(RegionEntry)));
+		}
+
+		std::unique_ptr<std::fstream> file = std::make_unique<std::fstream>(path, std::ios::in | std::ios::out | std::ios::binary);
+		RegionHeader header = {};
+		file->read((char*)&header, sizeof(header));
+		if (!*file || header.magic != RegionMagic || header.version != RegionVersion || header.slotCount != (uint32_t)RegionSlots) {
+			std::cerr << "Failed to open region file " << path << "\n";
+			return nullptr;
+		}
+		return (_files[region] = std::move(file)).get();
+	}
+
+	void RegionStore::CompactFiles() {
+		for (auto& [region, file] : _files) {
+			//Every save appends, so a file is only rewritten once most of it is records the table no longer points at
+			std::vector<RegionEntry> table(RegionSlots);
+			file->clear();
+			file->seekg((std::streamoff)TableOffset);
+			file->read((char*)table.data(), (std::streamsize)(table.size() * sizeof(RegionEntry)));
+			file->seekg(0, std::ios::end);
+			uint64_t fileSize = (uint64_t)file->tellg();
+			if (!*file || fileSize < DataOffset) continue;
+
+			uint64_t liveSize = 0;
+			for (RegionEntry& entry : table) {
+				if (entry.offset < DataOffset || entry.offset + entry.size > fileSize) entry = RegionEntry{ 0, 0 };
+				liveSize += entry.size;
+			}
+			if (fileSize - DataOffset <= 2 * liveSize) continue;
+
+			//The live records are copied to a new file that then replaces the old one, a failure on the way leaves the old file
+			std::string path = RegionPath(region);
+			std::string compactPath = path + ".tmp";
+			bool written = false;
+			{
+				std::ofstream compact(compactPath, std::ios::binary | std::ios::trunc);
+				RegionHeader header = { RegionMagic, RegionVersion, (uint32_t)RegionSlots, 0 };
+				std::vector<RegionEntry> compactTable(RegionSlots, RegionEntry{ 0, 0 });
+				compact.write((const char*)&header, sizeof(header));
+				compact.write((const char*)compactTable.data(), (std::streamsize)(compactTable.size() * sizeof(RegionEntry)));
+
+				std::vector<uint8_t> record;
+				uint64_t offset = DataOffset;
+				for (int slot = 0; slot < RegionSlots; slot++) {
+					if (table[slot].offset == 0) continue;
+					record.resize((size_t)table[slot].size);
+					file->seekg((std::streamoff)table[slot].offset);
+					file->read((char*)record.data(), (std::streamsize)record.size());
+					compact.write((const char*)record.data(), (std::streamsize)record.size());
+					compactTable[slot] = RegionEntry{ offset, table[slot].size };
+					offset += table[slot].size;
+				}
+				compact.seekp((std::streamoff)TableOffset);
+				compact.write((const char*)compactTable.data(), (std::streamsize)(compactTable.size() * sizeof(RegionEntry)));
+				compact.flush();
+				written = *file && compact;
+			}
+
+			//Both the writer's handle and the mapping are closed first, Windows can't replace a file that is open
+			file.reset();
+			_regions.erase(region);
+			std::error_code error;
+			if (written) std::filesystem::rename(compactPath, path, error);
+			if (!written || error) {
+				std::cerr << "Failed to compact region file " << path << "\n";
+				std::filesystem::remove(compactPath, error);
+			}
+		}
+	}
+
+	std::shared_ptr<RegionStore::MappedFile> RegionStore::GetMapping(glm::ivec3 region) {
+		Region& entry = _regions[region];
+		if (entry.stale) {
+			entry.stale = false;
+			entry.mapping.reset();
+			std::shared_ptr<MappedFile> mapping = std::make_shared<MappedFile>();
+			if (mapping->Open(RegionPath(region)) && mapping->size >= DataOffset) {
+				RegionHeader header;
+				std::memcpy(&header, mapping->data, sizeof(header));
+				if (header.magic == RegionMagic && header.version == RegionVersion && header.slotCount == (uint32_t)RegionSlots)
+					entry.mapping = mapping;
+			}
+		}
+		return entry.mapping;
+	}
+
+	std::string RegionStore::RegionPath(glm::ivec3 region) const {
+		return _directory + "/r." + std::to_string(region.x) + "." + std::to_string(region.y) + "." + std::to_string(region.z) + ".tlr";
+	}
+
+	glm::ivec3 RegionStore::RegionOf(glm::ivec3 coord) {
+		return glm::ivec3(FloorDiv(coord.x, RegionSize), coord.y, FloorDiv(coord.z, RegionSize));
+	}
+
+	int RegionStore::SlotOf(glm::ivec3 coord) {
+		glm::ivec3 region = RegionOf(coord);
+		return (coord.x - region.x * RegionSize) + (coord.z - region.z * RegionSize) * RegionSize;
+	}
+}
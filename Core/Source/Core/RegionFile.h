@@ -0,0 +1,98 @@
+#pragma once
+#include "Core.h"
+#include "PalettedBlockIds.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Core {
+	//What a RegionStore keeps of one chunk, empty parts are left out of its record
+	struct RegionChunk {
+		ChunkOccupancy occupancy = ChunkOccupancy::Mixed;
+		PalettedBlockIds blockIDs;
+		//Stored in the Int16 encoding of a DensityStore with these iso level and range
+		std::vector<float> densities;
+		float densityIsoLevel = 0.0f;
+		float densityRange = 1.0f;
+		//The baked mesh, only its CPU data
+		PlaneMesh mesh;
+	};
+
+	//Saves chunks to region files in a directory so a revisited area loads instead of being generated again. A region file holds RegionSize x
+	//RegionSize chunks along x and z of one chunk y: a header, an offset table with a slot per chunk and the chunk records after it. A record
+	//is a fixed header with every count followed by its arrays 8 byte aligned, so loading is a copy out of the memory mapped file with nothing
+	//to parse. Saves are serialized on the calling thread and written by a background thread that only appends records and then points the
+	//table slot at the newest one. Load and Contains see a saved chunk right away, and may be called from job threads. Open and the destructor
+	//rewrite the files written to that are mostly superseded records with only the newest record of each chunk.
+	class RegionStore {
+	public:
+		static constexpr int RegionSize = 32;
+
+		RegionStore();
+		//Creates the directory if it is missing
+		explicit RegionStore(const std::string& directory);
+		//Writes everything queued before returning
+		~RegionStore();
+		RegionStore(const RegionStore&) = delete;
+		RegionStore& operator=(const RegionStore&) = delete;
+
+		//Writes everything queued for the old directory and switches to this one, an empty directory turns the store off. Call it from the
+		//thread that saves.
+		void Open(const std::string& directory);
+		bool Contains(glm::ivec3 coord);
+		//Copies the newest record of the chunk into chunk, false when it was never saved or the record is damaged
+		bool Load(glm::ivec3 coord, RegionChunk& chunk);
+		void Save(glm::ivec3 coord, const RegionChunk& chunk);
+		//Waits until the writer thread has written everything queued
+		void Flush();
+
+	private:
+		struct MappedFile;
+		struct Region {
+			std::shared_ptr<MappedFile> mapping; //null until the file exists
+			bool stale = true; //the writer changed the file since it was mapped
+		};
+		struct PendingWrite {
+			glm::ivec3 coord;
+			std::shared_ptr<const std::vector<uint8_t>> record;
+		};
+		struct CoordHash {
+			size_t operator()(const glm::ivec3& c) const {
+				return ((size_t)(uint32_t)c.x * 73856093u) ^ ((size_t)(uint32_t)c.y * 19349663u) ^ ((size_t)(uint32_t)c.z * 83492791u);
+			}
+		};
+
+		std::string _directory;
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		std::condition_variable _idle;
+		std::unordered_map<glm::ivec3, Region, CoordHash> _regions;
+		//Records queued or being written, keyed by chunk so loads find the newest one
+		std::unordered_map<glm::ivec3, std::shared_ptr<const std::vector<uint8_t>>, CoordHash> _pending;
+		std::deque<PendingWrite> _queue;
+		bool _writing = false;
+		bool _stop = false;
+		//Only the writer thread touches the open files, Open closes them while it is idle
+		std::unordered_map<glm::ivec3, std::unique_ptr<std::fstream>, CoordHash> _files;
+		std::thread _writer;
+
+		void WriterLoop();
+		void WriteRecord(const PendingWrite& write);
+		std::fstream* OpenRegionFile(glm::ivec3 region);
+		//Rewrites the open files that are mostly superseded records, call with _mutex held while the writer is idle
+		void CompactFiles();
+		//Maps the region file again if the writer changed it, call with _mutex held
+		std::shared_ptr<MappedFile> GetMapping(glm::ivec3 region);
+		std::string RegionPath(glm::ivec3 region) const;
+		static glm::ivec3 RegionOf(glm::ivec3 coord);
+		static int SlotOf(glm::ivec3 coord);
+	};
+}
@@ -0,0 +1,259 @@
+#include "SimdNoise.h"
+#include "SimdNoiseKernels.h"
+#include "CpuBackend.h"
+
+#include <cmath>
+#include <vector>
+
+#if CORE_SIMD_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace Core {
+	namespace Cpu {
+		namespace {
+			using NoiseBatchFn = void(*)(const float*, const float*, const float*, float*, int);
+			using ValueNoiseRowFn = void(*)(float*, const float*, const float*, const float*, const float*, const float*, float, float, int);
+
+			void SimplexNoiseScalar(const float* x, const float* y, const float* z, float* out, int count) {
+				for (int i = 0; i < count; i++)
+					out[i] = SimplexNoise(glm::vec3(x[i], y[i], z[i]));
+			}
+
+			void ValueNoiseRowScalar(float* n, const float* a, const float* b, const float* c, const float* d, const float* wx, float wy, float amp, int count) {
+				for (int i = 0; i < count; i++)
+					n[i] += amp * glm::mix(glm::mix(a[i], b[i], wx[i]), glm::mix(c[i], d[i], wx[i]), wy);
+			}
+
+#if CORE_SIMD_X86
+			void Cpuid(int leaf, int subLeaf, unsigned int regs[4]) {
+#if defined(_MSC_VER)
+				int r[4];
+				__cpuidex(r, leaf, subLeaf);
+				for (int i = 0; i < 4; i++)
+					regs[i] = (unsigned int)r[i];
+#else
+				__cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+			}
+
+			//Which register state the OS saves on context switches (XCR0)
+			unsigned long long ReadXcr0() {
+#if defined(_MSC_VER)
+				return _xgetbv(0);
+#else
+				unsigned int lo, hi;
+				__asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+				return ((unsigned long long)hi << 32) | lo;
+#endif
+			}
+#endif
+
+			SimdLevel DetectSimdLevel() {
+#if CORE_SIMD_X86
+				unsigned int regs[4];
+				Cpuid(0, 0, regs);
+				unsigned int maxLeaf = regs[0];
+
+				Cpuid(1, 0, regs);
+				bool sse41 = (regs[2] & (1u << 19)) != 0;
+				bool osxsave = (regs[2] & (1u << 27)) != 0;
+				bool avx = (regs[2] & (1u << 28)) != 0;
+				if (!sse41)
+					return SimdLevel::Scalar;
+				if (!osxsave || !avx || maxLeaf < 7)
+					return SimdLevel::SSE4;
+
+				unsigned long long xcr0 = ReadXcr0();
+				if ((xcr0 & 0x6) != 0x6) //XMM and YMM state
+					return SimdLevel::SSE4;
+
+				Cpuid(7, 0, regs);
+				bool avx2 = (regs[1] & (1u << 5)) != 0;
+				bool avx512f = (regs[1] & (1u << 16)) != 0;
+				if (avx512f && (xcr0 & 0xE6) == 0xE6) //plus opmask and ZMM state
+					return SimdLevel::AVX512;
+				if (avx2)
+					return SimdLevel::AVX2;
+				return SimdLevel::SSE4;
+#else
+				return SimdLevel::Scalar;
+#endif
+			}
+
+			NoiseBatchFn KernelFor(SimdLevel level) {
+#if CORE_SIMD_X86
+				switch (level) {
+				case SimdLevel::AVX512: return Simd::SimplexNoiseAVX512;
+				case SimdLevel::AVX2: return Simd::SimplexNoiseAVX2;
+				case SimdLevel::SSE4: return Simd::SimplexNoiseSSE4;
+				default: break;
+				}
+#endif
+				return SimplexNoiseScalar;
+			}
+
+			ValueNoiseRowFn ValueNoiseKernelFor(SimdLevel level) {
+#if CORE_SIMD_X86
+				switch (level) {
+				case SimdLevel::AVX512: return Simd::ValueNoiseRowAVX512;
+				case SimdLevel::AVX2: return Simd::ValueNoiseRowAVX2;
+				case SimdLevel::SSE4: return Simd::ValueNoiseRowSSE4;
+				default: break;
+				}
+#endif
+				return ValueNoiseRowScalar;
+			}
+
+			const SimdLevel _detectedLevel = DetectSimdLevel();
+			SimdLevel _simdLevel = _detectedLevel;
+			NoiseBatchFn _simplexNoiseBatch = KernelFor(_detectedLevel);
+			ValueNoiseRowFn _valueNoiseRow = ValueNoiseKernelFor(_detectedLevel);
+
+			//Per octave state of PNoiseGrid. The x lattice cell and cosine weight of every column never change between rows, the lattice hashes
+			//only change when a row crosses into the next cell on y.
+			struct ValueNoiseOctave {
+				float unit = 0.0f;
+				float amp = 0.0f;
+				std::vector<float> wx; //cosine weight per column
+				std::vector<int> slot; //lattice cell of each column, as an index into cellX
+				std::vector<float> cellX; //distinct x lattice coordinates of the grid
+				std::vector<float> low, high; //hashes at (cellX, cellX + 1) for lattice rows y and y + 1, two per slot
+				std::vector<float> a, b, c, d; //corner hashes expanded per column
+				float cellY = 0.0f;
+				bool cached = false;
+			};
+
+			void HashLatticeRow(std::vector<float>& hashes, const std::vector<float>& cellX, float y) {
+				for (size_t s = 0; s < cellX.size(); s++) {
+					hashes[s * 2 + 0] = Rand(glm::vec2(cellX[s] + 0.0f, y));
+					hashes[s * 2 + 1] = Rand(glm::vec2(cellX[s] + 1.0f, y));
+				}
+			}
+
+			void UpdateLatticeCache(ValueNoiseOctave& octave, float cellY) {
+				if (octave.cached && cellY == octave.cellY)
+					return;
+				if (octave.cached && cellY == octave.cellY + 1.0f) {
+					//The old top row of the cell is the new bottom row
+					std::swap(octave.low, octave.high);
+					HashLatticeRow(octave.high, octave.cellX, cellY + 1.0f);
+				}
+				else {
+					HashLatticeRow(octave.low, octave.cellX, cellY + 0.0f);
+					HashLatticeRow(octave.high, octave.cellX, cellY + 1.0f);
+				}
+				octave.cellY = cellY;
+				octave.cached = true;
+
+				for (size_t x = 0; x < octave.slot.size(); x++) {
+					int s = octave.slot[x];
+					octave.a[x] = octave.low[s * 2 + 0];
+					octave.b[x] = octave.low[s * 2 + 1];
+					octave.c[x] = octave.high[s * 2 + 0];
+					octave.d[x] = octave.high[s * 2 + 1];
+				}
+			}
+		}
+
+		SimdLevel GetSimdLevel() {
+			return _simdLevel;
+		}
+
+		void SetSimdLevel(SimdLevel level) {
+			if ((int)level > (int)_detectedLevel)
+				level = _detectedLevel;
+			_simdLevel = level;
+			_simplexNoiseBatch = KernelFor(level);
+			_valueNoiseRow = ValueNoiseKernelFor(level);
+		}
+
+		const char* GetSimdLevelName(SimdLevel level) {
+			switch (level) {
+			case SimdLevel::SSE4: return "SSE4";
+			case SimdLevel::AVX2: return "AVX2";
+			case SimdLevel::AVX512: return "AVX512";
+			default: return "Scalar";
+			}
+		}
+
+		void SimplexNoiseBatch(const float* x, const float* y, const float* z, float* out, int count) {
+			_simplexNoiseBatch(x, y, z, out, count);
+		}
+
+		void SimplexNoiseRow(float* out, int count, glm::ivec3 start, glm::vec3 offset, float frequency) {
+			//Coordinates are built in small blocks so they stay in L1 next to the output
+			const int blockSize = 256;
+			float xs[blockSize], ys[blockSize], zs[blockSize];
+			float y = (float(start.y) + offset.y) * frequency;
+			float z = (float(start.z) + offset.z) * frequency;
+			for (int i = 0; i < blockSize; i++) {
+				ys[i] = y;
+				zs[i] = z;
+			}
+			for (int begin = 0; begin < count; begin += blockSize) {
+				int n = count - begin < blockSize ? count - begin : blockSize;
+				for (int i = 0; i < n; i++)
+					xs[i] = (float(start.x + begin + i) + offset.x) * frequency;
+				_simplexNoiseBatch(xs, ys, zs, out + begin, n);
+			}
+		}
+
+		void PNoiseGrid(float* out, const float* xs, int columns, const float* zs, int rows, float amplitude, float frequency, int octaves, float persistance, float lacunarity) {
+			const float PI = 3.1415f;
+			if (columns <= 0 || rows <= 0)
+				return;
+
+			std::vector<ValueNoiseOctave> layers(octaves > 0 ? octaves : 0);
+			float f = frequency;
+			float amp = 1.0f;
+			float normK = 0.0f;
+			for (ValueNoiseOctave& octave : layers) {
+				octave.unit = 1.0f / f;
+				octave.amp = amp;
+				octave.wx.resize(columns);
+				octave.slot.resize(columns);
+				for (int x = 0; x < columns; x++) {
+					float px = xs[x] / octave.unit;
+					float cell = std::floor(px);
+					octave.wx[x] = 0.5f * (1.0f - std::cos(PI * glm::fract(px)));
+					if (octave.cellX.empty() || octave.cellX.back() != cell)
+						octave.cellX.push_back(cell);
+					octave.slot[x] = int(octave.cellX.size()) - 1;
+				}
+				octave.low.resize(octave.cellX.size() * 2);
+				octave.high.resize(octave.cellX.size() * 2);
+				octave.a.resize(columns);
+				octave.b.resize(columns);
+				octave.c.resize(columns);
+				octave.d.resize(columns);
+
+				f *= lacunarity;
+				normK += amp / amplitude;
+				amp *= persistance;
+			}
+
+			for (int z = 0; z < rows; z++) {
+				float* n = out + size_t(z) * columns;
+				for (int x = 0; x < columns; x++)
+					n[x] = 0.0f;
+
+				for (ValueNoiseOctave& octave : layers) {
+					float pz = zs[z] / octave.unit;
+					UpdateLatticeCache(octave, std::floor(pz));
+					float wy = 0.5f * (1.0f - std::cos(PI * glm::fract(pz)));
+					_valueNoiseRow(n, octave.a.data(), octave.b.data(), octave.c.data(), octave.d.data(), octave.wx.data(), wy, octave.amp, columns);
+				}
+
+				for (int x = 0; x < columns; x++) {
+					float nf = n[x] / normK;
+					n[x] = nf * nf * nf * nf;
+				}
+			}
+		}
+	}
+}
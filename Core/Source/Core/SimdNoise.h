@@ -0,0 +1,29 @@
+#pragma once
+#include "Core.h"
+
+namespace Core {
+	namespace Cpu {
+		//Instruction sets the batched noise kernels are compiled for. The best one the CPU and OS support is picked on first use.
+		enum class SimdLevel {
+			Scalar,
+			SSE4,
+			AVX2,
+			AVX512
+		};
+
+		SimdLevel GetSimdLevel();
+		//Forces a lower level, e.g. to compare kernels. Levels above what the CPU supports are clamped.
+		void SetSimdLevel(SimdLevel level);
+		const char* GetSimdLevelName(SimdLevel level);
+
+		//3D simplex noise (same formulation as snoise(vec3) in the shaders) for count points given as separate x, y and z arrays.
+		void SimplexNoiseBatch(const float* x, const float* y, const float* z, float* out, int count);
+		//One row of Create3DNoise.comp: out[i] = snoise((vec3(start.x + i, start.y, start.z) + offset) * frequency)
+		void SimplexNoiseRow(float* out, int count, glm::ivec3 start, glm::vec3 offset, float frequency);
+
+		//pNoise from HeightMapVertexDisplacement.comp over a grid: out[z * columns + x] = PNoise(vec2(xs[x], zs[z]), ...).
+		//Octaves are evaluated one row at a time with lanes across x, and each octave's lattice hashes are only recomputed when the row
+		//moves into the next lattice cell. Matches Cpu::PNoise bit for bit.
+		void PNoiseGrid(float* out, const float* xs, int columns, const float* zs, int rows, float amplitude, float frequency, int octaves, float persistance, float lacunarity);
+	}
+}
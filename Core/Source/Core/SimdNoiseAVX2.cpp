@@ -0,0 +1,42 @@
+#include "SimdNoiseKernels.h"
+
+//AVX2 build of the batched simplex and value noise. Only this file is compiled with AVX2 enabled and it is only called when the CPU supports it.
+#if CORE_SIMD_X86
+#include <immintrin.h>
+
+namespace Core {
+	namespace Cpu {
+		namespace Simd {
+			namespace {
+				struct Float { __m256 v; };
+				constexpr int Lanes = 8;
+
+				inline Float operator+(Float a, Float b) { return { _mm256_add_ps(a.v, b.v) }; }
+				inline Float operator-(Float a, Float b) { return { _mm256_sub_ps(a.v, b.v) }; }
+				inline Float operator*(Float a, Float b) { return { _mm256_mul_ps(a.v, b.v) }; }
+				inline Float operator/(Float a, Float b) { return { _mm256_div_ps(a.v, b.v) }; }
+				inline Float Set(float s) { return { _mm256_set1_ps(s) }; }
+				inline Float Load(const float* p) { return { _mm256_loadu_ps(p) }; }
+				inline void Store(float* p, Float a) { _mm256_storeu_ps(p, a.v); }
+				inline Float Floor(Float a) { return { _mm256_floor_ps(a.v) }; }
+				inline Float Min(Float a, Float b) { return { _mm256_min_ps(a.v, b.v) }; }
+				inline Float Max(Float a, Float b) { return { _mm256_max_ps(a.v, b.v) }; }
+				inline Float Abs(Float a) { return { _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+				inline Float Neg(Float a) { return { _mm256_xor_ps(_mm256_set1_ps(-0.0f), a.v) }; }
+				//glm::step: x < edge ? 0 : 1
+				inline Float Step(Float edge, Float x) { return { _mm256_andnot_ps(_mm256_cmp_ps(x.v, edge.v, _CMP_LT_OQ), _mm256_set1_ps(1.0f)) }; }
+
+#include "SimdNoiseKernel.inl"
+			}
+
+			void SimplexNoiseAVX2(const float* x, const float* y, const float* z, float* out, int count) {
+				SimplexNoiseLanes(x, y, z, out, count);
+			}
+
+			void ValueNoiseRowAVX2(float* n, const float* a, const float* b, const float* c, const float* d, const float* wx, float wy, float amp, int count) {
+				ValueNoiseRowLanes(n, a, b, c, d, wx, wy, amp, count);
+			}
+		}
+	}
+}
+#endif
@@ -0,0 +1,42 @@
+#include "SimdNoiseKernels.h"
+
+//AVX-512F build of the batched simplex and value noise. Only this file is compiled with AVX-512F enabled and it is only called when the CPU supports it.
+#if CORE_SIMD_X86
+#include <immintrin.h>
+
+namespace Core {
+	namespace Cpu {
+		namespace Simd {
+			namespace {
+				struct Float { __m512 v; };
+				constexpr int Lanes = 16;
+
+				inline Float operator+(Float a, Float b) { return { _mm512_add_ps(a.v, b.v) }; }
+				inline Float operator-(Float a, Float b) { return { _mm512_sub_ps(a.v, b.v) }; }
+				inline Float operator*(Float a, Float b) { return { _mm512_mul_ps(a.v, b.v) }; }
+				inline Float operator/(Float a, Float b) { return { _mm512_div_ps(a.v, b.v) }; }
+				inline Float Set(float s) { return { _mm512_set1_ps(s) }; }
+				inline Float Load(const float* p) { return { _mm512_loadu_ps(p) }; }
+				inline void Store(float* p, Float a) { _mm512_storeu_ps(p, a.v); }
+				inline Float Floor(Float a) { return { _mm512_roundscale_ps(a.v, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC) }; }
+				inline Float Min(Float a, Float b) { return { _mm512_min_ps(a.v, b.v) }; }
+				inline Float Max(Float a, Float b) { return { _mm512_max_ps(a.v, b.v) }; }
+				inline Float Abs(Float a) { return { _mm512_abs_ps(a.v) }; }
+				inline Float Neg(Float a) { return { _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a.v), _mm512_set1_epi32(int(0x80000000)))) }; }
+				//glm::step: x < edge ? 0 : 1
+				inline Float Step(Float edge, Float x) { return { _mm512_mask_blend_ps(_mm512_cmp_ps_mask(x.v, edge.v, _CMP_LT_OQ), _mm512_set1_ps(1.0f), _mm512_setzero_ps()) }; }
+
+#include "SimdNoiseKernel.inl"
+			}
+
+			void SimplexNoiseAVX512(const float* x, const float* y, const float* z, float* out, int count) {
+				SimplexNoiseLanes(x, y, z, out, count);
+			}
+
+			void ValueNoiseRowAVX512(float* n, const float* a, const float* b, const float* c, const float* d, const float* wx, float wy, float amp, int count) {
+				ValueNoiseRowLanes(n, a, b, c, d, wx, wy, amp, count);
+			}
+		}
+	}
+}
+#endif
@@ -0,0 +1,129 @@
+//Vectorized 3D simplex noise and value noise, one sample per lane. This file is included inside an anonymous namespace by SimdNoiseSSE4.cpp, SimdNoiseAVX2.cpp
+//and SimdNoiseAVX512.cpp after they define Float, Lanes and the lane operations for their instruction set.
+//The operations are done in the same order as Cpu::SimplexNoise(glm::vec3) and Cpu::PNoise, so every lane matches the scalar result.
+
+inline Float Mod289(Float x) {
+	return x - Set(289.0f) * Floor(x / Set(289.0f));
+}
+
+inline Float Permute(Float x) {
+	return Mod289((x * Set(34.0f) + Set(1.0f)) * x);
+}
+
+//Gradient lookup and falloff for one simplex corner, returns m^4 * dot(gradient, offset)
+inline Float Corner(Float p, Float dx, Float dy, Float dz) {
+	const float n_ = 1.0f / 7.0f;
+	const float nsx = n_ * 2.0f - 0.0f;
+	const float nsy = n_ * 0.5f - 1.0f;
+	const float nsz = n_ * 1.0f - 0.0f;
+
+	Float j = p - Set(49.0f) * Floor(p * Set(nsz) * Set(nsz));
+	Float x_ = Floor(j * Set(nsz));
+	Float y_ = Floor(j - Set(7.0f) * x_);
+
+	Float x = x_ * Set(nsx) + Set(nsy);
+	Float y = y_ * Set(nsx) + Set(nsy);
+	Float h = Set(1.0f) - Abs(x) - Abs(y);
+
+	Float sh = Neg(Step(h, Set(0.0f)));
+	Float gx = x + (Floor(x) * Set(2.0f) + Set(1.0f)) * sh;
+	Float gy = y + (Floor(y) * Set(2.0f) + Set(1.0f)) * sh;
+	Float gz = h;
+
+	Float norm = Set(1.79284291400159f) - Set(0.85373472095314f) * (gx * gx + gy * gy + gz * gz);
+	gx = gx * norm;
+	gy = gy * norm;
+	gz = gz * norm;
+
+	Float m = Max(Set(0.6f) - (dx * dx + dy * dy + dz * dz), Set(0.0f));
+	m = m * m;
+	return m * m * (gx * dx + gy * dy + gz * dz);
+}
+
+inline Float SimplexNoise(Float vx, Float vy, Float vz) {
+	const float Cx = 1.0f / 6.0f;
+	const float Cy = 1.0f / 3.0f;
+	Float zero = Set(0.0f);
+	Float one = Set(1.0f);
+
+	// First corner
+	Float s = vx * Set(Cy) + vy * Set(Cy) + vz * Set(Cy);
+	Float ix = Floor(vx + s);
+	Float iy = Floor(vy + s);
+	Float iz = Floor(vz + s);
+	Float t = ix * Set(Cx) + iy * Set(Cx) + iz * Set(Cx);
+	Float x0x = vx - ix + t;
+	Float x0y = vy - iy + t;
+	Float x0z = vz - iz + t;
+
+	// Other corners
+	Float gx = Step(x0y, x0x);
+	Float gy = Step(x0z, x0y);
+	Float gz = Step(x0x, x0z);
+	Float lx = one - gx;
+	Float ly = one - gy;
+	Float lz = one - gz;
+	Float i1x = Min(gx, lz), i1y = Min(gy, lx), i1z = Min(gz, ly);
+	Float i2x = Max(gx, lz), i2y = Max(gy, lx), i2z = Max(gz, ly);
+
+	Float x1x = x0x - i1x + Set(1.0f * Cx), x1y = x0y - i1y + Set(1.0f * Cx), x1z = x0z - i1z + Set(1.0f * Cx);
+	Float x2x = x0x - i2x + Set(2.0f * Cx), x2y = x0y - i2y + Set(2.0f * Cx), x2z = x0z - i2z + Set(2.0f * Cx);
+	Float x3x = x0x - one + Set(3.0f * Cx), x3y = x0y - one + Set(3.0f * Cx), x3z = x0z - one + Set(3.0f * Cx);
+
+	// Permutations
+	ix = Mod289(ix);
+	iy = Mod289(iy);
+	iz = Mod289(iz);
+	Float p0 = Permute(Permute(Permute(iz + zero) + iy + zero) + ix + zero);
+	Float p1 = Permute(Permute(Permute(iz + i1z) + iy + i1y) + ix + i1x);
+	Float p2 = Permute(Permute(Permute(iz + i2z) + iy + i2y) + ix + i2x);
+	Float p3 = Permute(Permute(Permute(iz + one) + iy + one) + ix + one);
+
+	// Mix final noise value
+	Float t0 = Corner(p0, x0x, x0y, x0z);
+	Float t1 = Corner(p1, x1x, x1y, x1z);
+	Float t2 = Corner(p2, x2x, x2y, x2z);
+	Float t3 = Corner(p3, x3x, x3y, x3z);
+	return Set(42.0f) * ((t0 + t1) + (t2 + t3));
+}
+
+inline void SimplexNoiseLanes(const float* x, const float* y, const float* z, float* out, int count) {
+	int i = 0;
+	for (; i + Lanes <= count; i += Lanes)
+		Store(out + i, SimplexNoise(Load(x + i), Load(y + i), Load(z + i)));
+
+	//Remainder goes through one padded vector
+	if (i < count) {
+		float tx[Lanes] = {}, ty[Lanes] = {}, tz[Lanes] = {}, tOut[Lanes];
+		int rest = count - i;
+		for (int k = 0; k < rest; k++) {
+			tx[k] = x[i + k];
+			ty[k] = y[i + k];
+			tz[k] = z[i + k];
+		}
+		Store(tOut, SimplexNoise(Load(tx), Load(ty), Load(tz)));
+		for (int k = 0; k < rest; k++)
+			out[i + k] = tOut[k];
+	}
+}
+
+//One octave of value noise added to a row: n += amp * mix(mix(a, b, wx), mix(c, d, wx), wy), with glm::mix written out as x * (1 - t) + y * t
+inline void ValueNoiseRowLanes(float* n, const float* a, const float* b, const float* c, const float* d, const float* wx, float wy, float amp, int count) {
+	Float one = Set(1.0f);
+	Float ty = Set(wy);
+	Float sy = one - ty;
+	Float vAmp = Set(amp);
+	int i = 0;
+	for (; i + Lanes <= count; i += Lanes) {
+		Float tx = Load(wx + i);
+		Float sx = one - tx;
+		Float x1 = Load(a + i) * sx + Load(b + i) * tx;
+		Float x2 = Load(c + i) * sx + Load(d + i) * tx;
+		Store(n + i, Load(n + i) + vAmp * (x1 * sy + x2 * ty));
+	}
+	for (; i < count; i++) {
+		float x1 = a[i] * (1.0f - wx[i]) + b[i] * wx[i];
+		float x2 = c[i] * (1.0f - wx[i]) + d[i] * wx[i];
+		n[i] = n[i] + amp * (x1 * (1.0f - wy) + x2 * wy);
+	}
+}
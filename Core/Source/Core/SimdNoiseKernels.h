@@ -0,0 +1,23 @@
+#pragma once
+
+//Entry points of the per instruction set noise translation units. These files are compiled with their own target flags (see Build-Core.lua),
+//so this header must stay free of anything that could emit inline code into them.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CORE_SIMD_X86 1
+#else
+#define CORE_SIMD_X86 0
+#endif
+
+namespace Core {
+	namespace Cpu {
+		namespace Simd {
+			void SimplexNoiseSSE4(const float* x, const float* y, const float* z, float* out, int count);
+			void SimplexNoiseAVX2(const float* x, const float* y, const float* z, float* out, int count);
+			void SimplexNoiseAVX512(const float* x, const float* y, const float* z, float* out, int count);
+
+			void ValueNoiseRowSSE4(float* n, const float* a, const float* b, const float* c, const float* d, const float* wx, float wy, float amp, int count);
+			void ValueNoiseRowAVX2(float* n, const float* a, const float* b, const float* c, const float* d, const float* wx, float wy, float amp, int count);
+			void ValueNoiseRowAVX512(float* n, const float* a, const float* b, const float* c, const float* d, const float* wx, float wy, float amp, int count);
+		}
+	}
+}
@@ -0,0 +1,56 @@
+project "CoreBench"
+   kind "ConsoleApp"
+   language "C++"
+   cppdialect "C++20"
+   targetdir "Binaries/%{cfg.buildcfg}"
+   staticruntime "off"
+   systemversion "latest"
+
+   files { "Source/**.h", "Source/**.cpp", "Include/**.h" }
+
+   includedirs
+   {
+      "Include",
+       "../Vendor/glm",
+       "../Vendor/glm/gtc",
+	  -- Include Core
+	  "../Core/Source",
+      "../Vendor/glfw/include",
+      "../Vendor/Glad/include",
+   }
+
+   links
+   {
+      "Core",
+      "GLFW",
+      "Glad",
+   }
+
+   targetdir ("../Binaries/" .. OutputDir .. "/%{prj.name}")
+   objdir ("../Binaries/Intermediates/" .. OutputDir .. "/%{prj.name}")
+
+   filter "system:windows"
+       systemversion "latest"
+       defines { "WINDOWS" }
+       links { "opengl32.lib" }
+
+   -- The CPU backend needs no GL, so the benchmark also builds and runs on headless Linux machines
+   filter "system:not windows"
+       links { "dl", "pthread", "m" }
+
+   filter "configurations:Debug"
+       defines { "DEBUG" }
+       runtime "Debug"
+       symbols "On"
+
+   filter "configurations:Release"
+       defines { "RELEASE" }
+       runtime "Release"
+       optimize "On"
+       symbols "On"
+
+   filter "configurations:Dist"
+       defines { "DIST" }
+       runtime "Release"
+       optimize "On"
+       symbols "Off"
@@ -0,0 +1,54 @@
+#pragma once
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Summary of the timed runs of one stage with one parameter set, in milliseconds
+struct BenchResult {
+	std::string stage;
+	std::string params;
+	int samples = 0;
+	double median = 0.0;
+	double p10 = 0.0;
+	double p90 = 0.0;
+	double p99 = 0.0;
+	double min = 0.0;
+	double max = 0.0;
+	double mean = 0.0;
+};
+
+struct BenchSettings {
+	int warmup = 3;
+	int iterations = 25;
+	// Only stages whose name contains it run, empty runs everything
+	std::string filter;
+	// When set, Finish also writes the results there as JSON
+	std::string jsonPath;
+	bool gpu = false;
+};
+
+// Times each stage on its own. setup runs before every iteration and is not timed, so a stage that consumes its input (painting block IDs
+// in place, polling a readback) gets a fresh one each time. The GPU stages finish the GL queue inside the timed part.
+class Bench {
+public:
+	explicit Bench(const BenchSettings& settings) : _settings(settings) {}
+
+	bool Wants(const std::string& stage) const;
+	void Run(const std::string& stage, const std::string& params, const std::function<void()>& setup, const std::function<void()>& work);
+	void Run(const std::string& stage, const std::string& params, const std::function<void()>& work) { Run(stage, params, nullptr, work); }
+
+	// Prints the table and writes the JSON file, false when it couldn't be written
+	bool Finish() const;
+
+	const std::vector<BenchResult>& GetResults() const { return _results; }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	BenchSettings _settings;
+	std::vector<BenchResult> _results;
+
+	static double Percentile(const std::vector<double>& sorted, double p);
+	bool WriteJson(const std::string& path) const;
+};
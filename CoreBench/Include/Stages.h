@@ -0,0 +1,12 @@
+#pragma once
+#include "Bench.h"
+
+// Each runs the stages of one generator through the public Core API, on whatever backend is set, across a few chunk sizes and frequencies.
+// Stages Core only exposes for batches on the GPU (marching cubes culling, counting and meshing) are timed on the CPU backend, and the
+// batched GPU pipeline and its readback are timed when the GPU backend is set.
+// False when a stage read back an empty mesh
+bool RunHeightMapStages(Bench& bench);
+void RunVoxelCubesStages(Bench& bench);
+void RunMarchingCubesStages(Bench& bench);
+// Saves and loads a voxel cubes chunk through a RegionStore in a temporary directory
+void RunRegionStages(Bench& bench);
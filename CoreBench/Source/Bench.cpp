@@ -0,0 +1,87 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+bool Bench::Wants(const std::string& stage) const {
+	return _settings.filter.empty() || stage.find(_settings.filter) != std::string::npos;
+}
+
+void Bench::Run(const std::string& stage, const std::string& params, const std::function<void()>& setup, const std::function<void()>& work) {
+	if (!Wants(stage)) return;
+
+	std::vector<double> times;
+	times.reserve(_settings.iterations);
+	for (int i = 0; i < _settings.warmup + _settings.iterations; i++) {
+		if (setup) setup();
+		Clock::time_point start = Clock::now();
+		work();
+		double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		if (i >= _settings.warmup) times.push_back(ms);
+	}
+	std::sort(times.begin(), times.end());
+
+	BenchResult result;
+	result.stage = stage;
+	result.params = params;
+	result.samples = (int)times.size();
+	if (!times.empty()) {
+		result.median = Percentile(times, 0.5);
+		result.p10 = Percentile(times, 0.1);
+		result.p90 = Percentile(times, 0.9);
+		result.p99 = Percentile(times, 0.99);
+		result.min = times.front();
+		result.max = times.back();
+		result.mean = std::accumulate(times.begin(), times.end(), 0.0) / times.size();
+	}
+	_results.push_back(result);
+
+	std::cout << std::left << std::setw(22) << stage << std::setw(26) << params << std::right << std::fixed << std::setprecision(3)
+		<< " median " << std::setw(10) << result.median << " ms  p10 " << std::setw(10) << result.p10 << "  p90 " << std::setw(10) << result.p90
+		<< "  p99 " << std::setw(10) << result.p99 << std::endl;
+}
+
+bool Bench::Finish() const {
+	std::cout << _results.size() << " results, " << _settings.iterations << " iterations after " << _settings.warmup << " warmup runs each" << std::endl;
+	if (_settings.jsonPath.empty()) return true;
+	if (!WriteJson(_settings.jsonPath)) {
+		std::cout << "Could not write " << _settings.jsonPath << std::endl;
+		return false;
+	}
+	std::cout << "Wrote " << _settings.jsonPath << std::endl;
+	return true;
+}
+
+double Bench::Percentile(const std::vector<double>& sorted, double p) {
+	// Linear between the closest ranks
+	double rank = p * (sorted.size() - 1);
+	size_t low = (size_t)rank;
+	size_t high = std::min(low + 1, sorted.size() - 1);
+	return sorted[low] + (sorted[high] - sorted[low]) * (rank - low);
+}
+
+bool Bench::WriteJson(const std::string& path) const {
+	std::ofstream file(path);
+	if (!file) return false;
+
+	// Stage and parameter names are plain identifiers, numbers and 'x', so nothing needs escaping
+	file << std::setprecision(6);
+	file << "{\n";
+	file << "  \"backend\": \"" << (_settings.gpu ? "gpu" : "cpu") << "\",\n";
+	file << "  \"warmup\": " << _settings.warmup << ",\n";
+	file << "  \"iterations\": " << _settings.iterations << ",\n";
+	file << "  \"unit\": \"ms\",\n";
+	file << "  \"results\": [\n";
+	for (size_t i = 0; i < _results.size(); i++) {
+		const BenchResult& r = _results[i];
+		file << "    {\"stage\": \"" << r.stage << "\", \"params\": \"" << r.params << "\", \"samples\": " << r.samples
+			<< ", \"median\": " << r.median << ", \"p10\": " << r.p10 << ", \"p90\": " << r.p90 << ", \"p99\": " << r.p99
+			<< ", \"min\": " << r.min << ", \"max\": " << r.max << ", \"mean\": " << r.mean << "}" << (i + 1 < _results.size() ? "," : "") << "\n";
+	}
+	file << "  ]\n";
+	file << "}\n";
+	return (bool)file;
+}
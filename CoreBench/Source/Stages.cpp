@@ -0,0 +1,240 @@
+#include "Stages.h"
+
+#include "Core/Core.h"
+#include "Core/CpuBackend.h"
+#include "Core/PalettedBlockIds.h"
+#include "Core/RegionFile.h"
+
+#include <filesystem>
+#include <iostream>
+#include <sstream>
+
+namespace {
+	bool OnGpu() {
+		return Core::GetBackend() == Core::Backend::GPU;
+	}
+
+	// The GPU stages map their results back and already wait, this only makes sure nothing queued leaks into the next sample
+	void Finish() {
+		if (OnGpu()) glFinish();
+	}
+
+	std::string Params(glm::ivec3 size, float frequency) {
+		std::ostringstream params;
+		params << size.x << "x" << size.y << "x" << size.z << " f=" << frequency;
+		return params.str();
+	}
+
+	// An empty readback means a stage wrote nothing, so the timings around it would be meaningless
+	bool CheckPlaneMesh(const Core::PlaneMesh& mesh, const std::string& stage, const std::string& params) {
+		if (!mesh.vertices.empty() && !mesh.normals.empty() && !mesh.indices.empty()) return true;
+		std::cerr << stage << " " << params << " read back an empty mesh (" << mesh.vertices.size() << " vertices, "
+			<< mesh.normals.size() << " normals, " << mesh.indices.size() << " indices)" << std::endl;
+		return false;
+	}
+}
+
+bool RunHeightMapStages(Bench& bench) {
+	const float frequency = 1.0f;
+	for (int size : { 64, 128, 256 }) {
+		std::string params = Params(glm::ivec3(size, 1, size), frequency);
+		// Every stage gets its input from here rather than the stage before, so any of them can be filtered out
+		// The GPU stages size their buffers from the vectors, so they have to be allocated up front like the demos do
+		Core::PlaneMesh mesh;
+		mesh.vertices.resize((size + 1) * (size + 1));
+		mesh.normals.resize((size + 1) * (size + 1));
+		mesh.indices.resize(size * size * 6);
+		Core::CreateVertices(mesh, size, size, glm::ivec2(0), true);
+		Core::CreateIndices(mesh, size, size, true);
+		if (!CheckPlaneMesh(mesh, "heightmap", params)) return false;
+
+		bench.Run("heightmap.vertices", params, [&] {
+			Core::CreateVertices(mesh, size, size, glm::ivec2(0), true);
+			Finish();
+		});
+		bench.Run("heightmap.indices", params, [&] {
+			Core::CreateIndices(mesh, size, size, true);
+			Finish();
+		});
+		bench.Run("heightmap.displace", params, [&] {
+			Core::CreateVertices(mesh, size, size, glm::ivec2(0), true);
+			Finish();
+		}, [&] {
+			Core::DisplaceVertices(mesh, size, size, 0.1f, 1.0f, frequency, 5, 0.5f, 2.0f, true);
+			Finish();
+		});
+		bench.Run("heightmap.normals", params, [&] {
+			Core::InterpolatedNormals(mesh, size, size, true);
+			Finish();
+		});
+		if (!CheckPlaneMesh(mesh, "heightmap.normals", params)) return false;
+
+		// All four stages above in one dispatch and one readback
+		bench.Run("heightmap.fused", params, [&] {
+			Core::PlaneMesh fused;
+			Core::CreateHeightMapChunk(fused, size, size, glm::ivec2(0), 0.1f, 1.0f, frequency);
+			Finish();
+		});
+
+		// Always on the CPU with SIMD
+		std::vector<float> noise((size + 1) * (size + 1));
+		bench.Run("heightmap.noise", params, [&] {
+			Core::CreateHeightMapNoise(noise.data(), size, size, glm::ivec2(0), 0.1f, 1.0f, frequency);
+		});
+	}
+	return true;
+}
+
+void RunVoxelCubesStages(Bench& bench) {
+	Core::Spline spline = Core::CreateVoxelCubesSpline();
+	for (glm::ivec3 chunk : { glm::ivec3(16, 64, 16), glm::ivec3(32, 128, 32) }) {
+		for (float frequency : { 0.02f, 0.1f }) {
+			// Padded by a block on every side like the demo chunks
+			glm::ivec3 size = chunk + 2;
+			glm::vec3 offset(0.0f);
+			std::string params = Params(chunk, frequency);
+
+			Core::BlockIds raw;
+			Core::CreateFlat3DNoiseMapPipeLine(raw, spline, size.x, size.y, size.z, offset, true, frequency, true);
+			Core::BlockIds painted = raw;
+			Core::TerrainPaint(painted, size.x, size.y, size.z);
+			int quadCount = Core::VoxelCubesQuadCount(size.x, size.y, size.z, offset, painted, true);
+
+			bench.Run("voxel.spline", params, [&] {
+				Core::BlockIds blockIDs;
+				Core::CreateFlat3DNoiseMapPipeLine(blockIDs, spline, size.x, size.y, size.z, offset, true, frequency, true);
+				Finish();
+			});
+
+			bench.Run("voxel.paint", params, [&] {
+				painted = raw;
+			}, [&] {
+				Core::TerrainPaint(painted, size.x, size.y, size.z);
+				Finish();
+			});
+
+			bench.Run("voxel.count", params, [&] {
+				Core::VoxelCubesQuadCount(size.x, size.y, size.z, offset, painted, true);
+				Finish();
+			});
+			bench.Run("voxel.mesh", params, [&] {
+				Core::PlaneMesh mesh;
+				Core::VoxelCubesGeometryInit(mesh, size.x, size.y, size.z, offset, painted, quadCount, true, false);
+				Finish();
+			});
+			bench.Run("voxel.greedy", params, [&] {
+				Core::PlaneMesh mesh;
+				Core::VoxelCubesGeometryInit(mesh, size.x, size.y, size.z, offset, painted, quadCount, true, true);
+				Finish();
+			});
+
+			Core::PalettedBlockIds packed;
+			bench.Run("voxel.palette", params, [&] {
+				packed.Encode(painted);
+			});
+		}
+	}
+}
+
+void RunMarchingCubesStages(Bench& bench) {
+	const float isoLevel = 0.0f;
+	for (int chunk : { 16, 32, 64 }) {
+		for (float frequency : { 0.02f, 0.08f }) {
+			// One more sample than cells along every axis
+			int size = chunk + 1;
+			glm::vec3 offset(0.0f);
+			std::string params = Params(glm::ivec3(chunk), frequency);
+
+			bench.Run("mc.classify", params, [&] {
+				Core::ClassifyMarchingCubesChunk(size, size, size, offset, frequency, isoLevel);
+			});
+
+			bench.Run("mc.noise", params, [&] {
+				std::vector<float> densities = Core::CreateFlat3DNoiseMap(size, size, size, offset, true, 1.0f, frequency);
+				Finish();
+			});
+
+			if (!OnGpu()) {
+				std::vector<float> densities;
+				std::vector<uint32_t> activeVoxels;
+				Core::Cpu::CreateFlat3DNoiseMap(densities, size, size, size, offset, frequency);
+				Core::Cpu::PerformSurfaceCulling(densities, activeVoxels, size, size, size, isoLevel);
+
+				bench.Run("mc.cull", params, [&] {
+					std::vector<uint32_t> culled;
+					Core::Cpu::PerformSurfaceCulling(densities, culled, size, size, size, isoLevel);
+				});
+				bench.Run("mc.count", params, [&] {
+					Core::Cpu::CountMarchingCubesTriangleCount(densities, activeVoxels, size, size, isoLevel);
+				});
+				bench.Run("mc.create", params, [&] {
+					Core::CpuVoxelMesh mesh;
+					Core::Cpu::CreateMarchingCubesTriangles(mesh, densities, activeVoxels, size, size, offset, isoLevel);
+				});
+				bench.Run("mc.create.indexed", params, [&] {
+					Core::CpuVoxelMesh mesh;
+					Core::Cpu::CreateMarchingCubesIndexed(mesh, densities, activeVoxels, size, size, size, offset, isoLevel);
+				});
+				continue;
+			}
+
+			// A 2x2x2 block of chunks through the batched passes, then the wait for their readbacks
+			std::vector<glm::vec3> offsets;
+			for (int i = 0; i < 8; i++) {
+				offsets.push_back(glm::vec3(i & 1, (i >> 1) & 1, i >> 2) * (float)chunk);
+			}
+			std::vector<Core::VoxelMesh*> meshes;
+			auto deleteMeshes = [&] {
+				for (Core::VoxelMesh* mesh : meshes) delete mesh;
+				meshes.clear();
+			};
+			auto generate = [&] {
+				meshes = Core::CreateMarchingCubes3DMeshesGPU(chunk, chunk, chunk, offsets, true, 1.0f, frequency, 0.5f, 2.0f, 5, true);
+			};
+
+			bench.Run("mc.generate", params + " x8", deleteMeshes, [&] {
+				generate();
+				glFinish();
+			});
+			bench.Run("mc.readback", params + " x8", [&] {
+				deleteMeshes();
+				generate();
+				glFlush();
+			}, [&] {
+				// Air and solid chunks come back ready
+				for (Core::VoxelMesh* mesh : meshes) {
+					while (!mesh->cpuMesh.isReady) Core::PollAsyncReadback(*mesh);
+				}
+			});
+			deleteMeshes();
+		}
+	}
+}
+
+void RunRegionStages(Bench& bench) {
+	if (!bench.Wants("region.save") && !bench.Wants("region.load")) return;
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "CoreBenchRegions";
+	{
+		Core::RegionStore store(directory.string());
+		Core::Spline spline = Core::CreateVoxelCubesSpline();
+		glm::ivec3 size(34, 130, 34);
+		std::string params = Params(size - 2, 0.02f);
+
+		Core::BlockIds blockIDs;
+		Core::CreateFlat3DNoiseMapPipeLine(blockIDs, spline, size.x, size.y, size.z, glm::vec3(0.0f), true, 0.02f, true);
+		Core::TerrainPaint(blockIDs, size.x, size.y, size.z);
+		Core::RegionChunk chunk;
+		chunk.blockIDs.Encode(blockIDs);
+
+		bench.Run("region.save", params, [&] {
+			store.Save(glm::ivec3(0), chunk);
+			store.Flush();
+		});
+		bench.Run("region.load", params, [&] {
+			Core::RegionChunk loaded;
+			store.Load(glm::ivec3(0), loaded);
+		});
+	}
+	std::error_code error;
+	std::filesystem::remove_all(directory, error);
+}
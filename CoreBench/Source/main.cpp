@@ -0,0 +1,97 @@
+#include "Bench.h"
+#include "Stages.h"
+
+#include "Core/Core.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+	void PrintUsage() {
+		std::cout << "CoreBench [--gpu] [--iterations N] [--warmup N] [--filter STAGE] [--json PATH]\n"
+			<< "  Times every Core stage on the CPU backend, or on the GPU backend with --gpu.\n"
+			<< "  --filter runs only the stages whose name contains STAGE, e.g. mc. or voxel.greedy\n"
+			<< "  --json writes medians and percentiles in milliseconds for regression tracking" << std::endl;
+	}
+
+	bool ParseArguments(int argc, char** argv, BenchSettings& settings) {
+		for (int i = 1; i < argc; i++) {
+			const char* arg = argv[i];
+			bool hasValue = i + 1 < argc;
+			if (std::strcmp(arg, "--gpu") == 0) settings.gpu = true;
+			else if (std::strcmp(arg, "--iterations") == 0 && hasValue) settings.iterations = std::max(1, std::atoi(argv[++i]));
+			else if (std::strcmp(arg, "--warmup") == 0 && hasValue) settings.warmup = std::max(0, std::atoi(argv[++i]));
+			else if (std::strcmp(arg, "--filter") == 0 && hasValue) settings.filter = argv[++i];
+			else if (std::strcmp(arg, "--json") == 0 && hasValue) settings.jsonPath = argv[++i];
+			else return false;
+		}
+		return true;
+	}
+
+	// A hidden window with a GL 4.3 context, or an offscreen OSMesa one where there is no display
+	GLFWwindow* CreateHiddenContext() {
+		if (!glfwInit()) return nullptr;
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+
+		GLFWwindow* window = glfwCreateWindow(64, 64, "CoreBench", nullptr, nullptr);
+		if (!window) {
+			glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+			window = glfwCreateWindow(64, 64, "CoreBench", nullptr, nullptr);
+		}
+		if (!window) {
+			glfwTerminate();
+			return nullptr;
+		}
+
+		glfwMakeContextCurrent(window);
+		if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+			glfwDestroyWindow(window);
+			glfwTerminate();
+			return nullptr;
+		}
+		return window;
+	}
+}
+
+int main(int argc, char** argv) {
+	BenchSettings settings;
+	if (!ParseArguments(argc, argv, settings)) {
+		PrintUsage();
+		return 1;
+	}
+
+	GLFWwindow* window = nullptr;
+	if (settings.gpu) {
+		window = CreateHiddenContext();
+		if (!window) {
+			std::cout << "Could not create a GL 4.3 context, benchmarking the CPU backend instead" << std::endl;
+			settings.gpu = false;
+		}
+	}
+
+	// The CPU backend compiles no programs, so Init needs no context
+	Core::SetBackend(settings.gpu ? Core::Backend::GPU : Core::Backend::CPU);
+	Core::Init();
+
+	Bench bench(settings);
+	bool valid = RunHeightMapStages(bench);
+	if (valid) {
+		RunVoxelCubesStages(bench);
+		RunMarchingCubesStages(bench);
+		RunRegionStages(bench);
+	}
+	bool written = valid && bench.Finish();
+
+	if (window) Core::DestroyBufferArenas();
+	Core::Cleanup();
+	if (window) {
+		glfwDestroyWindow(window);
+		glfwTerminate();
+	}
+	return written ? 0 : 1;
+}
@@ -47,13 +47,9 @@ private:
 
     GLuint CreateShaderProgram(const std::string& vertexPath, const std::string& fragmentPath);
 
-    void UpdatePlaneMesh(Core::PlaneMesh& planeData, GLuint& VAO, GLuint& VBOVertex, GLuint& VBONormals, GLuint& EBO);
+    void UpdatePlaneMesh(Core::PlaneMesh& planeData);
 
-    void ProgramSetup(Core::PlaneMesh& planeData, GLuint& VAO, GLuint& VBOVertex, GLuint& VBONormals, GLuint& EBO);
-
-    void ProgramInit(Core::PlaneMesh& planeData, GLuint& VAO, GLuint& VBOVertex, GLuint& VBONormals, GLuint& EBO);
-
-    void Cleanup(GLuint& VAO, GLuint& VBOVertex, GLuint& VBONormals, GLuint& EBO, GLFWwindow* window, GLuint& shaderProgram);
+    void Cleanup(Core::PlaneMesh& planeData, GLFWwindow* window, GLuint& shaderProgram);
 
     void ResetToStartValues();
 };
\ No newline at end of file
@@ -1,4 +1,5 @@
 ﻿#include "App.h"
+#include "Core/ProfilerPanel.h"
 
 
 App::App() {
@@ -103,82 +104,18 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
 	}
 }
 
-void App::UpdatePlaneMesh(Core::PlaneMesh& planeData, GLuint& VAO, GLuint& VBOVertex, GLuint& VBONormals, GLuint& EBO) {
-	
-	planeData = std::move(Core::CreateHeightMapPlaneMeshGPU(_width,_height, glm::ivec2(0,0), _scale, _amplitude, _frequency, _octave, _persistance, _lacunarity, true));
-	std::cout << planeData.vertices.size() << " " << planeData.normals.size() << " " << planeData.indices.size() << std::endl;
-	ProgramSetup(planeData, VAO, VBOVertex, VBONormals, EBO);
-}
-
-void App::ProgramSetup(Core::PlaneMesh& planeData, GLuint& VAO, GLuint& VBOVertex, GLuint& VBONormals, GLuint& EBO) {
-	GLenum err;
-
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(1, &VBOVertex);
-	glDeleteBuffers(1, &VBONormals);
-	glDeleteBuffers(1, &EBO);
-
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBOVertex);
-	glGenBuffers(1, &VBONormals);
-	glGenBuffers(1, &EBO);
-
-	glBindVertexArray(VAO);
-	
-	//Vertex buffer setup
-	glBindBuffer(GL_ARRAY_BUFFER, VBOVertex);
-	glBufferData(GL_ARRAY_BUFFER, planeData.vertices.size() * sizeof(glm::fvec3), planeData.vertices.data(), GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::fvec3), (void*)0);
-
-	//Normal buffer setup
-	glBindBuffer(GL_ARRAY_BUFFER, VBONormals);
-	glBufferData(GL_ARRAY_BUFFER, planeData.normals.size() * sizeof(glm::fvec3), planeData.normals.data(), GL_STATIC_DRAW);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::fvec3), (void*)0);
-
-	//Index buffer setup
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, planeData.indices.size() * sizeof(int), planeData.indices.data(), GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-	
+void App::UpdatePlaneMesh(Core::PlaneMesh& planeData) {
+	// One dispatch into the mesh arena and no readback, the old ranges go back to the arena once the GPU is done drawing from them
+	Core::CreateHeightMapChunk(planeData, _width, _height, glm::ivec2(0, 0), _scale, _amplitude, _frequency, _octave, _persistance, _lacunarity, Core::MeshTarget::Gpu);
+	std::cout << planeData.indexCount << " indices" << std::endl;
 }
 
-void App::ProgramInit(Core::PlaneMesh& planeData, GLuint& VAO, GLuint& VBOVertex, GLuint& VBONormals, GLuint& EBO) {
-	glGenVertexArrays(1, &VAO);
-	glGenBuffers(1, &VBOVertex);
-	glGenBuffers(1, &VBONormals);
-	glGenBuffers(1, &EBO);
-
-
-	glBindVertexArray(VAO);
-
-	//Vertex buffer setup
-	glBindBuffer(GL_ARRAY_BUFFER, VBOVertex);
-	glBufferData(GL_ARRAY_BUFFER, planeData.vertices.size() * sizeof(glm::fvec3), planeData.vertices.data(), GL_STATIC_DRAW);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::fvec3), (void*)0);
-	//Normal buffer setup
-
-	glBindBuffer(GL_ARRAY_BUFFER, VBONormals);
-	glBufferData(GL_ARRAY_BUFFER, planeData.normals.size() * sizeof(glm::fvec3), planeData.normals.data(), GL_STATIC_DRAW);
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(glm::fvec3), (void*)0);
-	//Index buffer setup
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, planeData.indices.size() * sizeof(int), planeData.indices.data(), GL_STATIC_DRAW);
-
-
-	glBindVertexArray(0);
-}
-
-void App::Cleanup(GLuint& VAO, GLuint& VBOVertex, GLuint& VBONormals, GLuint& EBO, GLFWwindow* window, GLuint& shaderProgram) {
+void App::Cleanup(Core::PlaneMesh& planeData, GLFWwindow* window, GLuint& shaderProgram) {
 	glDeleteProgram(shaderProgram);
-	glDeleteVertexArrays(1, &VAO);
-	glDeleteBuffers(1, &VBOVertex);
-	glDeleteBuffers(1, &VBONormals);
-	glDeleteBuffers(1, &EBO);
+	Core::ReleasePlaneMesh(planeData);
+	// Deletes the compute programs the meshes were generated with, while the context still exists
+	Core::Cleanup();
+	Core::DestroyBufferArenas();
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
 	ImGui::DestroyContext();
@@ -187,6 +124,7 @@ void App::Cleanup(GLuint& VAO, GLuint& VBOVertex, GLuint& VBONormals, GLuint& EB
 }
 
 void App::Run() {
+	Core::Init();
 	int width = 1280, height = 720;
 	// Vertex data
 	//createPerspectiveMatrix(glm::radians(80.0f), width/height, 0.1f, 1000.0f, 0.5f, -0.5f, 0.5f, -0.5f);
@@ -210,11 +148,8 @@ void App::Run() {
 	const GLubyte* version = glGetString(GL_VERSION);
 	//std::cout << "OpenGL Version: " << version << std::endl;
 
-	Core::PlaneMesh planeData = Core::CreateHeightMapPlaneMeshGPU(_width, _height);
-	std::cout << planeData.vertices.size() << " " << planeData.normals.size() << " " << planeData.indices.size() << std::endl;
-
-	GLuint VAO, VBOVertex, VBONormals, EBO;
-	ProgramInit(planeData, VAO, VBOVertex, VBONormals, EBO);
+	Core::PlaneMesh planeData;
+	UpdatePlaneMesh(planeData);
 
 	GLuint shaderProgram = CreateShaderProgram("Shaders/shader.vert", "Shaders/shader.frag");
 
@@ -299,7 +234,7 @@ void App::Run() {
 		ImGui::SliderFloat("Lacunarity", &_lacunarity, 0.1f, 4.0f);
 		
 		if (ImGui::Button("Regenerate Mesh")) {
-			UpdatePlaneMesh(planeData, VAO, VBOVertex, VBONormals, EBO);
+			UpdatePlaneMesh(planeData);
 		}
 		if (ImGui::Button("Reset Settings")) {
 			ResetToStartValues();
@@ -307,6 +242,7 @@ void App::Run() {
 		ImGui::Text("WASD to move  |  Space to ascend and ctrl to descend");
 
 		ImGui::End();
+		Core::ShowProfilerPanel();
 
 		ImGui::Render();
 
@@ -317,9 +253,8 @@ void App::Run() {
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		glUseProgram(shaderProgram);
-		glBindVertexArray(VAO);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO); 
-		glDrawElements(GL_TRIANGLES, planeData.indices.size(), GL_UNSIGNED_INT, 0);
+		glBindVertexArray(planeData.vao);
+		glDrawElements(GL_TRIANGLES, planeData.indexCount, GL_UNSIGNED_INT, planeData.indexRange.Pointer());
 		
 
 		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
@@ -327,7 +262,7 @@ void App::Run() {
 		glfwSwapBuffers(window);
 	}
 
-	Cleanup(VAO, VBOVertex, VBONormals, EBO, window, shaderProgram);
+	Cleanup(planeData, window, shaderProgram);
 }
 
 
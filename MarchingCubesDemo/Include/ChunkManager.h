@@ -5,8 +5,11 @@
 #include <glm.hpp>
 #include <iostream>
 #include <algorithm>
+#include <memory>
 
 #include "Core/Core.h"
+#include "Core/ChunkJobs.h"
+#include "Core/ChunkStreamer.h"
 
 using ChunkCoord = glm::ivec3;
 
@@ -26,17 +29,11 @@ namespace std {
 class ChunkManager {
 public:
 
-	ChunkManager() {}
+	ChunkManager();
 
 	void DestroyChunks();
 
-	void Update(const glm::vec3& position);
-
-	void QueueCPUContent(const glm::vec3& coord);
-
-	void GetCPUContent(const glm::vec3& position);
-
-	void GenerateChunk(const glm::vec3& position);
+	void Update(const glm::vec3& position, const glm::mat4& viewProjection);
 
 	glm::vec3 GetChunkCoordFromPosition(const glm::vec3& position) const {
 		float xScale = 1.0f / _width;
@@ -50,7 +47,7 @@ public:
 		);
 	}
 
-	void UpdateSettings(float scale, float amplitude, float frequency, int octaves, float lacunarity, float persistance, int width, int height, int depth, int viewDistance) {
+	void UpdateSettings(float scale, float amplitude, float frequency, int octaves, float lacunarity, float persistance, int width, int height, int depth, int viewDistance, int lodDistance) {
 		_scale = scale;
 		_amplitude = amplitude;
 		_frequency = frequency;
@@ -61,7 +58,9 @@ public:
 		_height = height;
 		_depth = depth;
 		_viewDistance = viewDistance;
-
+		_lodDistance = lodDistance;
+		_densities.Configure(glm::ivec3(_width, _height, _depth), _frequency, Core::DensityFormat::Int16);
+		_streamer.Configure(StreamSettings());
 	}
 
 	std::unordered_map<ChunkCoord, Core::VoxelMesh*>& GetChunkMap() {
@@ -70,7 +69,10 @@ public:
 
 private:
 	std::unordered_map<ChunkCoord, Core::VoxelMesh*> _chunkMap;
-	std::vector<glm::vec3> _chunkCoordsToGenerateToCPU;
+	// Air and solid chunks have no surface, they keep one byte and no mesh or buffers
+	std::unordered_map<ChunkCoord, Core::ChunkOccupancy> _uniformChunks;
+	// Full resolution chunks with a mesh, the only ones holding densities in the store
+	std::unordered_set<ChunkCoord> _storeChunks;
 	float _scale = 0.1f;
 	float _amplitude = 1.0f;
 	float _frequency = 0.08f;
@@ -80,8 +82,23 @@ private:
 	int _width = 16;
 	int _height = 16;
 	int _depth = 16;
-	int _viewDistance = 5;
-	void UnloadFarChunks(const glm::vec3& playerPosition);
+	// Four times the radius the demo streamed at full resolution, the rings further out mesh coarser lattices
+	int _viewDistance = 20;
+	// Chunks at full resolution around the camera, every ring after it is twice as wide at half the resolution
+	int _lodDistance = 2;
+	int _maxLod = 3;
+	// Shares vertices between triangles and shades with the density gradient instead of flat face normals
+	bool _indexedMeshes = true;
+	// Densities of the generated chunks, neighbours share their border samples instead of each evaluating them
+	Core::DensityStore _densities{ glm::ivec3(_width, _height, _depth), _frequency, Core::DensityFormat::Int16 };
+	//Declared last so the worker threads stop before the chunk map and settings they use are destroyed
+	Core::ChunkStreamer _streamer;
+
+	Core::ChunkStreamCallbacks StreamCallbacks();
+	Core::ChunkStreamSettings StreamSettings() const;
+	Core::MarchingCubesLod ChunkLod(glm::ivec3 coord, glm::ivec3 center) const;
+	void UnloadChunk(glm::ivec3 coord);
 	void DeleteChunk(Core::VoxelMesh* mesh);
+	void ReleaseDensities(glm::ivec3 coord);
 
 };
\ No newline at end of file
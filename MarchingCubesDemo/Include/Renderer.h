@@ -44,12 +44,17 @@ public:
     const glm::vec3& GetCameraPosition() {
         return _camera.GetPosition();
     }
+
+    glm::mat4 GetViewProjection() const {
+        return _perspectiveMat * _view;
+    }
     
 private:
     int _width = 32;
     int _height = 32;
     int _depth = 32;
-    int _viewDistance = 3;
+    int _viewDistance = 20;
+    int _lodDistance = 2;
     ChunkRenderer _chunkRenderer = ChunkRenderer(_width, _height, _depth, _viewDistance);
 
     glm::mat4 _identity;
@@ -81,6 +86,8 @@ private:
     GLint _modelMLocation;
     GLint _viewLoc;
     GLint _normalMatrixLocation;
+    GLint _chunkOriginLocation;
+    GLint _chunkExtentLocation;
     GLint _playerPosition;
 
     void Init();
@@ -1,20 +1,36 @@
 #version 430 core
 
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aNormal;
+// Core::PackedMarchingCubesVertex: the position normalized across the chunk extent and an
+// octahedral normal
+layout(location = 0) in vec3 aPackedPos;
+layout(location = 1) in vec2 aPackedNormal;
 
 uniform mat4 projM;
 uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat3 normalMatrix;
+uniform vec3 uChunkOrigin;
+uniform vec3 uChunkExtent;
 
 out vec3 FragPos;
 out vec3 Normal;
 
+vec3 OctahedralDecode(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    // Unfold the lower half of the sphere
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
 
 void main()
 {
+    vec3 aPos = uChunkOrigin + aPackedPos * uChunkExtent;
+    vec3 aNormal = OctahedralDecode(aPackedNormal);
+
     FragPos = vec3(uModel*vec4(aPos, 1.0f));
     Normal = normalMatrix*aNormal;
     gl_Position =  projM * uView * uModel * vec4(aPos, 1.0);
-}
\ No newline at end of file
+}
@@ -4,7 +4,7 @@ void App::Run() {
 	Core::Init();
 	while (!glfwWindowShouldClose(_renderer.GetWindow())) {
 		glm::vec3 pos = _renderer.GetCameraPosition(); // or pass shared
-		_chunkManager.Update(pos);
+		_chunkManager.Update(pos, _renderer.GetViewProjection());
 		
 		_renderer.Render(_chunkManager);
 	}
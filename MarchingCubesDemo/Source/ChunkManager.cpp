@@ -1,121 +1,103 @@
 #include "ChunkManager.h"
 
-void ChunkManager::Update(const glm::vec3& position) {
-	GenerateChunk(position);
-	GetCPUContent(position);
-	UnloadFarChunks(position); // Keep the VRAM clean!
+ChunkManager::ChunkManager() : _streamer(StreamCallbacks()) {
+	_streamer.Configure(StreamSettings());
 }
 
-void ChunkManager::QueueCPUContent(const glm::vec3& coord) {
-	// This function can be used to queue chunks for CPU readback. 
-	_chunkCoordsToGenerateToCPU.push_back(coord);
+void ChunkManager::Update(const glm::vec3& position, const glm::mat4& viewProjection) {
+	// Missing chunks are generated closest first on the worker threads, and far chunks are unloaded to keep the VRAM clean
+	_streamer.Update(position, viewProjection);
 }
 
-void ChunkManager::GetCPUContent(const glm::vec3& position) {
-	for (auto it = _chunkCoordsToGenerateToCPU.begin(); it != _chunkCoordsToGenerateToCPU.end(); ){
-		Core::VoxelMesh* chunkData = _chunkMap[*it];
-
-		if (Core::PollAsyncReadback(*chunkData)) {
-			// 2. Erase it, and let C++ give us the iterator to the next item
-			it = _chunkCoordsToGenerateToCPU.erase(it);
-			
-		}
-		else {
-			// 3. Only move forward if we DID NOT erase anything
-			++it;
+Core::ChunkStreamCallbacks ChunkManager::StreamCallbacks() {
+	Core::ChunkStreamCallbacks callbacks;
+	callbacks.schedule = [this](Core::JobSystem& jobs, glm::ivec3 coord) -> void* {
+		// Density, surface culling and meshing run as dependent jobs
+		Core::MarchingCubesChunkJob* chunk = new Core::MarchingCubesChunkJob;
+		chunk->coord = coord;
+		Core::ScheduleMarchingCubesChunk(jobs, *chunk, _width, _height, _depth, _frequency, _indexedMeshes, &_densities, ChunkLod(coord, _streamer.GetCenter()));
+		return chunk;
+	};
+	callbacks.variant = [this](glm::ivec3 coord, glm::ivec3 center) {
+		// A chunk is meshed again when its own level or one of its neighbours' changes, the seams depend on both
+		return ChunkLod(coord, center).Key();
+	};
+	callbacks.ready = [this](glm::ivec3 coord, void* data) {
+		// The workers only fill the CPU copy of the mesh, the GL buffers have to be made here on the render thread
+		std::unique_ptr<Core::MarchingCubesChunkJob> chunk(static_cast<Core::MarchingCubesChunkJob*>(data));
+		// Chunks whose level of detail changed come back while the old mesh is still loaded
+		UnloadChunk(coord);
+		if (chunk->occupancy != Core::ChunkOccupancy::Mixed) {
+			_uniformChunks[coord] = chunk->occupancy;
+			return;
 		}
-	}
+		// 12 byte vertices quantized across the chunk, the same box the job meshed the chunk in
+		glm::vec3 size = glm::vec3(_width, _height, _depth);
+		Core::UploadPackedVoxelMesh(*chunk->mesh, glm::vec3(coord) * size, size);
+		_chunkMap[coord] = chunk->mesh;
+		if (chunk->lod.level == 0)
+			_storeChunks.insert(coord);
+	};
+	callbacks.discard = [this](glm::ivec3 coord, void* data) {
+		std::unique_ptr<Core::MarchingCubesChunkJob> chunk(static_cast<Core::MarchingCubesChunkJob*>(data));
+		// Air and solid chunks never acquired their densities, and neither did the coarser ones
+		if (chunk->occupancy != Core::ChunkOccupancy::Mixed) return;
+		DeleteChunk(chunk->mesh);
+		if (chunk->lod.level == 0)
+			ReleaseDensities(coord);
+	};
+	callbacks.unload = [this](glm::ivec3 coord) {
+		UnloadChunk(coord);
+	};
+	return callbacks;
 }
 
-void ChunkManager::GenerateChunk(const glm::vec3& position) {
-	
-	glm::vec3 playerChunk = GetChunkCoordFromPosition(position);
-	int numberOfGeneratedChunksOnThisFrame = 0;
-	for (int x = -_viewDistance; x <= _viewDistance; x++) {
-		for (int y = -_viewDistance; y <= _viewDistance; y++) {
-			for (int z = -_viewDistance; z <= _viewDistance; z++) {
-				if (numberOfGeneratedChunksOnThisFrame > 1) return;
-				//if (glm::abs(x * y * z) > _viewDistance * _viewDistance * _viewDistance / 1.5f) continue;
-				glm::vec3 coord = playerChunk + glm::vec3(x, y, z);
-				//std::cout << coord.x << " " << coord.y << " " << coord.z << "\n";
-				// Generate if not yet stored
-				if (_chunkMap.find(coord) == _chunkMap.end()) {
-					glm::vec3 offset = coord * glm::vec3(_width, _height, _depth);
-					//Try generating the mesh with and without GPU to see the difference in speed! The function call is the same but the end of
-					//the function call is GPU for the gpu implementtion. Please do keep in mind the noise map is still using compute shaders
-					//even on the cpu implementation, so that is technically a speedup that should not be granted as a possitive for the CPU part
-					//of this code. 
-					_chunkMap[coord] = std::move(Core::CreateMarchingCubes3DMeshGPU(_width, _height, _depth, offset, false, _scale, _frequency, _persistance, _lacunarity, _octave)); 
-					numberOfGeneratedChunksOnThisFrame++;
-					QueueCPUContent(coord);
-				}
-			}
-		}
-	}
+Core::ChunkStreamSettings ChunkManager::StreamSettings() const {
+	Core::ChunkStreamSettings settings;
+	settings.chunkSize = glm::vec3(_width, _height, _depth);
+	settings.viewRadius = _viewDistance;
+	// Unload slightly further out than the view distance to prevent flickering
+	settings.unloadMargin = 2;
+	return settings;
 }
 
 void ChunkManager::DestroyChunks() {
+	// Chunks still in flight were generated with the old settings, they are dropped and every loaded chunk is unloaded
+	_streamer.Reset();
 	for (auto& [coord, mesh] : _chunkMap) {
 		DeleteChunk(mesh);
 	}
 	_chunkMap.clear();
+	_uniformChunks.clear();
+	_storeChunks.clear();
+	_densities.Clear();
 }
 
-void ChunkManager::UnloadFarChunks(const glm::vec3& playerPosition) {
-	// 1. Get player's chunk coordinate (use your existing function)
-	glm::ivec3 playerChunk = GetChunkCoordFromPosition(playerPosition);
-
-	// 2. Set unload distance slightly larger than view distance to prevent flickering
-	int unloadDist = _viewDistance + 2;
-
-	for (auto it = _chunkMap.begin(); it != _chunkMap.end(); ) {
-		glm::ivec3 chunkCoord = it->first;
-
-		// 3. Calculate cubic distance on the grid
-		int distX = std::abs(chunkCoord.x - playerChunk.x);
-		int distY = std::abs(chunkCoord.y - playerChunk.y);
-		int distZ = std::abs(chunkCoord.z - playerChunk.z);
-
-		// If it falls outside our cube...
-		if (distX > unloadDist || distY > unloadDist || distZ > unloadDist) {
-
-			// 4. FIX THE GHOST QUEUE: Remove it from the pending CPU readback list!
-			auto queueIt = std::find_if(_chunkCoordsToGenerateToCPU.begin(), _chunkCoordsToGenerateToCPU.end(),
-				[&chunkCoord](const glm::vec3& v) {
-					return v.x == chunkCoord.x && v.y == chunkCoord.y && v.z == chunkCoord.z;
-				});
-
-			if (queueIt != _chunkCoordsToGenerateToCPU.end()) {
-				_chunkCoordsToGenerateToCPU.erase(queueIt);
-			}
+Core::MarchingCubesLod ChunkManager::ChunkLod(glm::ivec3 coord, glm::ivec3 center) const {
+	return Core::SelectMarchingCubesLod(coord, center, glm::ivec3(_width, _height, _depth), _lodDistance, _maxLod);
+}
 
-			// 5. Nuke everything safely
-			DeleteChunk(it->second);
-			it = _chunkMap.erase(it);
-		}
-		else {
-			++it;
-		}
+void ChunkManager::UnloadChunk(glm::ivec3 coord) {
+	if (_uniformChunks.erase(coord)) return;
+	auto it = _chunkMap.find(coord);
+	if (it != _chunkMap.end()) {
+		DeleteChunk(it->second);
+		_chunkMap.erase(it);
+		if (_storeChunks.erase(coord))
+			ReleaseDensities(coord);
 	}
 }
 
 void ChunkManager::DeleteChunk(Core::VoxelMesh* mesh) {
 	if (!mesh) return;
 
-	// Free standard GPU memory
-	if (mesh->vboVertices) glDeleteBuffers(1, &mesh->vboVertices);
-	if (mesh->vboNormals) glDeleteBuffers(1, &mesh->vboNormals);
-	if (mesh->vao) glDeleteVertexArrays(1, &mesh->vao);
-	if (mesh->indirectBuffer) glDeleteBuffers(1, &mesh->indirectBuffer);
-	if (mesh->ssboIndices) glDeleteBuffers(1, &mesh->ssboIndices);
-
-	// --- THE LEAK FIX: Free the massive Staging Buffers! ---
-	if (mesh->stagingVertices) glDeleteBuffers(1, &mesh->stagingVertices);
-	if (mesh->stagingNormals) glDeleteBuffers(1, &mesh->stagingNormals);
-	if (mesh->stagingIndirect) glDeleteBuffers(1, &mesh->stagingIndirect);
-
-	if (mesh->syncObj) glDeleteSync(mesh->syncObj);
-
-	// Delete the C++ object from RAM
+	// The destructor gives the mesh ranges back to the Core arenas and deletes the VAO and fence
 	delete mesh;
-}
\ No newline at end of file
+}
+
+void ChunkManager::ReleaseDensities(glm::ivec3 coord) {
+	// The bricks are shared with the neighbours, a brick is only dropped once no generated chunk reads it anymore
+	glm::ivec3 origin, size;
+	Core::MarchingCubesChunkBox(coord, _width, _height, _depth, origin, size);
+	_densities.Release(origin, size);
+}
@@ -7,60 +7,22 @@ void ChunkRenderer::UpdateActiveChunk(const glm::vec3& position, ChunkManager& c
 	_activeChunkSet.clear();
 	auto& chunkMap = chunkManager.GetChunkMap();
 
-	for (int x = -_viewDistance; x <= _viewDistance; x++) {
-		for (int y = -_viewDistance; y <= _viewDistance; y++) {
-			for (int z = -_viewDistance; z <= _viewDistance; z++) {
+	// Walks the loaded chunks rather than the cube around the player, with the coarse rings the view distance is too large to scan every frame
+	for (auto& [coord, mesh] : chunkMap) {
+		glm::ivec3 d = glm::ivec3(glm::vec3(coord) - playerChunk);
+		if (glm::abs(d.x) > _viewDistance || glm::abs(d.y) > _viewDistance || glm::abs(d.z) > _viewDistance) continue;
+		if (glm::abs(d.x * d.y * d.z) > _viewDistance * _viewDistance * _viewDistance / 1.5f) continue;
 
-				if (glm::abs(x * y * z) > _viewDistance * _viewDistance * _viewDistance / 1.5f) continue;
-
-				glm::vec3 coord = playerChunk + glm::vec3(x, y, z);
-
-				// If it exists in the manager, we draw it! That's it!
-				if (chunkMap.find(coord) != chunkMap.end()) {
-					_activeChunkSet.insert(coord);
-				}
-			}
-		}
+		_activeChunkSet.insert(coord);
 	}
 }
 
 void ChunkRenderer::SetupChunkRenderData(Core::VoxelMesh& mesh) {
-	
-	glGenVertexArrays(1, &mesh.vao);
-	glBindVertexArray(mesh.vao);
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vboVertices);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, (void*)0); // location 0
-	glEnableVertexAttribArray(0);
-
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vboNormals);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(float) * 3, (void*)0); // location 1
-	glEnableVertexAttribArray(1);
-
-	glBindVertexArray(0);
-
-	mesh.gpuLoaded = true;
+	// The VAO, vertex ranges and indirect command all come from the Core mesh arena
+	Core::UploadVoxelMesh(mesh);
 }
 
-/*void ChunkRenderer::CleanupChunkRenderData(Core::VoxelMesh& mesh) {
+void ChunkRenderer::CleanupChunkRenderData(Core::VoxelMesh& mesh) {
 	if (!mesh.gpuLoaded) return;
-
-	// Delete everything including the new Indirect Buffer
-	glDeleteBuffers(1, &mesh.vboVertices);
-	glDeleteBuffers(1, &mesh.vboNormals);
-	glDeleteBuffers(1, &mesh.indirectBuffer);
-
-	// If you kept ssboIndices for specific reasons:
-	if (mesh.ssboIndices) glDeleteBuffers(1, &mesh.ssboIndices);
-
-	glDeleteVertexArrays(1, &mesh.vao);
-
-	// Reset handles
-	mesh.vboVertices = 0;
-	mesh.vboNormals = 0;
-	mesh.indirectBuffer = 0;
-	mesh.vao = 0;
-
-	mesh.gpuLoaded = false;
-}*/
-
+	Core::ReleaseVoxelMesh(mesh);
+}
@@ -1,4 +1,5 @@
 #include "Renderer.h"
+#include "Core/ProfilerPanel.h"
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
 	Camera* cam = static_cast<Camera*>(glfwGetWindowUserPointer(window));
@@ -62,6 +63,8 @@ Renderer::Renderer() {
 	_modelMLocation = glGetUniformLocation(_shaderProgram, "uModel");
 	_viewLoc = glGetUniformLocation(_shaderProgram, "uView");
 	_normalMatrixLocation = glGetUniformLocation(_shaderProgram, "normalMatrix");
+	_chunkOriginLocation = glGetUniformLocation(_shaderProgram, "uChunkOrigin");
+	_chunkExtentLocation = glGetUniformLocation(_shaderProgram, "uChunkExtent");
 
 
 	glUniform1f(_widthLocation, _screenWidth);
@@ -166,16 +169,19 @@ void Renderer::DrawChunks(ChunkManager& chunkManager) {
 		Core::VoxelMesh* mesh = chunkMap[coord];
 		if (!mesh->gpuLoaded) continue;
 
-		// If your vertices are NOT in world space yet, update model matrix:
-		// glm::mat4 chunkModel = glm::translate(glm::mat4(1.0f), glm::vec3(coord * 32));
-		// glUniformMatrix4fv(_modelMLocation, 1, GL_FALSE, glm::value_ptr(chunkModel));
+		// Packed positions are relative to the chunk
+		glUniform3fv(_chunkOriginLocation, 1, glm::value_ptr(mesh->origin));
+		glUniform3fv(_chunkExtentLocation, 1, glm::value_ptr(mesh->extent));
 
 		glBindVertexArray(mesh->vao);
 
 		// Mandatory for Indirect: Bind the buffer to the INDIRECT_BUFFER target
-		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, mesh->indirectBuffer);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, mesh->indirectRange.buffer);
 
-		glDrawArraysIndirect(GL_TRIANGLES, (void*)0);
+		if (mesh->indexed)
+			glDrawElementsIndirect(GL_TRIANGLES, mesh->indexType, mesh->indirectRange.Pointer());
+		else
+			glDrawArraysIndirect(GL_TRIANGLES, mesh->indirectRange.Pointer());
 	}
 	glBindVertexArray(0);
 }
@@ -190,6 +196,7 @@ void Renderer::ResetToStartValues() {
 	_width = 32;
 	_height = 32;
 	_depth = 32;
+	_lodDistance = 2;
 }
 
 void Renderer::Render(ChunkManager& chunkManager) {
@@ -214,7 +221,6 @@ void Renderer::Render(ChunkManager& chunkManager) {
 
 
 	DrawChunks(chunkManager);
-	/*
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
@@ -230,11 +236,13 @@ void Renderer::Render(ChunkManager& chunkManager) {
 	ImGui::SliderInt("Octaves", &_octave, 0, 6);
 	ImGui::SliderFloat("Persistance", &_persistance, 0.1f, 4.0f);
 	ImGui::SliderFloat("Lacunarity", &_lacunarity, 0.1f, 4.0f);
-	ImGui::SliderInt("ViewDistance", &_viewDistance, 0, 5);
+	ImGui::SliderInt("ViewDistance", &_viewDistance, 0, 32);
+	// Chunks pick their level of detail when they are scheduled, so like the mesh settings it applies on regenerate
+	ImGui::SliderInt("LodDistance", &_lodDistance, 1, 8);
 
 	if (ImGui::Button("Regenerate Mesh")) {
 		chunkManager.DestroyChunks();
-		chunkManager.UpdateSettings(_scale, _amplitude, _frequency, _octave, _lacunarity, _persistance, _width, _height, _depth, _viewDistance);
+		chunkManager.UpdateSettings(_scale, _amplitude, _frequency, _octave, _lacunarity, _persistance, _width, _height, _depth, _viewDistance, _lodDistance);
 	}
 	if (ImGui::Button("Reset Settings")) {
 		ResetToStartValues();
@@ -242,20 +250,21 @@ void Renderer::Render(ChunkManager& chunkManager) {
 	ImGui::Text("WASD to move  |  Space to ascend and ctrl to descend");
 
 	ImGui::End();
+	Core::ShowProfilerPanel();
 
 	ImGui::Render();
-	*/
 	int display_w, display_h;
 	glfwGetFramebufferSize(_window, &display_w, &display_h);
 
 
-	//ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+	ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
 
 	glfwSwapBuffers(_window);
 }
 
 void Renderer::Cleanup(ChunkManager& chunkManager) {
 	//chunkManager.DestroyChunks();
+	Core::DestroyBufferArenas();
 	glDeleteProgram(_shaderProgram);
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();
@@ -2,9 +2,13 @@
 
 #include <unordered_map>
 #include <unordered_set>
+#include <memory>
+#include <string>
 #include <glm.hpp>
 
 #include "Core/Core.h"
+#include "Core/ChunkJobs.h"
+#include "Core/ChunkStreamer.h"
 
 using ChunkCoord = glm::vec2;
 
@@ -20,13 +24,11 @@ namespace std {
 class ChunkManager {
 public:
 
-	ChunkManager() {}
+	ChunkManager();
 
 	void DestroyChunks();
 
-	void Update(const glm::vec3& position);
-
-	void GenerateChunk(const glm::vec3& position);
+	void Update(const glm::vec3& position, const glm::mat4& viewProjection);
 
 	glm::vec2 GetChunkCoordFromPosition(const glm::vec3& position) const {
 		float xScale = 1.0f / _width;
@@ -49,19 +51,24 @@ public:
 		_height = height;
 		_depth = depth;
 		_viewDistance = viewDistance;
-
+		_regions.Open(RegionDirectory());
+		_streamer.Configure(StreamSettings());
 	}
 
 	std::unordered_map<ChunkCoord, Core::PlaneMesh>& GetChunkMap() {
 		return _chunkMap;
 	}
-	std::unordered_map<ChunkCoord, Core::BlockIds>& GetBlockIDs() {
+	std::unordered_map<ChunkCoord, Core::PalettedBlockIds>& GetBlockIDs() {
 		return _blockIDs;
 	}
+	bool UsesTiledUVs() const {
+		return _greedyMeshing;
+	}
 
 private:
 	std::unordered_map<ChunkCoord, Core::PlaneMesh> _chunkMap;
-	std::unordered_map<ChunkCoord, Core::BlockIds> _blockIDs;
+	//Palette packed, decode a chunk with Decode before meshing it again
+	std::unordered_map<ChunkCoord, Core::PalettedBlockIds> _blockIDs;
 
 	float _scale = 0.1f;
 	float _amplitude = 1.0f;
@@ -73,7 +80,17 @@ private:
 	int _height = 256;
 	int _depth = 16;
 	int _viewDistance = 16;
-
+	//Merges block faces into larger quads, the UVs then need the atlas tiling in shader.vert/shader.frag
+	bool _greedyMeshing = true;
+	//Chunks are saved as they are generated, so revisited areas and later runs load them instead of generating them again
+	Core::RegionStore _regions;
+	//Declared last so the worker threads stop before the chunk maps and settings they use are destroyed
+	Core::ChunkStreamer _streamer;
+
+	Core::ChunkStreamCallbacks StreamCallbacks();
+	Core::ChunkStreamSettings StreamSettings() const;
+	//One directory per set of generation settings, saved chunks only match the settings they were made with
+	std::string RegionDirectory() const;
 	void DeleteChunk(Core::PlaneMesh& mesh);
 
 };
\ No newline at end of file
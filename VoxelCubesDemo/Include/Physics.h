@@ -6,10 +6,10 @@ class Physics {
 public:
 	Physics() {};
 	Physics(ChunkManager& chunkManager) {
-		_chunkManager = chunkManager;
+		_chunkManager = &chunkManager;
 	}
 
 
 private:
-	ChunkManager _chunkManager;
+	ChunkManager* _chunkManager = nullptr; //owned by App, the manager is not copyable since it owns the chunk worker threads
 };
\ No newline at end of file
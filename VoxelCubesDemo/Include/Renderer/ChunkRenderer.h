@@ -29,14 +29,9 @@ public:
 	}
 private:
 	std::unordered_set<glm::vec2> _activeChunkSet;
-	std::unordered_set<glm::vec2> _previousFrameActiveChunkSet;
 	
 	int _width;
 	int _height;
 	int _depth;
 	int _viewDistance;
-
-	void SetupChunkRenderData(Core::PlaneMesh& mesh);
-
-	void CleanupChunkRenderData(Core::PlaneMesh& mesh);
 };
\ No newline at end of file
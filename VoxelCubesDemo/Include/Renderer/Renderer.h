@@ -47,6 +47,10 @@ public:
         return _player.GetCameraPosition();
     }
 
+    glm::mat4 GetViewProjection() const {
+        return _perspectiveMat * _view;
+    }
+
     void PlayerInit(Player player) { _player = player; }
     
 private:
@@ -86,6 +90,9 @@ private:
     GLint _viewLoc;
     GLint _normalMatrixLocation;
     GLint _textureUniformLoc;
+    GLint _tiledUVsLoc;
+    GLint _atlasSizeLoc;
+    GLint _chunkOriginLoc;
     GLuint textureID;
 
     void Init();
@@ -3,11 +3,14 @@
 in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoord;
+flat in vec2 Tile;
 
 uniform float Width;
 uniform float Height;
 uniform float Time;
 uniform sampler2D uTexture;
+uniform bool uTiledUVs;
+uniform vec2 uAtlasSize;
 
 out vec4 FragColor;
 
@@ -17,5 +20,7 @@ void main()
     vec3 norm = normalize(Normal);
     vec3 normalColor = abs(norm);
 
-    FragColor = texture(uTexture, TexCoord);
+    // Greedy quads repeat the block's tile across the quad, the others span it once
+    vec2 uv = (Tile + (uTiledUVs ? fract(TexCoord) : TexCoord)) / uAtlasSize;
+    FragColor = texture(uTexture, uv);
 }
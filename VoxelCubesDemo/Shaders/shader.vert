@@ -1,23 +1,35 @@
 #version 430 core
 
-layout(location = 0) in vec3 aPos;
-layout(location = 1) in vec3 aNormal;
-layout(location = 2) in vec2 aTexCoord;
+// Core::PackedVoxelVertex: the corner relative to the chunk origin, 10 bits per axis, then
+// the face, the atlas tile and the corner on the quad in blocks
+layout(location = 0) in uvec2 aPacked;
 
 uniform mat4 projM;
 uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat3 normalMatrix;
+uniform vec3 uChunkOrigin;
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoord;
+flat out vec2 Tile;
 
+const vec3 faceNormals[6] = vec3[6](
+    vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+    vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0),
+    vec3(0.0, 0.0, 1.0), vec3(0.0, 0.0, -1.0)
+);
 
 void main()
 {
+    vec3 aPos = uChunkOrigin + vec3(bitfieldExtract(aPacked.x, 0, 10), bitfieldExtract(aPacked.x, 10, 10), bitfieldExtract(aPacked.x, 20, 10));
+    vec3 aNormal = faceNormals[bitfieldExtract(aPacked.y, 0, 3)];
+
     FragPos = vec3(uModel*vec4(aPos, 1.0f));
     Normal = normalMatrix*aNormal;
     gl_Position =  projM * uView * uModel * vec4(aPos, 1.0);
-    TexCoord = aTexCoord;
-}
\ No newline at end of file
+    // The tile stays flat and only the position on the quad is interpolated
+    Tile = vec2(bitfieldExtract(aPacked.y, 3, 4), bitfieldExtract(aPacked.y, 7, 5));
+    TexCoord = vec2(bitfieldExtract(aPacked.y, 12, 10), bitfieldExtract(aPacked.y, 22, 10));
+}
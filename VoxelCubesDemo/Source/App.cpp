@@ -36,7 +36,7 @@ void App::Run() {
 	// Main render loop
 	while (!glfwWindowShouldClose(_renderer.GetWindow())) {
 		glm::vec3 pos = _renderer.GetCameraPosition();
-		_chunkManager.Update(pos);
+		_chunkManager.Update(pos, _renderer.GetViewProjection());
 
 		_renderer.Render(_chunkManager);
 		std::this_thread::sleep_for(std::chrono::milliseconds(1));
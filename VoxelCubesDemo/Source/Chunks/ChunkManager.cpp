@@ -1,34 +1,62 @@
 #include "ChunkManager.h"
 
-void ChunkManager::Update(const glm::vec3& position) {
-	GenerateChunk(position);
+ChunkManager::ChunkManager() : _streamer(StreamCallbacks()) {
+	_regions.Open(RegionDirectory());
+	_streamer.Configure(StreamSettings());
 }
 
-void ChunkManager::GenerateChunk(const glm::vec3& position) {
-	
-	glm::vec2 playerChunk = GetChunkCoordFromPosition(position);
-	
-	for (int x = -_viewDistance; x <= _viewDistance; x++) {
-			for (int z = -_viewDistance; z <= _viewDistance; z++) {
-				if (glm::abs(x * z) > _viewDistance * _viewDistance / 1.5f) continue;
-				glm::vec2 coord = playerChunk + glm::vec2(x, z);
-				//std::cout << coord.x << " " << coord.y << " " << coord.z << "\n";
-				// Generate if not yet stored
-				if (_chunkMap.find(coord) == _chunkMap.end() ) {
-					glm::vec2 offset = coord * glm::vec2(_width, _depth);
-					//Try generating the mesh with and without GPU to see the difference in speed! The function call is the same but the end of
-					//the function call is GPU for the gpu implementtion. Please do keep in mind the noise map is still using compute shaders
-					//even on the cpu implementation, so that is technically a speedup that should not be granted as a possitive for the CPU part
-					//of this code. 
-					Core::VoxelData voxelData = std::move(Core::CreateVoxelCubes3DMesh(_width, _height, _depth, offset, false, _amplitude, _frequency, _persistance, _lacunarity, _octave, true));
-					_chunkMap[coord] = voxelData.meshData;
-					_blockIDs[coord] = voxelData.blockIDs;
-				}
-			}
-	}
+void ChunkManager::Update(const glm::vec3& position, const glm::mat4& viewProjection) {
+	_streamer.Update(position, viewProjection);
+}
+
+Core::ChunkStreamCallbacks ChunkManager::StreamCallbacks() {
+	// Chunks are full height columns, the streamer coordinate (x, 0, z) is chunk (x, z)
+	Core::ChunkStreamCallbacks callbacks;
+	callbacks.schedule = [this](Core::JobSystem& jobs, glm::ivec3 coord) -> void* {
+		// Density, painting and meshing run as dependent jobs, or one job copies a saved chunk out of its region file
+		Core::VoxelCubesChunkJob* chunk = new Core::VoxelCubesChunkJob;
+		chunk->coord = glm::ivec2(coord.x, coord.z);
+		Core::ScheduleVoxelCubesChunk(jobs, *chunk, _width, _height, _depth, _frequency, _greedyMeshing, &_regions);
+		return chunk;
+	};
+	callbacks.ready = [this](glm::ivec3 coord, void* data) {
+		std::unique_ptr<Core::VoxelCubesChunkJob> chunk(static_cast<Core::VoxelCubesChunkJob*>(data));
+		ChunkCoord chunkCoord = glm::vec2(chunk->coord);
+		// Uploaded once into the mapped mesh arena as 8 byte vertices relative to the chunk offset it was meshed at, the chunk stays resident
+		// until it unloads and keeps no CPU copy of its mesh
+		Core::PlaneMesh& mesh = _chunkMap[chunkCoord];
+		mesh = std::move(chunk->mesh);
+		glm::vec3 origin = glm::vec3(chunk->coord.x * _width, 0, chunk->coord.y * _depth);
+		Core::UploadPackedVoxelCubesMesh(mesh, origin, UsesTiledUVs(), glm::vec2(3.0f, 16.0f), false);
+		_blockIDs[chunkCoord] = std::move(chunk->packedIDs);
+	};
+	callbacks.discard = [](glm::ivec3 coord, void* data) {
+		delete static_cast<Core::VoxelCubesChunkJob*>(data);
+	};
+	callbacks.unload = [this](glm::ivec3 coord) {
+		ChunkCoord chunkCoord = glm::vec2(coord.x, coord.z);
+		_chunkMap.erase(chunkCoord);
+		_blockIDs.erase(chunkCoord);
+	};
+	return callbacks;
+}
+
+Core::ChunkStreamSettings ChunkManager::StreamSettings() const {
+	Core::ChunkStreamSettings settings;
+	settings.chunkSize = glm::vec3(_width, _height, _depth);
+	settings.flat = true;
+	settings.viewRadius = _viewDistance;
+	return settings;
+}
+
+std::string ChunkManager::RegionDirectory() const {
+	return "Regions/VoxelCubes_" + std::to_string(_width) + "x" + std::to_string(_height) + "x" + std::to_string(_depth)
+		+ "_f" + std::to_string(_frequency) + (_greedyMeshing ? "_greedy" : "");
 }
 
 void ChunkManager::DestroyChunks() {
+	// Chunks still in flight were generated with the old settings, they are dropped and every loaded chunk is unloaded
+	_streamer.Reset();
 	for (auto& [coord, mesh] : _chunkMap) {
 		DeleteChunk(mesh);
 	}
@@ -36,7 +64,5 @@ void ChunkManager::DestroyChunks() {
 }
 
 void ChunkManager::DeleteChunk(Core::PlaneMesh& mesh) {
-	mesh.vertices.clear();
-	mesh.normals.clear();
-	mesh.indices.clear();
+	Core::ReleasePlaneMesh(mesh);
 }
\ No newline at end of file
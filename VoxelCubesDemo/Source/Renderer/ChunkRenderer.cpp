@@ -1,8 +1,8 @@
 #include "ChunkRenderer.h"
 
 void ChunkRenderer::UpdateActiveChunk(const glm::vec3& position, ChunkManager& chunkManager) {
+	// Chunks are uploaded when they become ready and released when the streamer unloads them, this only picks the ones to draw
 	glm::vec2 playerChunk = chunkManager.GetChunkCoordFromPosition(position);	
-	_previousFrameActiveChunkSet = _activeChunkSet;
 	_activeChunkSet.clear();
 	auto& chunkMap = chunkManager.GetChunkMap();
 	for (int x = -_viewDistance; x <= _viewDistance; x++) {
@@ -11,69 +11,11 @@ void ChunkRenderer::UpdateActiveChunk(const glm::vec3& position, ChunkManager& c
 				glm::vec2 coord = playerChunk + glm::vec2(x, z);
 				//std::cout << coord.x << " " << coord.y << " " << coord.z << "\n";
 				
-				if (chunkMap.find(coord) != chunkMap.end()) {
+				auto it = chunkMap.find(coord);
+				if (it != chunkMap.end() && it->second.gpuLoaded) {
 					_activeChunkSet.insert(coord);
-					// Generate if not yet stored
-					if (!chunkMap[coord].gpuLoaded) {
-						SetupChunkRenderData(chunkMap[coord]);
-					}
 				}
 			}
 		}	
-	for (const glm::vec2& coord : _previousFrameActiveChunkSet) {
-		if (_activeChunkSet.find(coord) == _activeChunkSet.end() && chunkMap[coord].gpuLoaded) {
-			CleanupChunkRenderData(chunkMap[coord]);
-		}
-	}
-}
-
-void ChunkRenderer::SetupChunkRenderData(Core::PlaneMesh& mesh) {
-	
-	glGenVertexArrays(1, &mesh.vao);
-	glBindVertexArray(mesh.vao);
-
-	glGenBuffers(1, &mesh.vboVertices);
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vboVertices);
-	glBufferData(GL_ARRAY_BUFFER, mesh.vertices.size() * sizeof(glm::fvec3), mesh.vertices.data(), GL_STATIC_DRAW);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr); // location 0
-	glEnableVertexAttribArray(0);
-
-	glGenBuffers(1, &mesh.vboNormals);
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vboNormals);
-	glBufferData(GL_ARRAY_BUFFER, mesh.normals.size() * sizeof(glm::fvec3), mesh.normals.data(), GL_STATIC_DRAW);
-	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 0, nullptr); // location 1
-	glEnableVertexAttribArray(1);
-
-	glGenBuffers(1, &mesh.vboUVs);
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vboUVs);
-	glBufferData(GL_ARRAY_BUFFER, mesh.UVs.size() * sizeof(glm::vec2), mesh.UVs.data(), GL_STATIC_DRAW);
-	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
-	glEnableVertexAttribArray(2);
-
-	glGenBuffers(1, &mesh.ebo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ebo);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, mesh.indices.size() * sizeof(int), mesh.indices.data(), GL_STATIC_DRAW);
-
-	glBindVertexArray(0);
-
-	mesh.gpuLoaded = true;
-}
-
-void ChunkRenderer::CleanupChunkRenderData(Core::PlaneMesh& mesh) {
-	// Delete the EBO, VBOs, and VAO
-	glDeleteBuffers(1, &mesh.ebo);
-	glDeleteBuffers(1, &mesh.vboNormals);
-	glDeleteBuffers(1, &mesh.vboVertices);
-	glDeleteBuffers(1, &mesh.vboUVs);
-	glDeleteVertexArrays(1, &mesh.vao);
-
-	// Optional: Reset IDs to 0 (OpenGL default for "none")
-	mesh.ebo = 0;
-	mesh.vboNormals = 0;
-	mesh.vboVertices = 0;
-	mesh.vboUVs = 0;
-	mesh.vao = 0;
-
-	mesh.gpuLoaded = false;
 }
 
@@ -1,4 +1,5 @@
 #include "Renderer.h"
+#include "Core/ProfilerPanel.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
 
@@ -69,6 +70,9 @@ Renderer::Renderer() {
 	_viewLoc = glGetUniformLocation(_shaderProgram, "uView");
 	_normalMatrixLocation = glGetUniformLocation(_shaderProgram, "normalMatrix");
 	_textureUniformLoc = glGetUniformLocation(_shaderProgram, "uTexture");
+	_tiledUVsLoc = glGetUniformLocation(_shaderProgram, "uTiledUVs");
+	_atlasSizeLoc = glGetUniformLocation(_shaderProgram, "uAtlasSize");
+	_chunkOriginLoc = glGetUniformLocation(_shaderProgram, "uChunkOrigin");
 
 
 	glUniform1f(_widthLocation, _screenWidth);
@@ -77,7 +81,8 @@ Renderer::Renderer() {
 	glUniformMatrix4fv(_modelMLocation, 1, GL_FALSE, glm::value_ptr(_model));
 	glUniformMatrix4fv(_viewLoc, 1, GL_FALSE, glm::value_ptr(_view));
 	glUniformMatrix3fv(_normalMatrixLocation, 1, GL_FALSE, glm::value_ptr(_normalMatrix));
-	
+	//Columns and rows of TerrainLibSpriteMap.png, the same values Core meshes with
+	glUniform2f(_atlasSizeLoc, 3.0f, 16.0f);
 
 
 	// Main loop
@@ -216,8 +221,10 @@ void Renderer::DrawChunks(ChunkManager& chunkManager) {
 		glActiveTexture(GL_TEXTURE0);                     // activate texture unit 0
 		glBindTexture(GL_TEXTURE_2D, textureID);          // bind our texture
 		glUniform1i(_textureUniformLoc, 0);                // tell shader "uTexture" uses GL_TEXTURE0
+		glUniform1i(_tiledUVsLoc, chunkManager.UsesTiledUVs());
+		glUniform3fv(_chunkOriginLoc, 1, glm::value_ptr(planeData.origin));
 		glBindVertexArray(planeData.vao);
-		glDrawElements(GL_TRIANGLES, planeData.indices.size(), GL_UNSIGNED_INT, 0);
+		glDrawElements(GL_TRIANGLES, planeData.indexCount, GL_UNSIGNED_INT, planeData.indexRange.Pointer());
 		glBindVertexArray(0);
 	}
 }
@@ -247,7 +254,6 @@ void Renderer::Render(ChunkManager& chunkManager) {
 	//std::cout << "FPS: " << fps << std::endl << std::flush;
 	glUniform1f(_timeLocation, timeValue);
 	glm::vec3 camPos = _player.GetCameraPosition();
-	/*
 	ImGui_ImplOpenGL3_NewFrame();
 	ImGui_ImplGlfw_NewFrame();
 	ImGui::NewFrame();
@@ -273,9 +279,9 @@ void Renderer::Render(ChunkManager& chunkManager) {
 
 	ImGui::Text("WASD to move  |  Space to ascend and ctrl to descend");
 	ImGui::End();
+	Core::ShowProfilerPanel();
 
 	ImGui::Render();
-	*/
 	int display_w, display_h;
 	glfwGetFramebufferSize(_window, &display_w, &display_h);
 	glViewport(0, 0, display_w, display_h);
@@ -291,6 +297,7 @@ void Renderer::Render(ChunkManager& chunkManager) {
 
 void Renderer::Cleanup(ChunkManager& chunkManager) {
 	chunkManager.DestroyChunks();
+	Core::DestroyBufferArenas();
 	glDeleteProgram(_shaderProgram);
 	ImGui_ImplOpenGL3_Shutdown();
 	ImGui_ImplGlfw_Shutdown();